@@ -1,9 +1,11 @@
 #include <src/SymbolSeeker.h>
 
+import <algorithm>;
+import <atomic>;
 import <iterator>;
 
-#include <QtCore/QCoreApplication>   // for qApp->processEvents()
-#include <QtCore/QDirIterator>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
 #include <QtCore/QDebug>
 
 import symseek;
@@ -11,106 +13,215 @@ import symseek;
 using namespace SymSeek;
 using namespace SymSeek::QtUI;
 
-static QStringList findFilesByMasks(QString const & directoryPath, QStringList const & masks)
+static std::vector<String> toStrings(QStringList const & strings)
 {
-    QStringList result;
-    QDirIterator iter(directoryPath, QDir::Dirs | QDir::NoDotAndDotDot |
-                      QDir::Readable, QDirIterator::Subdirectories);
-    while (iter.hasNext())
+    std::vector<String> result;
+    result.reserve(size_t(strings.size()));
+    for (auto const & string: strings)
     {
-        iter.next();
-        result += findFilesByMasks(iter.filePath(), masks);
-    }
-
-    auto files = QDir(directoryPath).entryList(masks, QDir::Files | QDir::Readable | QDir::NoSymLinks);
-    for (auto const & fileEntry: files)
-    {
-        result.append(QDir(directoryPath).filePath(fileEntry));
+        result.push_back(toString(string));
     }
     return result;
 }
 
-QVector<SymbolsInBinary> SymbolSeeker::findSymbols(
+static SymbolsInBinary toSymbolsInBinary(String const & binary, std::vector<Symbol> symbols)
+{
+    return { toQString(binary),
+        Symbols(std::make_move_iterator(symbols.begin()), std::make_move_iterator(symbols.end())) };
+}
+
+void SymbolSeeker::setIndexDirectory(QString const & directory)
+{
+    m_indexDirectory = directory;
+}
+
+void SymbolSeeker::setDemangleCache(std::shared_ptr<DemangleCache> cache)
+{
+    m_demangleCache = std::move(cache);
+}
+
+void SymbolSeeker::setRawNameFilter(RawNameFilter filter)
+{
+    m_rawNameFilter = std::move(filter);
+}
+
+void SymbolSeeker::setDeferDemangling(bool defer)
+{
+    m_deferDemangling = defer;
+}
+
+void SymbolSeeker::findSymbols(
     QString const &directoryPath, QStringList const &masks, SymbolHandler handler)
 {
-    auto binaries = findFilesByMasks(directoryPath, masks);
+    String const directory = toString(directoryPath);
+    // The masks were taken by QDir, which ignores the case of the names
+    CrawlOptions const options{ .globs = toStrings(masks), .caseSensitive = false };
 
-    QVector<SymbolsInBinary> result;
-    auto itemsCount = size_t(binaries.size());
-    result.reserve(int(itemsCount));
-    Q_EMIT startProcessingItems(itemsCount);
+    if (m_indexDirectory.isEmpty())
+    {
+        // The binaries are parsed while the rest of the tree is still being walked
+        scanBinaries([this, &directory, &options](FileHandler const & submit)
+            {
+                crawl(directory, options, submit, m_stopSource.get_token());
+            },
+            std::move(handler));
+        return;
+    }
 
-#ifdef Q_OS_WIN
-    static IDemangler::UPtr const demanglers[] = 
+    // The index needs the whole set to tell the vanished binaries
+    std::vector<String> binaries;
+    crawl(directory, options,
+        [&binaries](String binary)
+        {
+            binaries.push_back(std::move(binary));
+            return true;
+        },
+        m_stopSource.get_token());
+    // A partial set would make the refresh drop the binaries not reached yet
+    if (m_stopSource.stop_requested())
     {
-        createDemangler(Mangler::MSVC),
-        createDemangler(Mangler::GCC)
-    };
-#else
-#   error Not implemented
-#endif
+        Q_EMIT interrupted();
+        return;
+    }
+    std::sort(binaries.begin(), binaries.end());
+
+    queryIndex(directoryPath, masks, binaries, std::move(handler));
+}
 
-    // Could be run in parallel
-    for (auto const & binary: binaries)
+void SymbolSeeker::queryIndex(
+    QString const & directoryPath, QStringList const & masks, std::vector<String> const & binaries,
+    SymbolHandler handler)
+{
+    // One index per directory and set of globs
+    QByteArray const key = QCryptographicHash::hash(
+        (QDir::cleanPath(directoryPath) + '\n' + masks.join('\n')).toUtf8(), QCryptographicHash::Sha1);
+    QString const indexPath = QDir(m_indexDirectory).filePath(QString::fromLatin1(key.toHex()) + ".symidx");
+
+    SymbolIndex index;
+    index.open(toString(indexPath));
+    IndexOptions const indexOptions{ .scan = { .demangleCache = m_demangleCache } };
+    if (!index.isFresh(binaries, indexOptions))
     {
-        qApp->processEvents();
-        if (m_interruptFlag)
+        // It's unknown upfront how many files changed, the progress bar just shows the activity
+        Q_EMIT startProcessingItems(0);
+        bool const refreshed = index.refresh(binaries, indexOptions,
+            [this](String const & binary, ScanStatus status)
+            {
+                switch (status)
+                {
+                    case ScanStatus::Start:
+                        Q_EMIT itemStatus(toQString(binary), ProgressStatus::Start);
+                        break;
+                    case ScanStatus::Finish:
+                        Q_EMIT itemStatus(toQString(binary), ProgressStatus::Finish);
+                        break;
+                    case ScanStatus::Reject:
+                        Q_EMIT itemStatus(toQString(binary), ProgressStatus::Reject);
+                        break;
+                }
+            },
+            m_stopSource.get_token());
+
+        if (m_stopSource.stop_requested())
         {
-            m_interruptFlag = false;
             Q_EMIT interrupted();
-            return result;
+            return;
         }
-
-        Q_EMIT itemStatus(binary, ProgressStatus::Start);
-
-        if (ISymbolReader::UPtr reader = createReader(toString(binary)))
+        if (!refreshed)
         {
-            Symbols symbols;
-            symbols.reserve(int(reader->symbolsCount()));
-            // Payload
-            for (auto && rawSymbol: reader->readSymbols())
-            {
-                std::optional<std::string> demangledName;
-                for (auto const & demangler: demanglers)
+            qWarning() << "Cannot write the index" << indexPath << ", scanning the files directly";
+            scanBinaries([&binaries](FileHandler const & submit)
                 {
-                    if (auto nameOpt = demangler->demangleName(rawSymbol.name.c_str()); nameOpt)
+                    for (auto const & binary: binaries)
                     {
-                        demangledName = nameOpt;
-                        break;
+                        if (!submit(binary))
+                        {
+                            break;
+                        }
                     }
-                }
+                },
+                std::move(handler));
+            return;
+        }
+    }
 
-                Symbol symbol = demangledName.has_value() ? 
-                                createSymbol(std::move(rawSymbol), demangledName.value()) :
-                                Symbol{.raw = std::move(rawSymbol)};
+    index.query(handler,
+        [this](String const & binary, std::vector<Symbol> symbols)
+        {
+            if (!symbols.empty())
+            {
+                Q_EMIT symbolsFound(toSymbolsInBinary(binary, std::move(symbols)));
+            }
+        },
+        m_stopSource.get_token());
 
-                SymbolHandlerAction action = handler(symbol);
-                if (action == SymbolHandlerAction::Skip)
-                {
-                    continue;
-                }
-                else if (action == SymbolHandlerAction::Stop)
-                {
-                    break;
-                }
-                Q_ASSERT(action == SymbolHandlerAction::Add);
-                symbols.append(std::move(symbol));
+    if (m_stopSource.stop_requested())
+    {
+        Q_EMIT interrupted();
+    }
+}
+
+void SymbolSeeker::scanBinaries(std::function<void(FileHandler const &)> const & feed, SymbolHandler handler)
+{
+    // The count is unknown until all the binaries are fed, the progress bar just shows the activity till then
+    Q_EMIT startProcessingItems(0);
+    size_t submittedCount = 0;
+    std::atomic<size_t> processedCount = 0;
+    std::atomic<bool> allSubmitted = false;
+
+    // The handlers are serialized by the scanner
+    Scanner scanner{
+        ScanOptions{ .ordered = true, .rawNameFilter = m_rawNameFilter, .deferDemangling = m_deferDemangling,
+            .demangleCache = m_demangleCache },
+        std::move(handler),
+        [this](String const & binary, std::vector<Symbol> symbols)
+        {
+            if (!symbols.empty())
+            {
+                Q_EMIT symbolsFound(toSymbolsInBinary(binary, std::move(symbols)));
             }
-            result.append({ binary, std::move(symbols) });
-            Q_EMIT itemStatus(binary, ProgressStatus::Finish);
-        }
-        else
+        },
+        [this, &submittedCount, &processedCount, &allSubmitted](String const & binary, ScanStatus status)
         {
-            Q_EMIT itemStatus(binary, ProgressStatus::Reject);
-        }
+            switch (status)
+            {
+                case ScanStatus::Start:
+                    Q_EMIT itemStatus(toQString(binary), ProgressStatus::Start);
+                    return;
+                case ScanStatus::Finish:
+                    Q_EMIT itemStatus(toQString(binary), ProgressStatus::Finish);
+                    break;
+                case ScanStatus::Reject:
+                    Q_EMIT itemStatus(toQString(binary), ProgressStatus::Reject);
+                    break;
+            }
+            size_t const processed = ++processedCount;
+            if (allSubmitted)
+            {
+                Q_EMIT itemsRemaining(submittedCount - processed);
+            }
+        },
+        m_stopSource.get_token()
+    };
 
-        Q_EMIT itemsRemaining(--itemsCount);
+    feed([this, &scanner, &submittedCount](String binary)
+    {
+        scanner.submit(std::move(binary));
+        ++submittedCount;
+        return !m_stopSource.stop_requested();
+    });
+    allSubmitted = true;
+    Q_EMIT startProcessingItems(submittedCount);
+    Q_EMIT itemsRemaining(submittedCount - processedCount);
+    scanner.wait();
+
+    if (scanner.isCancelled())
+    {
+        Q_EMIT interrupted();
     }
-
-    return result;
 }
 
 void SymbolSeeker::interrupt()
 {
-    m_interruptFlag = true;
+    m_stopSource.request_stop();
 }
@@ -2,23 +2,23 @@
 
 #include <QtCore/QObject>
 
+import <functional>;
+import <memory>;
+import <stop_token>;
+import <string_view>;
+
+import symseek.crawler;
+import symseek.demanglecache;
+import symseek.scanner;
 import symseek.symbol;
 
 namespace SymSeek::QtUI
 {
-    enum class SymbolHandlerAction: uint8_t
-    {
-        // Add the symbol to the result
-        Add,
-
-        // Skip the symbol,
-        Skip,
-
-        // Stop processing the binary
-        Stop
-    };
+    using SymSeek::SymbolHandlerAction;
 
-    using SymbolHandler = std::function<SymbolHandlerAction(SymSeek::Symbol const &)>;
+    // Invoked from the scanner worker threads
+    using SymSeek::SymbolHandler;
+    using SymSeek::RawNameFilter;
 
     using Symbols = QVector<SymSeek::Symbol>;
 
@@ -33,6 +33,11 @@ namespace SymSeek::QtUI
         return QString::fromStdString(string);
     }
 
+    inline QString toQString(std::string_view string)
+    {
+        return QString::fromUtf8(string.data(), qsizetype(string.size()));
+    }
+
     inline QString toQString(std::wstring const & string)
     {
         return QString::fromStdWString(string);
@@ -63,10 +68,24 @@ namespace SymSeek::QtUI
         };
         Q_ENUM(ProgressStatus);
 
+        // Empty directory disables the index
+        void setIndexDirectory(QString const & directory);
+
+        // Shared by the searches, so the names demangled once are reused by the next ones. None by default.
+        void setDemangleCache(std::shared_ptr<DemangleCache> cache);
+
+        // Applied to the raw names when the binaries are scanned, before anything is demangled
+        void setRawNameFilter(RawNameFilter filter);
+
+        // The binaries scanned directly yield raw symbols, the index ones are demangled already
+        void setDeferDemangling(bool defer);
+
     public Q_SLOTS:
-        QVector<SymbolsInBinary> findSymbols(
+        // The hits are delivered by symbolsFound as soon as each binary is done
+        void findSymbols(
             QString const & directoryPath, QStringList const & masks, SymbolHandler handler = {});
 
+        // Thread-safe, can be invoked directly while the search is running
         void interrupt();
 
     Q_SIGNALS:
@@ -75,7 +94,23 @@ namespace SymSeek::QtUI
         void itemsRemaining(size_t);
         void interrupted();
 
+        // Emitted from the scanner threads, only for the binaries having any hits
+        void symbolsFound(SymSeek::QtUI::SymbolsInBinary symbols);
+
     private:
-        bool m_interruptFlag = false;
+        // The feed submits the binaries, the first ones are scanned while it is still looking for the rest
+        void scanBinaries(std::function<void(FileHandler const &)> const & feed, SymbolHandler handler);
+        void queryIndex(
+            QString const & directoryPath, QStringList const & masks, std::vector<String> const & binaries,
+            SymbolHandler handler);
+
+    private:
+        std::stop_source m_stopSource;
+        QString m_indexDirectory;
+        RawNameFilter m_rawNameFilter;
+        bool m_deferDemangling = false;
+        std::shared_ptr<DemangleCache> m_demangleCache;
     };
 }
+
+Q_DECLARE_METATYPE(SymSeek::QtUI::SymbolsInBinary)
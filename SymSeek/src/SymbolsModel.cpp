@@ -1,19 +1,51 @@
 #include "SymbolsModel.h"
 
+#include <QtCore/QDebug>
 #include <QtCore/QDir>
 
 #include <QtGui/QColor>
 
+import symseek;
+
 using namespace SymSeek::QtUI;
 
+namespace
+{
+    // Frequent enough to look live, rare enough to keep the views from relayouting all the time
+    constexpr int flushIntervalMs = 100;
+
+    char const * languageName(SymSeek::Mangler mangler)
+    {
+        using SymSeek::Mangler;
+        switch (mangler)
+        {
+            case Mangler::MSVC:
+            case Mangler::GCC:
+                return "C++";
+            case Mangler::Rust:
+                return "Rust";
+            case Mangler::Swift:
+                return "Swift";
+            case Mangler::D:
+                return "D";
+            case Mangler::None:
+                break;
+        }
+        return "C";
+    }
+}
+
 SymbolsModel::SymbolsModel(QObject *parent)
 : QAbstractTableModel(parent)
 {
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(flushIntervalMs);
+    connect(&m_flushTimer, &QTimer::timeout, this, &SymbolsModel::flush);
 }
 
 int SymbolsModel::rowCount(QModelIndex const & parent) const
 {
-    return m_binariesToSymbols.size();
+    return parent.isValid() ? 0 : m_rowsCount;
 }
 
 int SymbolsModel::columnCount(QModelIndex const & parent) const
@@ -26,24 +58,24 @@ QVariant SymbolsModel::data(QModelIndex const & index, int role) const
     int const row = index.row();
     int const col = index.column();
 
-    Q_ASSERT(row < m_binariesToSymbols.size());
+    Q_ASSERT(row < m_rowsCount);
 
     using namespace SymSeek;
 
-    auto const & [binRef, sym] = m_binariesToSymbols[row];
+    PackedSymbol const & sym = m_store[size_t(row)];
 
     switch (col)
     {
         case 0:
             {
+                QString path = toQString(m_store.imagePath(sym));
                 if (role == Qt::ToolTipRole)
                 {
-                    return binRef.toString();
+                    return path;
                 }
                 else if (role == Qt::DisplayRole)
                 {
-                    QString path = binRef.toString();
-                    int index = binRef.lastIndexOf('/');
+                    int index = path.lastIndexOf('/');
                     if(index > -1)
                         return path.right(path.size() - index - 1);
                     return path;
@@ -54,7 +86,7 @@ QVariant SymbolsModel::data(QModelIndex const & index, int role) const
         {
             if (role == Qt::DisplayRole)
             {
-                return sym.raw.implements ? "EXP" : "IMP";  // TODO Replace with fancy icons!
+                return sym.implements() ? "EXP" : "IMP";  // TODO Replace with fancy icons!
             }
         }
             break;
@@ -62,14 +94,15 @@ QVariant SymbolsModel::data(QModelIndex const & index, int role) const
             {
                 if (role == Qt::DisplayRole)
                 {
-                    return sym.demangledName ? "C++" : "C";
+                    // Known from the raw name, no need to demangle
+                    return languageName(sym.mangler());
                 }
             }
             break;
         case 3:
             {
                 if (role == Qt::DecorationRole) {
-                    switch (sym.access)
+                    switch (resolved(row).access())
                     {
                         case Access::Public:
                             return QColor{ "limegreen" };  // TODO Replace with fancy icons!
@@ -81,16 +114,17 @@ QVariant SymbolsModel::data(QModelIndex const & index, int role) const
                 }
                 if (role == Qt::DisplayRole)
                 {
+                    PackedSymbol const & sym = resolved(row);
                     QString text;
-                    if(sym.modifiers & Symbol::IsStatic)
+                    if(sym.modifiers() & Symbol::IsStatic)
                         text += "static ";
-                    if(sym.modifiers & Symbol::IsVirtual)
+                    if(sym.modifiers() & Symbol::IsVirtual)
                         text += "virtual ";
-                    if(sym.modifiers & Symbol::IsConst)
+                    if(sym.modifiers() & Symbol::IsConst)
                         text += "const ";
-                    if(sym.modifiers & Symbol::IsVolatile)
+                    if(sym.modifiers() & Symbol::IsVolatile)
                         text += "volatile ";
-                    switch(sym.type)
+                    switch(sym.type())
                     {
                         case NameType::Function:
                             text += "function";
@@ -109,12 +143,12 @@ QVariant SymbolsModel::data(QModelIndex const & index, int role) const
             {
                 if (role == Qt::DisplayRole)
                 {
-                    return toQString(sym.demangledName ? sym.demangledName.value() : sym.raw.name);
+                    return toQString(m_store.name(resolved(row)));
                 }
 
                 if (role == Qt::ToolTipRole)
                 {
-                    return toQString(sym.raw.name);
+                    return toQString(m_store.rawName(sym));
                 }
             }
             break;
@@ -124,22 +158,75 @@ QVariant SymbolsModel::data(QModelIndex const & index, int role) const
     return {};
 }
 
-void SymbolsModel::setSymbols(QVector<SymbolsInBinary> symbolsInBinaries)
+SymSeek::PackedSymbol const & SymbolsModel::resolved(int row) const
+{
+    PackedSymbol const & packed = m_store[size_t(row)];
+    if (!packed.isDeferred())
+    {
+        return packed;
+    }
+
+    Symbol symbol = m_store.unpack(packed);
+    std::string demangledName;
+    if (demangle(symbol.raw.name, demangledName))
+    {
+        Mangler const mangler = symbol.mangler;
+        symbol = createSymbol(std::move(symbol.raw), std::move(demangledName));
+        symbol.mangler = mangler;
+    }
+    if (!m_store.resolve(size_t(row), symbol))
+    {
+        qWarning() << "Too many symbols demangled, the rest of them are shown raw";
+    }
+    return m_store[size_t(row)];
+}
+
+void SymbolsModel::clear()
+{
+    m_flushTimer.stop();
+
+    beginResetModel();
+    m_store.clear();
+    m_rowsCount = 0;
+    endResetModel();
+}
+
+void SymbolsModel::appendSymbols(SymbolsInBinary symbols)
 {
-    Q_EMIT beginResetModel();
-    m_binaries.clear();
-    m_binariesToSymbols.clear();
-    m_binaries.reserve(symbolsInBinaries.size());
-    for (auto const & symsInBin: symbolsInBinaries)
+    if (symbols.symbols.isEmpty())
     {
-        m_binaries.push_back(symsInBin.binaryPath);
-        QStringView binRef{ m_binaries.last() };
-        for(auto const & symbol: symsInBin.symbols)
+        return;
+    }
+
+    m_store.addImage(toString(symbols.binaryPath));
+    for (auto const & symbol: std::as_const(symbols.symbols))
+    {
+        if (!m_store.add(symbol))
         {
-            m_binariesToSymbols.push_back({ binRef, symbol });
+            qWarning() << "Too many symbols found, the rest of them are dropped";
+            break;
         }
     }
-    Q_EMIT endResetModel();
+
+    if (!m_flushTimer.isActive())
+    {
+        m_flushTimer.start();
+    }
+}
+
+void SymbolsModel::flush()
+{
+    m_flushTimer.stop();
+
+    int const storedRows = int(m_store.size());
+    if (storedRows == m_rowsCount)
+    {
+        return;
+    }
+
+    beginInsertRows(QModelIndex{}, m_rowsCount, storedRows - 1);
+    m_rowsCount = storedRows;
+    endInsertRows();
 }
 
 QVariant SymbolsModel::headerData(int section, Qt::Orientation orientation, int role) const
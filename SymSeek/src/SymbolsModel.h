@@ -1,11 +1,13 @@
 #pragma once
 
 #include <QtCore/QAbstractTableModel>
+#include <QtCore/QTimer>
 #include <QtCore/QVector>
-#include <QtCore/QStringList>
 
 #include "SymbolSeeker.h"
 
+import symseek.store;
+
 namespace SymSeek::QtUI
 {
 
@@ -21,17 +23,24 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation,
                         int role = Qt::DisplayRole) const override;
 
-    void setSymbols(QVector<SymbolsInBinary> symbols);
+    void clear();
+
+    // The symbols are packed right away, the rows are inserted in batches
+    // at most once per flush interval
+    void appendSymbols(SymbolsInBinary symbols);
+    // Inserts the pending rows right away, e.g. when the search is over
+    void flush();
+
+private:
+    // Demangles the deferred symbol of the row on the first access
+    SymSeek::PackedSymbol const & resolved(int row) const;
 
 private:
-    // Preventing extra memory consumption
-    struct BinaryToSymbol
-    {
-        QStringView binaryRef{};
-        SymSeek::Symbol symbol;
-    };
-    QVector<BinaryToSymbol> m_binariesToSymbols;
-    QStringList m_binaries;
+    // Rows past m_rowsCount are packed but not inserted yet.
+    // Mutable as the rows are demangled when they are shown.
+    mutable SymSeek::SymbolStore m_store;
+    int m_rowsCount{};
+    QTimer m_flushTimer;
 };
 
 }
@@ -1,8 +1,9 @@
 #include "Workspace.h"
 
+#include <QtCore/QDebug>
 #include <QtCore/QDir>
-#include <QtCore/QEventLoop>
 #include <QtCore/QSettings>
+#include <QtCore/QStandardPaths>
 #include <QtCore/QTimer>
 #include <QtGui/QValidator>
 
@@ -13,10 +14,68 @@
 
 #include "Debug.h"
 
+import <memory>;
+import <mutex>;
+
 import symseek;
 
 using namespace SymSeek::QtUI;
 
+namespace
+{
+    // One for all the tabs and their searches, kept on disk whether the index is used or not
+    class PersistentDemangleCache
+    {
+    public:
+        static PersistentDemangleCache & instance()
+        {
+            static PersistentDemangleCache cache;
+            return cache;
+        }
+
+        std::shared_ptr<SymSeek::DemangleCache> const & cache() const { return m_cache; }
+
+        // Once per process, by the first search, so the GUI thread never waits for it
+        void load()
+        {
+            std::call_once(m_loaded, [this]
+                {
+                    m_cache->load(toString(path()));
+                    std::lock_guard lock{ m_saveMutex };
+                    m_savedInsertions = m_cache->stats().insertions;
+                });
+        }
+
+        // Only when the searches demangled anything new, the repeated ones rarely do
+        void save()
+        {
+            std::lock_guard lock{ m_saveMutex };
+            uint64_t const insertions = m_cache->stats().insertions;
+            if (insertions == m_savedInsertions)
+            {
+                return;
+            }
+            if (!m_cache->save(toString(path())))
+            {
+                qWarning() << "Cannot write the demangled names cache" << path();
+                return;
+            }
+            m_savedInsertions = insertions;
+        }
+
+    private:
+        static QString path()
+        {
+            return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("demangled.symdmc");
+        }
+
+        std::shared_ptr<SymSeek::DemangleCache> const m_cache = std::make_shared<SymSeek::DemangleCache>();
+        std::once_flag m_loaded;
+        std::mutex m_saveMutex;
+        uint64_t m_savedInsertions{};
+    };
+}
+
 class CallbackValidator: public QValidator
 {
 public:
@@ -45,12 +104,16 @@ AsyncSeeker::AsyncSeeker(
 , m_masks    { masks     }
 , m_handler  { handler   }
 {
+    m_seeker.setDemangleCache(PersistentDemangleCache::instance().cache());
     m_seeker.moveToThread(this);
 }
 
 void AsyncSeeker::run()
 {
-    m_result = m_seeker.findSymbols(m_directory, m_masks, m_handler);
+    PersistentDemangleCache & demangleCache = PersistentDemangleCache::instance();
+    demangleCache.load();
+    m_seeker.findSymbols(m_directory, m_masks, m_handler);
+    demangleCache.save();
 }
 
 SymbolSeeker const * AsyncSeeker::seeker() const
@@ -63,11 +126,6 @@ SymbolSeeker * AsyncSeeker::seeker()
     return &m_seeker;
 }
 
-QVector<SymbolsInBinary> AsyncSeeker::result() const
-{
-    return m_result;
-}
-
 Workspace::Workspace(QWidget *parent)
 : QWidget(parent)
 , m_ui(std::make_unique<QT_PREPEND_NAMESPACE(Ui::Workspace)>())
@@ -158,6 +216,7 @@ void Workspace::doSearch()
     auto const globs = m_ui->leGlobs->text();
     auto const symbolName = m_ui->leSymbolName->text();
     auto const isRegex = m_ui->chbRegex->isChecked();
+    auto const isLazy = m_ui->chbLazyDemangling->isChecked();
 
     using namespace SymSeek;
 
@@ -170,26 +229,51 @@ void Workspace::doSearch()
     );
 
     QRegularExpression symbolRx{ symbolName };
-    
-    AsyncSeeker asyncSeeker { 
-        directory, masks, 
-        [symbolName, isRegex, &symbolRx](Symbol const & symbol) 
+    // Compiled up front, the handler is invoked from several threads at once
+    symbolRx.optimize();
+
+    // The names are UTF-8, so are the bytes of the query
+    SubstringMatcher const matcher{ { symbolName.toStdString() } };
+
+    m_asyncSeeker = std::make_unique<AsyncSeeker>(
+        directory, masks,
+        [isRegex, isLazy, symbolRx, matcher, matchesAll = symbolName.isEmpty()](Symbol const & symbol)
         {
-            QString demangledName = toQString(
-                symbol.demangledName ? symbol.demangledName.value() : symbol.raw.name);
+            if (matchesAll)
+            {
+                // The deferred names are demangled by the model, only the shown ones
+                return SymbolHandlerAction::Add;
+            }
+
+            std::string_view name = symbol.demangledName ? symbol.demangledName.value() : symbol.raw.name;
+            thread_local std::string demangledName;
+            if (isLazy && !symbol.demangledName && symbol.mangler != Mangler::None && demangle(name, demangledName))
+            {
+                name = demangledName;
+            }
 
-            return (isRegex ? symbolRx.match(demangledName).isValid() : 
-                    demangledName.contains(symbolName))
+            return (isRegex ? symbolRx.match(toQString(name)).hasMatch() : matcher(name))
                    ? SymbolHandlerAction::Add
                    : SymbolHandlerAction::Skip;
-        } 
-    };
+        });
 
-    auto seeker = asyncSeeker.seeker();
+    auto seeker = m_asyncSeeker->seeker();
+    if (!isRegex)
+    {
+        // Most of the symbols are rejected before being demangled
+        seeker->setRawNameFilter(RawNamePrefilter{ symbolName.toStdString() });
+    }
+    seeker->setDeferDemangling(isLazy);
+    if (m_ui->chbIndex->isChecked())
+    {
+        seeker->setIndexDirectory(
+            QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("indexes"));
+    }
 
     // Stupid Qt boilerplate!
     qRegisterMetaType<size_t>("size_t");
     qRegisterMetaType<SymbolSeeker::ProgressStatus>("SymSeek::SymbolSeeker::ProgressStatus");
+    qRegisterMetaType<SymbolsInBinary>("SymSeek::QtUI::SymbolsInBinary");
 
     connect(seeker, &SymbolSeeker::startProcessingItems, m_ui->pbProgress, &QProgressBar::setMaximum);
     connect(seeker, &SymbolSeeker::itemsRemaining, /*context=*/this,
@@ -214,46 +298,75 @@ void Workspace::doSearch()
             };
             m_ui->statusBar->showMessage(statusText);
         });
-    bool interrupted = false;
+    m_interrupted = false;
     connect(seeker, &SymbolSeeker::interrupted, /*context=*/this,
-            [&interrupted]()
+            [this]()
             {
-                interrupted = true;
+                m_interrupted = true;
             });
+    // Queued, the model takes over the symbols of each binary without copying them
+    connect(seeker, &SymbolSeeker::symbolsFound, &m_model, &SymbolsModel::appendSymbols);
+    connect(m_asyncSeeker.get(), &AsyncSeeker::finished, this, &Workspace::searchFinished);
+
+    m_model.clear();
 
     auto searchBtn = m_ui->pbSearch;
-    QString buttonText = searchBtn->text();
+    m_searchButtonText = searchBtn->text();
     searchBtn->setText("Stop");
     disconnect(searchBtn, &QPushButton::clicked, this, &Workspace::doSearch);
-    connect(searchBtn, &QPushButton::clicked, seeker, &SymbolSeeker::interrupt);
+    connect(searchBtn, &QPushButton::clicked, this, &Workspace::stopSearch);
 
-    QEventLoop loop;
-    connect(&asyncSeeker, &AsyncSeeker::finished, &loop, &QEventLoop::quit);
-    asyncSeeker.start();
+    m_ui->pbProgress->setValue(0);
     m_ui->pbProgress->show();
-    loop.exec();
+    m_asyncSeeker->start();
+}
+
+void Workspace::stopSearch()
+{
+    if (m_asyncSeeker)
+    {
+        // The seeker's thread is busy with the search, so its event loop cannot deliver the call
+        m_asyncSeeker->seeker()->interrupt();
+    }
+}
+
+void Workspace::searchFinished()
+{
+    // The finished signal is emitted just before the thread exits
+    m_asyncSeeker->wait();
+    m_asyncSeeker.reset();
+    // All the symbolsFound events were posted before this one, so nothing is left behind
+    m_model.flush();
 
     QString finishedMessage = "Finished";
-    if(interrupted) finishedMessage = "Interrupted";
+    if(m_interrupted) finishedMessage = "Interrupted";
     m_ui->statusBar->showMessage(finishedMessage, 3000);
-    m_model.setSymbols(asyncSeeker.result());
 
+    auto searchBtn = m_ui->pbSearch;
+    disconnect(searchBtn, &QPushButton::clicked, this, &Workspace::stopSearch);
     connect(searchBtn, &QPushButton::clicked, this, &Workspace::doSearch);
-    searchBtn->setText(buttonText);
+    searchBtn->setText(m_searchButtonText);
     m_ui->pbProgress->hide();
 }
 
 Workspace::~Workspace()
 {
+    if (m_asyncSeeker)
+    {
+        m_asyncSeeker->seeker()->interrupt();
+        m_asyncSeeker->wait();
+    }
 }
 
 namespace
 {
     // Names for settings
     QString const guiGroupPrefix    = QStringLiteral("gui/tab");
-    QString const directorySetting  = QStringLiteral("directory");
-    QString const globsSetting      = QStringLiteral("globs");
-    QString const symbolNameSetting = QStringLiteral("symbolName");
+    QString const directorySetting      = QStringLiteral("directory");
+    QString const globsSetting          = QStringLiteral("globs");
+    QString const symbolNameSetting     = QStringLiteral("symbolName");
+    QString const useIndexSetting       = QStringLiteral("useIndex");
+    QString const lazyDemanglingSetting = QStringLiteral("lazyDemangling");
 }
 
 void Workspace::loadSettings(uint index)
@@ -273,6 +386,8 @@ void Workspace::loadSettings(uint index)
             }
     ).toString());
     m_ui->leSymbolName->setText(settings.value(symbolNameSetting).toString());
+    m_ui->chbIndex->setChecked(settings.value(useIndexSetting, true).toBool());
+    m_ui->chbLazyDemangling->setChecked(settings.value(lazyDemanglingSetting, false).toBool());
 }
 
 void Workspace::storeSettings(uint index) const
@@ -283,4 +398,6 @@ void Workspace::storeSettings(uint index) const
     settings.setValue(directorySetting, m_ui->leDirectory->text());
     settings.setValue(globsSetting, m_ui->leGlobs->text());
     settings.setValue(symbolNameSetting, m_ui->leSymbolName->text());
+    settings.setValue(useIndexSetting, m_ui->chbIndex->isChecked());
+    settings.setValue(lazyDemanglingSetting, m_ui->chbLazyDemangling->isChecked());
 }
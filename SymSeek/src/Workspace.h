@@ -32,14 +32,11 @@ namespace SymSeek::QtUI
         SymbolSeeker const * seeker() const;
         SymbolSeeker * seeker();
 
-        QVector<SymbolsInBinary> result() const;
-
     protected:
         void run() override;
 
     private:
         SymbolSeeker m_seeker;
-        QVector<SymbolsInBinary> m_result;
         QString m_directory;
         QStringList m_masks;
         SymbolHandler m_handler;
@@ -62,6 +59,8 @@ namespace SymSeek::QtUI
 
     private:
         void doSearch();
+        void stopSearch();
+        void searchFinished();
 
     private:
         std::unique_ptr<Ui::Workspace> m_ui;
@@ -70,5 +69,10 @@ namespace SymSeek::QtUI
 
         QPointer<QValidator> m_directoryValidator;
         QPointer<QValidator> m_regexValidator;
+
+        // Alive while a search is running
+        std::unique_ptr<AsyncSeeker> m_asyncSeeker;
+        bool m_interrupted = false;
+        QString m_searchButtonText;
     };
 }
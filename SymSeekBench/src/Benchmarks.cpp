@@ -0,0 +1,615 @@
+#include <benchmark/benchmark.h>
+
+#include "CorpusGenerator.h"
+#include "RegexClassifier.h"
+
+import <algorithm>;
+import <charconv>;
+import <cstdio>;
+import <filesystem>;
+import <fstream>;
+import <map>;
+import <memory>;
+import <span>;
+import <string>;
+import <string_view>;
+import <thread>;
+import <utility>;
+import <vector>;
+
+import symseek;
+import symseek.internal.helpers;
+import symseek.internal.imageformat;
+import symseek.internal.interfaces.mappedfile;
+
+using namespace SymSeek;
+using namespace SymSeek::Bench;
+
+namespace
+{
+    constexpr ImageFormat Formats[] = { ImageFormat::ELF, ImageFormat::COFF, ImageFormat::PE, ImageFormat::Archive };
+
+    // Written once before any benchmark runs, the stages get their inputs from here
+    struct Corpus
+    {
+        CorpusSpec spec;
+        std::filesystem::path directory;
+        bool temporary = true;
+
+        std::vector<String> files;  // spec.filesPerFormat of each format, in the order of Formats
+        size_t bytesCount{};
+
+        // Of a large build, e.g. Qt or Chromium, with as many sections as a linker may emit.
+        // The tables are in the last section, which the RVA lookups find last too.
+        String largeDLL;
+
+        std::vector<std::string> itaniumNames;
+        std::vector<std::string> msvcNames;
+        // The mangled ones of both, with their demangled names
+        std::vector<std::pair<std::string, std::string>> demangledNames;
+
+        std::span<String const> filesOf(ImageFormat format) const
+        {
+            return std::span{ files }.subspan(static_cast<size_t>(format) * spec.filesPerFormat, spec.filesPerFormat);
+        }
+    };
+
+    Corpus g_corpus;
+
+    // The images found in --real_corpus, grouped by their formats
+    std::filesystem::path g_realCorpusDirectory;
+    std::map<detail::ImageFormat, std::vector<String>> g_realCorpus;
+
+    std::string_view formatName(detail::ImageFormat format)
+    {
+        switch (format)
+        {
+            case detail::ImageFormat::Archive:
+                return "archive";
+            case detail::ImageFormat::PE:
+                return "pe";
+            case detail::ImageFormat::COFF:
+                return "coff";
+            case detail::ImageFormat::ShortImport:
+                return "import";
+            case detail::ImageFormat::ELF:
+                return "elf";
+            case detail::ImageFormat::MachO:
+                return "macho";
+            case detail::ImageFormat::Universal:
+                return "universal";
+            case detail::ImageFormat::Unknown:
+                break;
+        }
+        return "unknown";
+    }
+
+    // The members of the archives are read one by one, as the scanner does by default
+    size_t readSymbols(ISymbolReader const & reader)
+    {
+        if (size_t const membersCount = reader.membersCount())
+        {
+            size_t count = 0;
+            for (size_t i = 0; i < membersCount; ++i)
+            {
+                if (ISymbolReader::UPtr const member = reader.memberReader(i))
+                {
+                    count += readSymbols(*member);
+                }
+            }
+            return count;
+        }
+
+        size_t count = 0;
+        for (RawSymbolRef const & symbol: reader.readSymbolRefs())
+        {
+            benchmark::DoNotOptimize(symbol.name.data());
+            ++count;
+        }
+        return count;
+    }
+
+    void BM_MapImage(benchmark::State & state, ImageFormat format)
+    {
+        std::span<String const> const files = g_corpus.filesOf(format);
+        size_t bytesCount = 0;
+        for (auto _: state)
+        {
+            bytesCount = 0;
+            for (String const & path: files)
+            {
+                std::unique_ptr<detail::IMappedFile> const file = detail::createMappedFile(path);
+                uint8_t const * bytes = file ? file->map(0, 0, detail::MapMode::Populate) : nullptr;
+                if (!bytes)
+                {
+                    state.SkipWithError("Cannot map the image");
+                    break;
+                }
+
+                // A byte of every page, the way the readers fault them in
+                uint8_t sum = 0;
+                for (size_t offset = 0; offset < file->size(); offset += 4096)
+                {
+                    sum += bytes[offset];
+                }
+                benchmark::DoNotOptimize(sum);
+                bytesCount += file->size();
+            }
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytesCount));
+    }
+
+    void BM_ReadSymbols(benchmark::State & state, std::span<String const> files)
+    {
+        size_t bytesCount = 0;
+        size_t symbolsCount = 0;
+        for (auto _: state)
+        {
+            bytesCount = 0;
+            symbolsCount = 0;
+            for (String const & path: files)
+            {
+                ISymbolReader::UPtr const reader = createReader(path);
+                if (!reader)
+                {
+                    state.SkipWithError("Cannot read the image");
+                    break;
+                }
+                symbolsCount += readSymbols(*reader);
+                bytesCount += std::filesystem::file_size(path);
+            }
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytesCount));
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * symbolsCount));
+    }
+
+    enum class Reservation: uint8_t
+    {
+        Estimate,  // The export count plus one, which the PE reader reported before counting its imports
+        Exact      // symbolsCount()
+    };
+
+    // The symbols kept the way the scanner does, counting how many times their vector grows
+    void BM_ReserveSymbols(benchmark::State & state, std::span<String const> files, Reservation reservation)
+    {
+        std::vector<ISymbolReader::UPtr> readers;
+        std::vector<size_t> reserved;
+        for (String const & path: files)
+        {
+            ISymbolReader::UPtr reader = createReader(path);
+            if (!reader)
+            {
+                state.SkipWithError("Cannot read the image");
+                return;
+            }
+
+            size_t exportsCount = 0;
+            for (RawSymbolRef const & symbol: reader->readSymbolRefs())
+            {
+                exportsCount += symbol.implements;
+            }
+            reserved.push_back(reservation == Reservation::Exact ? reader->symbolsCount() : exportsCount + 1);
+            readers.push_back(std::move(reader));
+        }
+
+        size_t reallocationsCount = 0;
+        size_t symbolsCount = 0;
+        for (auto _: state)
+        {
+            reallocationsCount = 0;
+            symbolsCount = 0;
+            for (size_t i = 0; i < readers.size(); ++i)
+            {
+                std::vector<Symbol> symbols;
+                symbols.reserve(reserved[i]);
+                for (RawSymbolRef const & symbol: readers[i]->readSymbolRefs())
+                {
+                    size_t const capacity = symbols.capacity();
+                    symbols.push_back(Symbol{ .raw = symbol.materialize() });
+                    reallocationsCount += symbols.capacity() != capacity;
+                }
+                symbolsCount += symbols.size();
+                benchmark::DoNotOptimize(symbols.data());
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * symbolsCount));
+        state.counters["reallocations"] = static_cast<double>(reallocationsCount);
+    }
+
+    // The plain C names are offered as well, the demanglers reject them
+    void BM_Demangle(benchmark::State & state, Mangler mangler)
+    {
+        IDemangler::UPtr const demangler = createDemangler(mangler);
+        std::vector<std::string> const & names = mangler == Mangler::GCC ? g_corpus.itaniumNames : g_corpus.msvcNames;
+        std::string output;
+        for (auto _: state)
+        {
+            for (std::string const & name: names)
+            {
+                demangler->demangleInto(name, output);
+                benchmark::DoNotOptimize(output.data());
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * names.size()));
+    }
+
+    // Both schemes mixed, in the batches of the scanner
+    void BM_DemangleBatch(benchmark::State & state)
+    {
+        constexpr size_t BatchSize = 256;
+
+        std::vector<std::string_view> names{ g_corpus.itaniumNames.begin(), g_corpus.itaniumNames.end() };
+        names.insert(names.end(), g_corpus.msvcNames.begin(), g_corpus.msvcNames.end());
+        std::vector<std::string> outputs(BatchSize);
+        DemangleDispatcher const dispatcher;
+        for (auto _: state)
+        {
+            for (size_t begin = 0; begin < names.size(); begin += BatchSize)
+            {
+                size_t const size = std::min(BatchSize, names.size() - begin);
+                dispatcher.demangleBatch(std::span{ names }.subspan(begin, size), std::span{ outputs }.first(size));
+                benchmark::DoNotOptimize(outputs.data());
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * names.size()));
+    }
+
+    // Against the std::regex classifier it replaced, kept by the tests
+    template<auto CreateSymbol>
+    void BM_CreateSymbol(benchmark::State & state)
+    {
+        for (auto _: state)
+        {
+            for (auto const & [rawName, demangledName]: g_corpus.demangledNames)
+            {
+                Symbol const symbol = CreateSymbol(RawSymbol{ .name = rawName }, demangledName);
+                benchmark::DoNotOptimize(symbol.modifiers);
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * g_corpus.demangledNames.size()));
+    }
+
+    // Fragments of the demangled names spread over the whole set, so some of them do match
+    std::vector<std::string> makePatterns(size_t count)
+    {
+        constexpr size_t PatternLength = 8;
+
+        std::vector<std::string> patterns;
+        auto const & names = g_corpus.demangledNames;
+        for (size_t i = 0; i < count && !names.empty(); ++i)
+        {
+            std::string const & name = names[i * names.size() / count].second;
+            size_t const middle = name.size() > PatternLength ? (name.size() - PatternLength) / 2 : 0;
+            patterns.push_back(name.substr(middle, PatternLength));
+        }
+        return patterns;
+    }
+
+    void BM_SubstringMatcher(benchmark::State & state)
+    {
+        SubstringMatcher const matcher{ makePatterns(static_cast<size_t>(state.range(0))) };
+        size_t matchesCount = 0;
+        for (auto _: state)
+        {
+            matchesCount = 0;
+            for (auto const & [rawName, demangledName]: g_corpus.demangledNames)
+            {
+                matchesCount += matcher(demangledName);
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * g_corpus.demangledNames.size()));
+        state.counters["matches"] = static_cast<double>(matchesCount);
+    }
+
+    void BM_RawNamePrefilter(benchmark::State & state)
+    {
+        std::vector<std::string> const patterns = makePatterns(1);
+        RawNamePrefilter const prefilter{ patterns.empty() ? std::string_view{} : patterns.front() };
+        size_t passedCount = 0;
+        for (auto _: state)
+        {
+            passedCount = 0;
+            for (auto const & [rawName, demangledName]: g_corpus.demangledNames)
+            {
+                passedCount += prefilter(rawName);
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * g_corpus.demangledNames.size()));
+        state.counters["passed"] = static_cast<double>(passedCount);
+    }
+
+    // What the UI model does with every result, see SymbolsModel::appendSymbols()
+    void BM_StoreSymbols(benchmark::State & state)
+    {
+        std::vector<Symbol> symbols;
+        for (auto const & [rawName, demangledName]: g_corpus.demangledNames)
+        {
+            symbols.push_back(createSymbol(RawSymbol{ .name = rawName }, demangledName));
+        }
+
+        for (auto _: state)
+        {
+            SymbolStore store;
+            store.addImage(String{});
+            for (Symbol const & symbol: symbols)
+            {
+                store.add(symbol);
+            }
+            benchmark::DoNotOptimize(store.size());
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * symbols.size()));
+    }
+
+    // The whole corpus, from mapping to the results; the symbols are demangled unless deferred
+    void BM_Scan(benchmark::State & state, bool deferDemangling)
+    {
+        size_t symbolsCount = 0;
+        for (auto _: state)
+        {
+            symbolsCount = 0;
+            Scanner scanner{
+                ScanOptions{ .workersCount = static_cast<size_t>(state.range(0)), .deferDemangling = deferDemangling },
+                [](Symbol const &) { return SymbolHandlerAction::Add; },
+                [&symbolsCount](String const &, std::vector<Symbol> symbols) { symbolsCount += symbols.size(); }
+            };
+            for (String const & path: g_corpus.files)
+            {
+                scanner.submit(path);
+            }
+            scanner.wait();
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * g_corpus.bytesCount));
+        state.counters["files"] = benchmark::Counter(static_cast<double>(g_corpus.files.size()),
+            benchmark::Counter::kIsIterationInvariantRate);
+        state.counters["symbols"] = benchmark::Counter(static_cast<double>(symbolsCount),
+            benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+    void scanArguments(benchmark::internal::Benchmark * benchmark)
+    {
+        size_t const hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t workers = 1; workers < hardwareThreads; workers *= 2)
+        {
+            benchmark->Arg(static_cast<int64_t>(workers));
+        }
+        benchmark->Arg(static_cast<int64_t>(hardwareThreads));
+    }
+
+    void registerBenchmarks()
+    {
+        for (ImageFormat const format: Formats)
+        {
+            std::string const suffix{ toString(format) };
+            benchmark::RegisterBenchmark(("BM_MapImage/" + suffix).c_str(), BM_MapImage, format);
+            benchmark::RegisterBenchmark(("BM_ReadSymbols/" + suffix).c_str(), BM_ReadSymbols,
+                g_corpus.filesOf(format));
+        }
+        // Real DLLs, LIBs and so on, the synthetic ones don't have their layouts and their quirks
+        for (auto const & [format, files]: g_realCorpus)
+        {
+            std::string const suffix{ formatName(format) };
+            benchmark::RegisterBenchmark(("BM_ReadSymbols/real/" + suffix).c_str(), BM_ReadSymbols,
+                std::span<String const>{ files });
+        }
+        benchmark::RegisterBenchmark("BM_ReadSymbols/pe_large", BM_ReadSymbols, std::span{ &g_corpus.largeDLL, 1 });
+        benchmark::RegisterBenchmark("BM_ReserveSymbols/pe/estimate", BM_ReserveSymbols,
+            g_corpus.filesOf(ImageFormat::PE), Reservation::Estimate);
+        benchmark::RegisterBenchmark("BM_ReserveSymbols/pe/exact", BM_ReserveSymbols,
+            g_corpus.filesOf(ImageFormat::PE), Reservation::Exact);
+        if (auto const realPE = g_realCorpus.find(detail::ImageFormat::PE); realPE != g_realCorpus.end())
+        {
+            benchmark::RegisterBenchmark("BM_ReserveSymbols/real/pe/estimate", BM_ReserveSymbols,
+                std::span<String const>{ realPE->second }, Reservation::Estimate);
+            benchmark::RegisterBenchmark("BM_ReserveSymbols/real/pe/exact", BM_ReserveSymbols,
+                std::span<String const>{ realPE->second }, Reservation::Exact);
+        }
+        benchmark::RegisterBenchmark("BM_Demangle/itanium", BM_Demangle, Mangler::GCC);
+        benchmark::RegisterBenchmark("BM_Demangle/msvc", BM_Demangle, Mangler::MSVC);
+        benchmark::RegisterBenchmark("BM_DemangleBatch", BM_DemangleBatch);
+        benchmark::RegisterBenchmark("BM_CreateSymbol", BM_CreateSymbol<createSymbol>);
+        benchmark::RegisterBenchmark("BM_CreateSymbol/regex", BM_CreateSymbol<Tests::createSymbolByRegex>);
+        benchmark::RegisterBenchmark("BM_SubstringMatcher", BM_SubstringMatcher)->Arg(1)->Arg(8)->Arg(64);
+        benchmark::RegisterBenchmark("BM_RawNamePrefilter", BM_RawNamePrefilter);
+        benchmark::RegisterBenchmark("BM_StoreSymbols", BM_StoreSymbols);
+        // Wall time, the work is done by the scanner threads
+        benchmark::RegisterBenchmark("BM_Scan", BM_Scan, false)->Apply(scanArguments)->UseRealTime();
+        benchmark::RegisterBenchmark("BM_Scan/deferred", BM_Scan, true)->Apply(scanArguments)->UseRealTime();
+    }
+
+    template<typename T>
+    bool parseNumber(std::string_view text, T & value)
+    {
+        auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc{} && end == text.data() + text.size();
+    }
+
+    // The flags left over by benchmark::Initialize()
+    bool parseCorpusOptions(int argc, char ** argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view const argument = argv[i];
+            size_t const equals = argument.find('=');
+            std::string_view const name = argument.substr(0, equals);
+            std::string_view const value = equals == std::string_view::npos ? std::string_view{} :
+                argument.substr(equals + 1);
+
+            ImageSpec & image = g_corpus.spec.image;
+            bool parsed = false;
+            if (name == "--real_corpus" && !value.empty())
+            {
+                g_realCorpusDirectory = std::filesystem::path{ value };
+                parsed = true;
+            }
+            else if (name == "--corpus_dir" && !value.empty())
+            {
+                g_corpus.directory = std::filesystem::path{ value };
+                g_corpus.temporary = false;
+                parsed = true;
+            }
+            else if (name == "--corpus_files")
+            {
+                parsed = parseNumber(value, g_corpus.spec.filesPerFormat) && g_corpus.spec.filesPerFormat;
+            }
+            else if (name == "--corpus_symbols")
+            {
+                parsed = parseNumber(value, image.symbolsCount);
+            }
+            else if (name == "--corpus_name_length")
+            {
+                parsed = parseNumber(value, image.nameLength);
+            }
+            else if (name == "--corpus_mangled")
+            {
+                parsed = parseNumber(value, image.mangledPercent) && image.mangledPercent <= 100;
+            }
+            else if (name == "--corpus_imports")
+            {
+                parsed = parseNumber(value, image.importsPercent) && image.importsPercent <= 100;
+            }
+            else if (name == "--corpus_members")
+            {
+                parsed = parseNumber(value, image.membersCount);
+            }
+            else if (name == "--corpus_sections")
+            {
+                parsed = parseNumber(value, image.sectionsCount) && image.sectionsCount;
+            }
+            else if (name == "--corpus_seed")
+            {
+                parsed = parseNumber(value, image.seed);
+            }
+
+            if (!parsed)
+            {
+                std::fprintf(stderr, "Unknown or malformed option %s\n", argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Every file the readers accept, the others are left out so they don't fail the benchmarks
+    bool collectRealCorpus()
+    {
+        std::error_code error;
+        std::filesystem::recursive_directory_iterator entries{ g_realCorpusDirectory,
+            std::filesystem::directory_options::skip_permission_denied, error };
+        if (error)
+        {
+            return false;
+        }
+
+        size_t filesCount = 0;
+        for (auto const & entry: entries)
+        {
+            if (!entry.is_regular_file(error))
+            {
+                continue;
+            }
+            String const path = entry.path().string<String::value_type>();
+            detail::ImageFormat const format = detail::openImage(path).format;
+            if (format != detail::ImageFormat::Unknown && createReader(path))
+            {
+                g_realCorpus[format].push_back(path);
+                ++filesCount;
+            }
+        }
+
+        benchmark::AddCustomContext("real_corpus", g_realCorpusDirectory.string());
+        benchmark::AddCustomContext("real_corpus_files", std::to_string(filesCount));
+        return true;
+    }
+
+    bool prepareCorpus()
+    {
+        if (g_corpus.directory.empty())
+        {
+            g_corpus.directory = std::filesystem::temp_directory_path() /
+                ("symseek-bench-" + std::to_string(g_corpus.spec.image.seed));
+        }
+
+        std::vector<std::filesystem::path> const files = writeCorpus(g_corpus.directory, g_corpus.spec);
+        if (files.empty())
+        {
+            return false;
+        }
+        for (std::filesystem::path const & file: files)
+        {
+            g_corpus.files.push_back(file.string<String::value_type>());
+            g_corpus.bytesCount += std::filesystem::file_size(file);
+        }
+
+        // 60k exports, the rest are imports
+        ImageSpec const largeDLL{ .symbolsCount = 75'000, .nameLength = g_corpus.spec.image.nameLength,
+            .mangledPercent = g_corpus.spec.image.mangledPercent, .importsPercent = 20, .sectionsCount = 64,
+            .seed = g_corpus.spec.image.seed };
+        std::filesystem::path const largeDLLPath = g_corpus.directory / "pe_large.dll";
+        std::vector<uint8_t> const largeDLLBytes = generateImage(ImageFormat::PE, largeDLL);
+        std::ofstream output{ largeDLLPath, std::ios::binary | std::ios::trunc };
+        output.write(reinterpret_cast<char const *>(largeDLLBytes.data()),
+            static_cast<std::streamsize>(largeDLLBytes.size()));
+        if (!output.flush())
+        {
+            return false;
+        }
+        g_corpus.largeDLL = largeDLLPath.string<String::value_type>();
+
+        g_corpus.itaniumNames = generateNames(NameStyle::Itanium, g_corpus.spec.image);
+        g_corpus.msvcNames = generateNames(NameStyle::MSVC, g_corpus.spec.image);
+        std::string demangledName;
+        for (auto const * names: { &g_corpus.itaniumNames, &g_corpus.msvcNames })
+        {
+            for (std::string const & name: *names)
+            {
+                if (demangle(name, demangledName))
+                {
+                    g_corpus.demangledNames.emplace_back(name, demangledName);
+                }
+            }
+        }
+
+        benchmark::AddCustomContext("corpus", g_corpus.directory.string());
+        benchmark::AddCustomContext("corpus_files", std::to_string(g_corpus.files.size()));
+        benchmark::AddCustomContext("corpus_bytes", std::to_string(g_corpus.bytesCount));
+        benchmark::AddCustomContext("corpus_symbols_per_image", std::to_string(g_corpus.spec.image.symbolsCount));
+        benchmark::AddCustomContext("corpus_name_length", std::to_string(g_corpus.spec.image.nameLength));
+        return true;
+    }
+}
+
+// Besides the --benchmark_* flags, the corpus is shaped by
+// --corpus_dir=<kept there>, --corpus_files=<per format>, --corpus_symbols=<per image>,
+// --corpus_name_length=<average>, --corpus_mangled=<%>, --corpus_imports=<%>,
+// --corpus_members=<per archive>, --corpus_sections=<per DLL> and --corpus_seed=<n>.
+// --real_corpus=<directory> reads the images found there as well, e.g. a Windows SDK drop.
+int main(int argc, char ** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (!parseCorpusOptions(argc, argv))
+    {
+        return 1;
+    }
+    if (!g_realCorpusDirectory.empty() && !collectRealCorpus())
+    {
+        std::fprintf(stderr, "Cannot read the directory %s\n", g_realCorpusDirectory.string().c_str());
+        return 1;
+    }
+    if (!prepareCorpus())
+    {
+        std::fprintf(stderr, "Cannot write the corpus to %s\n", g_corpus.directory.string().c_str());
+        return 1;
+    }
+
+    registerBenchmarks();
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    if (g_corpus.temporary)
+    {
+        std::error_code error;
+        std::filesystem::remove_all(g_corpus.directory, error);
+    }
+    return 0;
+}
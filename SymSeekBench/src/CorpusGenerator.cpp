@@ -0,0 +1,823 @@
+#include "CorpusGenerator.h"
+
+import <algorithm>;
+import <fstream>;
+import <span>;
+
+using namespace std::literals;
+using namespace SymSeek;
+using namespace SymSeek::Bench;
+
+namespace
+{
+    // splitmix64, the sequence is fixed by the seed alone
+    class Random
+    {
+    public:
+        explicit Random(uint64_t seed)
+        : m_state{ seed }
+        {
+        }
+
+        uint64_t next()
+        {
+            uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        size_t below(size_t bound)
+        {
+            return bound ? static_cast<size_t>(next() % bound) : 0;
+        }
+
+        bool percent(unsigned chance)
+        {
+            return below(100) < chance;
+        }
+
+        template<typename T, size_t Size>
+        T const & pick(T const (& items)[Size])
+        {
+            return items[below(Size)];
+        }
+
+    private:
+        uint64_t m_state;
+    };
+
+    constexpr std::string_view Nouns[] = {
+        "alloc", "buffer", "cache", "context", "device", "engine", "event", "file", "frame", "handle",
+        "image", "index", "layer", "lock", "manager", "memory", "module", "node", "object", "parser",
+        "queue", "reader", "render", "resource", "scene", "session", "socket", "stream", "string", "symbol",
+        "table", "task", "texture", "thread", "token", "vector", "view", "widget", "window", "writer" };
+
+    constexpr std::string_view Verbs[] = {
+        "get", "set", "create", "destroy", "find", "update", "load", "save",
+        "open", "close", "read", "write", "reset", "flush", "insert", "remove" };
+
+    // Qualifiers of the name, a namespace or a class, until the encoded name reaches its length
+    std::vector<std::string> makeScopes(Random & random, size_t nameLength)
+    {
+        std::vector<std::string> scopes;
+        size_t length = 0;
+        do
+        {
+            std::string scope{ random.pick(Nouns) };
+            if (random.percent(50))
+            {
+                scope += random.pick(Nouns);
+            }
+            length += scope.size() + 2;  // Length prefix or "@" separator
+            scopes.push_back(std::move(scope));
+        }
+        while (length < nameLength);
+        return scopes;
+    }
+
+    // Unique within the set thanks to the index
+    std::string makeIdentifier(Random & random, size_t index)
+    {
+        std::string identifier{ random.pick(Verbs) };
+        std::string_view const noun = random.pick(Nouns);
+        identifier += static_cast<char>(noun[0] - 'a' + 'A');
+        identifier += noun.substr(1);
+        identifier += '_';
+
+        static char const Digits[] = "0123456789abcdef";
+        do
+        {
+            identifier += Digits[index & 0xF];
+            index >>= 4;
+        }
+        while (index);
+        return identifier;
+    }
+
+    void appendItaniumSource(std::string & name, std::string_view identifier)
+    {
+        name += std::to_string(identifier.size());
+        name += identifier;
+    }
+
+    // https://itanium-cxx-abi.github.io/cxx-abi/abi.html#mangling
+    std::string makeItaniumName(Random & random, size_t index, size_t nameLength)
+    {
+        static constexpr std::string_view Parameters[] = { "v", "i", "PKc", "Pv", "m", "b", "d", "ii", "PKcm" };
+
+        std::string const identifier = makeIdentifier(random, index);
+        std::vector<std::string> const scopes = makeScopes(random, nameLength > identifier.size() + 8 ?
+            nameLength - identifier.size() - 8 : 0);
+
+        // Functions mostly, in namespaces or classes alike
+        std::string name = "_ZN";
+        size_t const kind = random.below(8);
+        if (kind == 1)
+        {
+            name += 'K';  // Const method
+        }
+        for (std::string const & scope: scopes)
+        {
+            appendItaniumSource(name, scope);
+        }
+        appendItaniumSource(name, identifier);
+        name += 'E';
+        if (kind != 2)  // Variable otherwise
+        {
+            name += random.pick(Parameters);
+        }
+        return name;
+    }
+
+    // https://en.wikiversity.org/wiki/Visual_C%2B%2B_name_mangling
+    std::string makeMSVCName(Random & random, size_t index, size_t nameLength)
+    {
+        // Free functions, methods of every access and kind, variables
+        static constexpr std::string_view Signatures[] = {
+            "YAXXZ", "YAHH@Z", "YAXPEBD@Z", "YA_NPEAX@Z",
+            "QEAAXXZ", "QEBAHXZ", "UEAAXXZ", "UEBA_NXZ", "SAXXZ",
+            "IEAAXH@Z", "IEBAHXZ", "AEAA_NXZ", "AEAAXPEBD@Z",
+            "3HA", "3_NA" };
+
+        std::string const identifier = makeIdentifier(random, index);
+        std::vector<std::string> const scopes = makeScopes(random, nameLength > identifier.size() + 10 ?
+            nameLength - identifier.size() - 10 : 0);
+
+        std::string name = "?";
+        name += identifier;
+        name += '@';
+        for (auto scope = scopes.rbegin(); scope != scopes.rend(); ++scope)
+        {
+            name += *scope;
+            name += '@';
+        }
+        name += '@';
+        name += random.pick(Signatures);
+        return name;
+    }
+
+    std::string makeCName(Random & random, size_t index, size_t nameLength)
+    {
+        std::string name = "bench";
+        std::string const identifier = makeIdentifier(random, index);
+        while (name.size() + identifier.size() + 1 < nameLength)
+        {
+            name += '_';
+            name += random.pick(Nouns);
+        }
+        name += '_';
+        name += identifier;
+        return name;
+    }
+
+    class ByteWriter
+    {
+    public:
+        size_t size() const { return m_bytes.size(); }
+
+        void u8(uint8_t value)
+        {
+            m_bytes.push_back(value);
+        }
+
+        void u16(uint16_t value)
+        {
+            littleEndian(value, 2);
+        }
+
+        void u32(uint32_t value)
+        {
+            littleEndian(value, 4);
+        }
+
+        void u64(uint64_t value)
+        {
+            littleEndian(value, 8);
+        }
+
+        void u32BigEndian(uint32_t value)
+        {
+            for (int shift = 24; shift >= 0; shift -= 8)
+            {
+                u8(static_cast<uint8_t>(value >> shift));
+            }
+        }
+
+        void bytes(std::string_view text)
+        {
+            m_bytes.insert(m_bytes.end(), text.begin(), text.end());
+        }
+
+        void string(std::string_view text)
+        {
+            bytes(text);
+            u8(0);
+        }
+
+        // Left-justified and padded, like the fields of ar headers
+        void field(std::string_view text, size_t width, char pad = ' ')
+        {
+            bytes(text.substr(0, width));
+            m_bytes.insert(m_bytes.end(), width - std::min(width, text.size()), static_cast<uint8_t>(pad));
+        }
+
+        void zeros(size_t count)
+        {
+            m_bytes.insert(m_bytes.end(), count, 0);
+        }
+
+        void align(size_t alignment, uint8_t filler = 0)
+        {
+            m_bytes.insert(m_bytes.end(), (alignment - m_bytes.size() % alignment) % alignment, filler);
+        }
+
+        void patch32(size_t offset, uint32_t value)
+        {
+            for (size_t i = 0; i < 4; ++i, value >>= 8)
+            {
+                m_bytes[offset + i] = static_cast<uint8_t>(value);
+            }
+        }
+
+        void patch64(size_t offset, uint64_t value)
+        {
+            for (size_t i = 0; i < 8; ++i, value >>= 8)
+            {
+                m_bytes[offset + i] = static_cast<uint8_t>(value);
+            }
+        }
+
+        void append(std::vector<uint8_t> const & other)
+        {
+            m_bytes.insert(m_bytes.end(), other.begin(), other.end());
+        }
+
+        std::vector<uint8_t> take()
+        {
+            return std::move(m_bytes);
+        }
+
+    private:
+        void littleEndian(uint64_t value, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i, value >>= 8)
+            {
+                u8(static_cast<uint8_t>(value));
+            }
+        }
+
+        std::vector<uint8_t> m_bytes;
+    };
+
+    // The names are split into the defined and the undefined ones
+    struct Names
+    {
+        std::span<std::string const> exports;
+        std::span<std::string const> imports;
+    };
+
+    Names splitNames(std::vector<std::string> const & names, unsigned importsPercent)
+    {
+        size_t const importsCount = names.size() * std::min(importsPercent, 100u) / 100;
+        std::span<std::string const> const all{ names };
+        return { all.first(names.size() - importsCount), all.last(importsCount) };
+    }
+
+    // See https://refspecs.linuxfoundation.org/elf/gabi4+/ch4.eheader.html
+    std::vector<uint8_t> generateELF(Names names)
+    {
+        constexpr size_t HeaderSize = 64;
+        constexpr size_t SectionHeaderSize = 64;
+        constexpr size_t SymbolSize = 24;
+        constexpr size_t TextSize = 16;
+        enum Section: uint16_t { Null, Text, SymbolTable, StringTable, SectionNames, SectionsCount };
+
+        ByteWriter strings;
+        strings.u8(0);
+        std::vector<uint32_t> nameOffsets;
+        for (auto const & group: { names.exports, names.imports })
+        {
+            for (std::string const & name: group)
+            {
+                nameOffsets.push_back(static_cast<uint32_t>(strings.size()));
+                strings.string(name);
+            }
+        }
+        std::string_view const sectionNames = "\0.text\0.symtab\0.strtab\0.shstrtab\0"sv;
+
+        ByteWriter image;
+        image.zeros(HeaderSize);
+
+        size_t const textOffset = image.size();
+        image.bytes(std::string(TextSize, '\xC3'));
+
+        image.align(8);
+        size_t const symbolsOffset = image.size();
+        image.zeros(SymbolSize);  // The null symbol
+        for (size_t i = 0; i < nameOffsets.size(); ++i)
+        {
+            bool const defined = i < names.exports.size();
+            image.u32(nameOffsets[i]);
+            image.u8(defined ? (1 << 4) | 2 : (1 << 4));  // STB_GLOBAL, STT_FUNC or STT_NOTYPE
+            image.u8(0);
+            image.u16(defined ? Text : 0);
+            image.u64(defined ? i % TextSize : 0);
+            image.u64(0);
+        }
+        size_t const symbolsSize = image.size() - symbolsOffset;
+
+        size_t const stringsOffset = image.size();
+        image.append(strings.take());
+        size_t const stringsSize = image.size() - stringsOffset;
+
+        size_t const sectionNamesOffset = image.size();
+        image.bytes(sectionNames);
+
+        image.align(8);
+        size_t const sectionsOffset = image.size();
+        auto section = [&image](uint32_t name, uint32_t type, uint64_t flags, size_t offset, size_t size,
+            uint32_t link, uint32_t info, uint64_t alignment, uint64_t entrySize)
+        {
+            image.u32(name);
+            image.u32(type);
+            image.u64(flags);
+            image.u64(0);
+            image.u64(offset);
+            image.u64(size);
+            image.u32(link);
+            image.u32(info);
+            image.u64(alignment);
+            image.u64(entrySize);
+        };
+        image.zeros(SectionHeaderSize);
+        section(1, 1 /*SHT_PROGBITS*/, 0x6 /*SHF_ALLOC | SHF_EXECINSTR*/, textOffset, TextSize, 0, 0, 16, 0);
+        // All the symbols but the null one are global
+        section(7, 2 /*SHT_SYMTAB*/, 0, symbolsOffset, symbolsSize, StringTable, 1, 8, SymbolSize);
+        section(15, 3 /*SHT_STRTAB*/, 0, stringsOffset, stringsSize, 0, 0, 1, 0);
+        section(23, 3 /*SHT_STRTAB*/, 0, sectionNamesOffset, sectionNames.size(), 0, 0, 1, 0);
+
+        std::vector<uint8_t> bytes = image.take();
+        ByteWriter header;
+        header.bytes("\x7F" "ELF");
+        header.u8(2);  // ELFCLASS64
+        header.u8(1);  // ELFDATA2LSB
+        header.u8(1);  // EV_CURRENT
+        header.zeros(9);
+        header.u16(1);   // ET_REL
+        header.u16(62);  // EM_X86_64
+        header.u32(1);
+        header.u64(0);
+        header.u64(0);
+        header.u64(sectionsOffset);
+        header.u32(0);
+        header.u16(HeaderSize);
+        header.u16(0);
+        header.u16(0);
+        header.u16(SectionHeaderSize);
+        header.u16(SectionsCount);
+        header.u16(SectionNames);
+        std::vector<uint8_t> const headerBytes = header.take();
+        std::copy(headerBytes.begin(), headerBytes.end(), bytes.begin());
+        return bytes;
+    }
+
+    // See https://docs.microsoft.com/en-us/windows/win32/debug/pe-format#coff-file-header-object-and-image
+    std::vector<uint8_t> generateCOFF(Names names)
+    {
+        constexpr size_t FileHeaderSize = 20;
+        constexpr size_t SectionHeaderSize = 40;
+        constexpr size_t TextSize = 16;
+        size_t const symbolsCount = names.exports.size() + names.imports.size();
+
+        ByteWriter image;
+        image.u16(0x8664);  // IMAGE_FILE_MACHINE_AMD64
+        image.u16(1);
+        image.u32(0);
+        image.u32(static_cast<uint32_t>(FileHeaderSize + SectionHeaderSize + TextSize));
+        image.u32(static_cast<uint32_t>(symbolsCount));
+        image.u16(0);
+        image.u16(0);
+
+        image.field(".text", 8, '\0');
+        image.u32(0);
+        image.u32(0);
+        image.u32(TextSize);
+        image.u32(FileHeaderSize + SectionHeaderSize);
+        image.u32(0);
+        image.u32(0);
+        image.u16(0);
+        image.u16(0);
+        image.u32(0x60500020);  // Code, 16-byte aligned, executable and readable
+        image.bytes(std::string(TextSize, '\xC3'));
+
+        // The names longer than 8 bytes live in the string table, its size comes first
+        ByteWriter strings;
+        strings.u32(0);
+        for (bool const defined: { true, false })
+        {
+            std::span<std::string const> const group = defined ? names.exports : names.imports;
+            for (size_t i = 0; i < group.size(); ++i)
+            {
+                std::string const & name = group[i];
+                if (name.size() <= 8)
+                {
+                    image.field(name, 8, '\0');
+                }
+                else
+                {
+                    image.u32(0);
+                    image.u32(static_cast<uint32_t>(strings.size()));
+                    strings.string(name);
+                }
+                image.u32(defined ? static_cast<uint32_t>(i % TextSize) : 0);
+                image.u16(defined ? 1 : 0);  // The section number, undefined otherwise
+                image.u16(0x20);              // Function
+                image.u8(2);                  // IMAGE_SYM_CLASS_EXTERNAL
+                image.u8(0);
+            }
+        }
+        strings.patch32(0, static_cast<uint32_t>(strings.size()));
+        image.append(strings.take());
+        return image.take();
+    }
+
+    // The last read-only section holds both tables, the exports are sorted like the loader expects them.
+    // Code sections of a page each may come first, the RVA lookups have to pass them by.
+    // See https://docs.microsoft.com/en-us/windows/win32/debug/pe-format#the-edata-section-image-only
+    std::vector<uint8_t> generatePE(Names names, size_t sectionsCount)
+    {
+        constexpr uint32_t SectionAlignment = 0x1000;
+        constexpr uint32_t FileAlignment = 0x200;
+        constexpr uint32_t MinHeadersSize = 0x400;
+        constexpr uint32_t HeadersBeforeSections = 0x148;  // DOS, PE and PE32+ optional headers
+        constexpr uint32_t SectionHeaderSize = 40;
+        constexpr uint32_t CodeSize = 16;
+        constexpr size_t ImportedModulesCount = 4;
+        // The loaders refuse more
+        constexpr size_t MaxSectionsCount = 96;
+
+        sectionsCount = std::clamp<size_t>(sectionsCount, 1, MaxSectionsCount);
+        uint32_t const paddingSectionsCount = static_cast<uint32_t>(sectionsCount - 1);
+        uint32_t const headersSize = std::max(MinHeadersSize, (HeadersBeforeSections +
+            static_cast<uint32_t>(sectionsCount) * SectionHeaderSize + FileAlignment - 1) / FileAlignment * FileAlignment);
+        uint32_t const sectionRVA = SectionAlignment * (1 + paddingSectionsCount);
+        uint32_t const sectionOffset = headersSize + FileAlignment * paddingSectionsCount;
+
+        std::vector<std::string_view> exports{ names.exports.begin(), names.exports.end() };
+        std::sort(exports.begin(), exports.end());
+
+        ByteWriter section;
+        auto rva = [&section, sectionRVA] { return static_cast<uint32_t>(sectionRVA + section.size()); };
+
+        // The exported functions point here, out of the export directory so they aren't taken for forwarders
+        section.bytes(std::string(CodeSize, '\xC3'));
+
+        uint32_t const exportsRVA = rva();
+        size_t const exportDirectory = section.size();
+        section.zeros(40);
+        uint32_t const functionsRVA = rva();
+        for (size_t i = 0; i < exports.size(); ++i)
+        {
+            section.u32(sectionRVA);
+        }
+        uint32_t const namePointersRVA = rva();
+        size_t const namePointers = section.size();
+        section.zeros(exports.size() * 4);
+        uint32_t const ordinalsRVA = rva();
+        for (size_t i = 0; i < exports.size(); ++i)
+        {
+            section.u16(static_cast<uint16_t>(i));
+        }
+        uint32_t const moduleNameRVA = rva();
+        section.string("bench.dll");
+        for (size_t i = 0; i < exports.size(); ++i)
+        {
+            section.patch32(namePointers + i * 4, rva());
+            section.string(exports[i]);
+        }
+        uint32_t const exportsSize = rva() - exportsRVA;
+
+        // Past the characteristics, the time stamp and the version
+        uint32_t const exportDirectoryFields[] = { moduleNameRVA, 1, static_cast<uint32_t>(exports.size()),
+            static_cast<uint32_t>(exports.size()), functionsRVA, namePointersRVA, ordinalsRVA };
+        for (size_t i = 0; i < std::size(exportDirectoryFields); ++i)
+        {
+            section.patch32(exportDirectory + 12 + i * 4, exportDirectoryFields[i]);
+        }
+
+        // The imports are spread over a few modules, every one has the lookup and the address tables
+        size_t const modulesCount = std::min(ImportedModulesCount, names.imports.size());
+        section.align(8);
+        uint32_t const importsRVA = rva();
+        size_t const descriptors = section.size();
+        section.zeros((modulesCount + 1) * 20);
+        uint32_t const importsSize = rva() - importsRVA;
+        for (size_t module = 0; module < modulesCount; ++module)
+        {
+            size_t const begin = names.imports.size() * module / modulesCount;
+            size_t const end = names.imports.size() * (module + 1) / modulesCount;
+
+            uint32_t const nameRVA = rva();
+            section.string("bench" + std::to_string(module) + ".dll");
+
+            section.align(8);
+            uint32_t const lookupRVA = rva();
+            size_t const lookupTable = section.size();
+            section.zeros((end - begin + 1) * 8);
+            uint32_t const addressesRVA = rva();
+            size_t const addressTable = section.size();
+            section.zeros((end - begin + 1) * 8);
+            for (size_t i = begin; i < end; ++i)
+            {
+                section.align(2);
+                section.patch64(lookupTable + (i - begin) * 8, rva());
+                section.patch64(addressTable + (i - begin) * 8, rva());
+                section.u16(0);  // Hint
+                section.string(names.imports[i]);
+            }
+
+            size_t const descriptor = descriptors + module * 20;
+            section.patch32(descriptor, lookupRVA);
+            section.patch32(descriptor + 12, nameRVA);
+            section.patch32(descriptor + 16, addressesRVA);
+        }
+
+        uint32_t const sectionSize = static_cast<uint32_t>(section.size());
+        uint32_t const rawSize = (sectionSize + FileAlignment - 1) / FileAlignment * FileAlignment;
+        uint32_t const imageSize = sectionRVA + (sectionSize + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+
+        ByteWriter image;
+        image.bytes("MZ");
+        image.zeros(0x3A);
+        image.u32(0x40);  // e_lfanew
+
+        image.bytes("PE"sv);
+        image.u16(0);
+        image.u16(0x8664);  // IMAGE_FILE_MACHINE_AMD64
+        image.u16(static_cast<uint16_t>(sectionsCount));
+        image.u32(0);
+        image.u32(0);
+        image.u32(0);
+        image.u16(240);     // PE32+ optional header
+        image.u16(0x2022);  // Executable DLL, large address aware
+
+        image.u16(0x20B);
+        image.u8(14);
+        image.u8(0);
+        image.u32(FileAlignment * paddingSectionsCount);
+        image.u32(rawSize);
+        image.u32(0);
+        image.u32(0);  // No entry point
+        image.u32(SectionAlignment);
+        image.u64(0x180000000ull);
+        image.u32(SectionAlignment);
+        image.u32(FileAlignment);
+        image.u16(6);
+        image.u16(0);
+        image.u16(0);
+        image.u16(0);
+        image.u16(6);
+        image.u16(0);
+        image.u32(0);
+        image.u32(imageSize);
+        image.u32(headersSize);
+        image.u32(0);
+        image.u16(2);       // IMAGE_SUBSYSTEM_WINDOWS_GUI
+        image.u16(0x0160);  // High entropy VA, dynamic base, NX compatible
+        image.u64(0x100000);
+        image.u64(0x1000);
+        image.u64(0x100000);
+        image.u64(0x1000);
+        image.u32(0);
+        image.u32(16);
+        for (size_t directory = 0; directory < 16; ++directory)
+        {
+            image.u32(directory == 0 ? exportsRVA : directory == 1 && modulesCount ? importsRVA : 0);
+            image.u32(directory == 0 ? exportsSize : directory == 1 && modulesCount ? importsSize : 0);
+        }
+
+        for (uint32_t padding = 0; padding < paddingSectionsCount; ++padding)
+        {
+            image.field(".text$" + std::to_string(padding), 8, '\0');
+            image.u32(CodeSize);
+            image.u32(SectionAlignment * (1 + padding));
+            image.u32(FileAlignment);
+            image.u32(headersSize + FileAlignment * padding);
+            image.u32(0);
+            image.u32(0);
+            image.u16(0);
+            image.u16(0);
+            image.u32(0x60000020);  // Code, executable, readable
+        }
+
+        image.field(".rdata", 8, '\0');
+        image.u32(sectionSize);
+        image.u32(sectionRVA);
+        image.u32(rawSize);
+        image.u32(sectionOffset);
+        image.u32(0);
+        image.u32(0);
+        image.u16(0);
+        image.u16(0);
+        image.u32(0x40000040);  // Initialized data, readable
+
+        image.zeros(headersSize - image.size());
+        for (uint32_t padding = 0; padding < paddingSectionsCount; ++padding)
+        {
+            image.bytes(std::string(CodeSize, '\xC3'));
+            image.zeros(FileAlignment - CodeSize);
+        }
+        image.append(section.take());
+        image.align(FileAlignment);
+        return image.take();
+    }
+
+    void appendArchiveMemberHeader(ByteWriter & archive, std::string_view name, size_t size)
+    {
+        archive.field(name, 16);
+        archive.field("0", 12);
+        archive.field("0", 6);
+        archive.field("0", 6);
+        archive.field("644", 8);
+        archive.field(std::to_string(size), 10);
+        archive.bytes("`\n");
+    }
+
+    // The members are ELF objects sharing the names evenly, the symbol table lists their definitions.
+    // See https://www.freebsd.org/cgi/man.cgi?query=ar&sektion=5
+    std::vector<uint8_t> generateArchive(Names names, size_t membersCount)
+    {
+        constexpr size_t MemberHeaderSize = 60;
+        membersCount = std::max<size_t>(1, std::min(membersCount, names.exports.size() + names.imports.size()));
+
+        std::vector<std::vector<uint8_t>> members;
+        std::vector<Names> memberNames;
+        for (size_t member = 0; member < membersCount; ++member)
+        {
+            auto slice = [member, membersCount](std::span<std::string const> all)
+            {
+                size_t const begin = all.size() * member / membersCount;
+                size_t const end = all.size() * (member + 1) / membersCount;
+                return all.subspan(begin, end - begin);
+            };
+            memberNames.push_back({ slice(names.exports), slice(names.imports) });
+            members.push_back(generateELF(memberNames.back()));
+        }
+
+        size_t namesSize = 0;
+        for (std::string const & name: names.exports)
+        {
+            namesSize += name.size() + 1;
+        }
+        size_t const symbolTableSize = 4 + names.exports.size() * 4 + namesSize;
+        size_t const symbolTablePadding = symbolTableSize % 2;
+
+        // The offsets of the member headers
+        std::vector<uint32_t> offsets;
+        size_t offset = 8 + MemberHeaderSize + symbolTableSize + symbolTablePadding;
+        for (std::vector<uint8_t> const & member: members)
+        {
+            offsets.push_back(static_cast<uint32_t>(offset));
+            offset += MemberHeaderSize + member.size() + member.size() % 2;
+        }
+
+        ByteWriter archive;
+        archive.bytes("!<arch>\n");
+        appendArchiveMemberHeader(archive, "/", symbolTableSize);
+        archive.u32BigEndian(static_cast<uint32_t>(names.exports.size()));
+        for (size_t member = 0; member < membersCount; ++member)
+        {
+            for (size_t i = 0; i < memberNames[member].exports.size(); ++i)
+            {
+                archive.u32BigEndian(offsets[member]);
+            }
+        }
+        for (std::string const & name: names.exports)
+        {
+            archive.string(name);
+        }
+        archive.align(2, '\n');
+
+        for (size_t member = 0; member < membersCount; ++member)
+        {
+            appendArchiveMemberHeader(archive, "m" + std::to_string(member) + ".o/", members[member].size());
+            archive.append(members[member]);
+            archive.align(2, '\n');
+        }
+        return archive.take();
+    }
+
+    char const * extension(ImageFormat format)
+    {
+        switch (format)
+        {
+            case ImageFormat::ELF:
+                return ".o";
+            case ImageFormat::COFF:
+                return ".obj";
+            case ImageFormat::PE:
+                return ".dll";
+            case ImageFormat::Archive:
+                break;
+        }
+        return ".a";
+    }
+}
+
+std::string_view SymSeek::Bench::toString(ImageFormat format)
+{
+    switch (format)
+    {
+        case ImageFormat::ELF:
+            return "elf";
+        case ImageFormat::COFF:
+            return "coff";
+        case ImageFormat::PE:
+            return "pe";
+        case ImageFormat::Archive:
+            break;
+    }
+    return "ar";
+}
+
+std::vector<std::string> SymSeek::Bench::generateNames(NameStyle style, ImageSpec const & spec)
+{
+    Random random{ spec.seed };
+    std::vector<std::string> names;
+    names.reserve(spec.symbolsCount);
+    for (size_t i = 0; i < spec.symbolsCount; ++i)
+    {
+        size_t const nameLength = spec.nameLength / 2 + random.below(spec.nameLength + 1);
+        if (!random.percent(spec.mangledPercent))
+        {
+            names.push_back(makeCName(random, i, nameLength));
+        }
+        else if (style == NameStyle::Itanium)
+        {
+            names.push_back(makeItaniumName(random, i, nameLength));
+        }
+        else
+        {
+            names.push_back(makeMSVCName(random, i, nameLength));
+        }
+    }
+    return names;
+}
+
+std::vector<uint8_t> SymSeek::Bench::generateImage(ImageFormat format, ImageSpec const & spec)
+{
+    bool const itanium = format == ImageFormat::ELF || format == ImageFormat::Archive;
+    std::vector<std::string> const names = generateNames(itanium ? NameStyle::Itanium : NameStyle::MSVC, spec);
+    Names const split = splitNames(names, spec.importsPercent);
+
+    switch (format)
+    {
+        case ImageFormat::ELF:
+            return generateELF(split);
+        case ImageFormat::COFF:
+            return generateCOFF(split);
+        case ImageFormat::PE:
+            return generatePE(split, spec.sectionsCount);
+        case ImageFormat::Archive:
+            break;
+    }
+    return generateArchive(split, spec.membersCount);
+}
+
+std::vector<std::filesystem::path> SymSeek::Bench::writeCorpus(std::filesystem::path const & directory,
+    CorpusSpec const & spec)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
+    {
+        return {};
+    }
+
+    std::vector<std::filesystem::path> files;
+    for (ImageFormat const format: { ImageFormat::ELF, ImageFormat::COFF, ImageFormat::PE, ImageFormat::Archive })
+    {
+        for (size_t i = 0; i < spec.filesPerFormat; ++i)
+        {
+            ImageSpec image = spec.image;
+            image.seed = spec.image.seed * 1'000'003 + files.size();
+
+            std::string fileName{ toString(format) };
+            fileName += '_';
+            fileName += std::to_string(i);
+            fileName += extension(format);
+            std::filesystem::path path = directory / fileName;
+
+            std::vector<uint8_t> const bytes = generateImage(format, image);
+            std::ofstream output{ path, std::ios::binary | std::ios::trunc };
+            output.write(reinterpret_cast<char const *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            if (!output.flush())
+            {
+                return {};
+            }
+            files.push_back(std::move(path));
+        }
+    }
+    return files;
+}
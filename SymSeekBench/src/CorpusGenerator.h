@@ -0,0 +1,58 @@
+#pragma once
+
+import <cstdint>;
+import <filesystem>;
+import <string>;
+import <string_view>;
+import <vector>;
+
+namespace SymSeek::Bench
+{
+    enum class ImageFormat: uint8_t
+    {
+        ELF,      // x86-64 relocatable object
+        COFF,     // x64 object
+        PE,       // x64 DLL with export and import tables
+        Archive   // GNU ar of ELF objects with its symbol table
+    };
+
+    std::string_view toString(ImageFormat format);
+
+    // Itanium names go into ELF and ar, MSVC ones into COFF and PE
+    enum class NameStyle: uint8_t
+    {
+        Itanium,
+        MSVC
+    };
+
+    // The same spec always gives the same bytes on any machine, no std distribution is involved
+    struct ImageSpec
+    {
+        size_t symbolsCount = 20'000;
+        // Average length of the raw names, they are spread from a half of it to one and a half
+        size_t nameLength = 48;
+        // The rest are plain C names
+        unsigned mangledPercent = 80;
+        // Undefined symbols of the objects, imports of the DLLs
+        unsigned importsPercent = 20;
+        size_t membersCount = 64;  // Of the archives
+        // Of the DLLs, the tables are in the last one, the rest only pad the section table out
+        size_t sectionsCount = 1;
+        uint64_t seed = 1;
+    };
+
+    // Functions, const, virtual and static methods of every access and variables, unique within the set
+    std::vector<std::string> generateNames(NameStyle style, ImageSpec const & spec);
+
+    std::vector<uint8_t> generateImage(ImageFormat format, ImageSpec const & spec);
+
+    struct CorpusSpec
+    {
+        ImageSpec image;
+        size_t filesPerFormat = 4;
+    };
+
+    // "<format>_<index>.<extension>" files right in the directory, each one with its own seed.
+    // Empty when any of them cannot be written.
+    std::vector<std::filesystem::path> writeCorpus(std::filesystem::path const & directory, CorpusSpec const & spec);
+}
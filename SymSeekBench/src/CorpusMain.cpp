@@ -0,0 +1,119 @@
+#include "CorpusGenerator.h"
+
+import <charconv>;
+import <cstdio>;
+import <string_view>;
+
+using namespace SymSeek;
+using namespace SymSeek::Bench;
+
+namespace
+{
+    char const Usage[] =
+        "Usage: %s [options] <directory>\n"
+        "Writes synthetic ELF, COFF, PE and ar images into the directory, the same options give the same bytes.\n"
+        "\n"
+        "  --files <count>        Images of each format, 4 by default\n"
+        "  --symbols <count>      Symbols of each image, 20000 by default\n"
+        "  --name-length <bytes>  Average length of the raw names, 48 by default\n"
+        "  --mangled <percent>    C++ names, the rest are C ones, 80 by default\n"
+        "  --imports <percent>    Undefined or imported symbols, 20 by default\n"
+        "  --members <count>      Objects of each archive, 64 by default\n"
+        "  --sections <count>     Sections of each DLL, the tables are in the last one, 1 by default\n"
+        "  --seed <number>        1 by default\n";
+
+    template<typename T>
+    bool parseNumber(std::string_view text, T & value)
+    {
+        auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc{} && end == text.data() + text.size();
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    CorpusSpec spec;
+    ImageSpec & image = spec.image;
+    char const * directory = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view const argument = argv[i];
+        if (argument == "-h" || argument == "--help")
+        {
+            std::printf(Usage, argv[0]);
+            return 0;
+        }
+        if (!argument.starts_with("--"))
+        {
+            if (directory)
+            {
+                std::fprintf(stderr, "Unexpected argument %s\n", argv[i]);
+                return 2;
+            }
+            directory = argv[i];
+            continue;
+        }
+        if (i + 1 == argc)
+        {
+            std::fprintf(stderr, "Option %s needs a value\n", argv[i]);
+            return 2;
+        }
+
+        std::string_view const value = argv[++i];
+        bool parsed = false;
+        if (argument == "--files")
+        {
+            parsed = parseNumber(value, spec.filesPerFormat);
+        }
+        else if (argument == "--symbols")
+        {
+            parsed = parseNumber(value, image.symbolsCount);
+        }
+        else if (argument == "--name-length")
+        {
+            parsed = parseNumber(value, image.nameLength);
+        }
+        else if (argument == "--mangled")
+        {
+            parsed = parseNumber(value, image.mangledPercent) && image.mangledPercent <= 100;
+        }
+        else if (argument == "--imports")
+        {
+            parsed = parseNumber(value, image.importsPercent) && image.importsPercent <= 100;
+        }
+        else if (argument == "--members")
+        {
+            parsed = parseNumber(value, image.membersCount);
+        }
+        else if (argument == "--sections")
+        {
+            parsed = parseNumber(value, image.sectionsCount) && image.sectionsCount;
+        }
+        else if (argument == "--seed")
+        {
+            parsed = parseNumber(value, image.seed);
+        }
+
+        if (!parsed)
+        {
+            std::fprintf(stderr, "Unknown option or malformed value %s %s\n", argument.data(), value.data());
+            return 2;
+        }
+    }
+
+    if (!directory)
+    {
+        std::fprintf(stderr, Usage, argv[0]);
+        return 2;
+    }
+
+    size_t const filesCount = writeCorpus(directory, spec).size();
+    if (spec.filesPerFormat && !filesCount)
+    {
+        std::fprintf(stderr, "Cannot write the images to %s\n", directory);
+        return 1;
+    }
+    std::printf("%zu images written to %s\n", filesCount, directory);
+    return 0;
+}
@@ -0,0 +1,241 @@
+#include "CommandLine.h"
+
+import <charconv>;
+import <filesystem>;
+import <regex>;
+import <string_view>;
+
+using namespace SymSeek;
+using namespace SymSeek::CLI;
+
+namespace
+{
+    char const Usage[] =
+        "Usage: %s [options] <directory> [<glob>...]\n"
+        "Searches the symbols of the binaries under the directory whose names match the globs,\n"
+        "the results are printed as soon as each binary is done.\n"
+        "\n"
+        "  -n, --name <text>       Substring of the demangled name, repeatable, any of them matches\n"
+        "  -e, --regex <pattern>   ECMAScript regular expression over the demangled name\n"
+        "  -r, --raw               Match and print the mangled names, nothing is demangled\n"
+        "      --exports           Only the symbols the binaries implement\n"
+        "      --imports           Only the symbols the binaries import\n"
+        "  -f, --format <format>   ndjson (default) or tsv\n"
+        "  -j, --jobs <count>      Worker threads, all the hardware ones by default\n"
+        "  -x, --exclude <glob>    Leave out the files and the directories of matching names, repeatable\n"
+        "      --ignore-case       Match the globs and the excludes regardless of the case of the names\n"
+        "  -L, --follow-symlinks   Walk into the linked directories and read the linked files\n"
+        "      --no-members        Read the archives by their symbol tables, not member by member\n"
+        "      --ordered           Print the binaries in the order they are found\n"
+        "  -v, --verbose           Report the files which aren't binaries to stderr\n"
+        "  -h, --help              Show this help\n"
+        "\n"
+        "Exit status: 0 if any symbol is found, 1 if none, 2 on errors, 130 if interrupted.\n";
+
+    // "--name=value" or "--name value"
+    class Arguments
+    {
+    public:
+        Arguments(int argc, char ** argv)
+        : m_argc{ argc }
+        , m_argv{ argv }
+        {
+        }
+
+        bool atEnd() const { return m_index >= m_argc; }
+        std::string_view next() { return m_argv[m_index++]; }
+
+        std::optional<std::string_view> value(std::string_view option, std::string_view inlineValue)
+        {
+            if (!inlineValue.empty())
+            {
+                return inlineValue;
+            }
+            if (atEnd())
+            {
+                std::fprintf(stderr, "Option %.*s needs a value\n", int(option.size()), option.data());
+                return std::nullopt;
+            }
+            return next();
+        }
+
+    private:
+        int m_argc;
+        char ** m_argv;
+        int m_index = 1;
+    };
+}
+
+void SymSeek::CLI::printUsage(std::FILE * stream, char const * program)
+{
+    std::fprintf(stream, Usage, program);
+}
+
+std::optional<Options> SymSeek::CLI::parseCommandLine(int argc, char ** argv)
+{
+    Options options;
+    Arguments arguments{ argc, argv };
+    std::vector<std::string_view> positional;
+    bool optionsEnd = false;
+
+    while (!arguments.atEnd())
+    {
+        std::string_view argument = arguments.next();
+        if (optionsEnd || argument.size() < 2 || argument[0] != '-')
+        {
+            positional.push_back(argument);
+            continue;
+        }
+        if (argument == "--")
+        {
+            optionsEnd = true;
+            continue;
+        }
+
+        std::string_view inlineValue;
+        if (size_t const equals = argument.find('='); argument.starts_with("--") && equals != std::string_view::npos)
+        {
+            inlineValue = argument.substr(equals + 1);
+            argument = argument.substr(0, equals);
+        }
+
+        if (argument == "-n" || argument == "--name")
+        {
+            auto value = arguments.value(argument, inlineValue);
+            if (!value)
+            {
+                return std::nullopt;
+            }
+            options.names.emplace_back(*value);
+        }
+        else if (argument == "-e" || argument == "--regex")
+        {
+            auto value = arguments.value(argument, inlineValue);
+            if (!value)
+            {
+                return std::nullopt;
+            }
+            try
+            {
+                std::regex{ value->begin(), value->end() };
+            }
+            catch (std::regex_error const & error)
+            {
+                std::fprintf(stderr, "Invalid regex \"%.*s\": %s\n", int(value->size()), value->data(), error.what());
+                return std::nullopt;
+            }
+            options.regex.emplace(*value);
+        }
+        else if (argument == "-r" || argument == "--raw")
+        {
+            options.raw = true;
+        }
+        else if (argument == "--exports" || argument == "--imports")
+        {
+            SymbolKinds const kinds = argument == "--exports" ? SymbolKinds::Exports : SymbolKinds::Imports;
+            if (options.kinds != SymbolKinds::All && options.kinds != kinds)
+            {
+                std::fprintf(stderr, "--exports and --imports exclude each other\n");
+                return std::nullopt;
+            }
+            options.kinds = kinds;
+        }
+        else if (argument == "-f" || argument == "--format")
+        {
+            auto value = arguments.value(argument, inlineValue);
+            if (!value)
+            {
+                return std::nullopt;
+            }
+            if (*value == "ndjson")
+            {
+                options.format = OutputFormat::NDJSON;
+            }
+            else if (*value == "tsv")
+            {
+                options.format = OutputFormat::TSV;
+            }
+            else
+            {
+                std::fprintf(stderr, "Unknown format %.*s\n", int(value->size()), value->data());
+                return std::nullopt;
+            }
+        }
+        else if (argument == "-j" || argument == "--jobs")
+        {
+            auto value = arguments.value(argument, inlineValue);
+            if (!value)
+            {
+                return std::nullopt;
+            }
+            auto [end, error] = std::from_chars(value->data(), value->data() + value->size(), options.jobs);
+            if (error != std::errc{} || end != value->data() + value->size())
+            {
+                std::fprintf(stderr, "Invalid number of jobs %.*s\n", int(value->size()), value->data());
+                return std::nullopt;
+            }
+        }
+        else if (argument == "-x" || argument == "--exclude")
+        {
+            auto value = arguments.value(argument, inlineValue);
+            if (!value)
+            {
+                return std::nullopt;
+            }
+            options.excludes.push_back(toString(std::string{ *value }));
+        }
+        else if (argument == "--ignore-case")
+        {
+            options.caseSensitive = false;
+        }
+        else if (argument == "-L" || argument == "--follow-symlinks")
+        {
+            options.followSymlinks = true;
+        }
+        else if (argument == "--no-members")
+        {
+            options.archiveMembers = false;
+        }
+        else if (argument == "--ordered")
+        {
+            options.ordered = true;
+        }
+        else if (argument == "-v" || argument == "--verbose")
+        {
+            options.verbose = true;
+        }
+        else if (argument == "-h" || argument == "--help")
+        {
+            options.help = true;
+            return options;
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown option %.*s\n", int(argument.size()), argument.data());
+            return std::nullopt;
+        }
+    }
+
+    if (positional.empty())
+    {
+        printUsage(stderr, argv[0]);
+        return std::nullopt;
+    }
+    options.directory = toString(std::string{ positional.front() });
+    for (size_t i = 1; i < positional.size(); ++i)
+    {
+        options.globs.push_back(toString(std::string{ positional[i] }));
+    }
+    return options;
+}
+
+String SymSeek::CLI::toString(std::string const & string)
+{
+    return std::filesystem::path{ string }.string<String::value_type>();
+}
+
+std::string SymSeek::CLI::toUtf8(String const & string)
+{
+    std::u8string const utf8 = std::filesystem::path{ string }.u8string();
+    return { utf8.begin(), utf8.end() };
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+import <cstdio>;
+import <optional>;
+import <string>;
+import <vector>;
+
+import symseek.crawler;
+import symseek.definitions;
+
+namespace SymSeek::CLI
+{
+    // grep-alike, so the scripts tell "nothing found" from a failure
+    enum ExitCode: int
+    {
+        Found       = 0,
+        NotFound    = 1,
+        Failure     = 2,
+        Interrupted = 130  // 128 + SIGINT, as the shells report it
+    };
+
+    enum class OutputFormat
+    {
+        NDJSON,
+        TSV
+    };
+
+    enum class SymbolKinds
+    {
+        All,
+        Exports,
+        Imports
+    };
+
+    struct Options
+    {
+        String directory;
+
+        // Of the file names, every file is tried when there are none
+        std::vector<String> globs;
+        // Of the names of the files and directories left out
+        std::vector<String> excludes;
+        // Of both, case-insensitive on Windows only by default
+        bool caseSensitive = CaseSensitiveNames;
+        bool followSymlinks = false;
+
+        // A symbol matches when it contains any of the names and the regex matches it, if there is one
+        std::vector<std::string> names;
+        std::optional<std::string> regex;
+
+        // Match and print the mangled names, nothing is demangled
+        bool raw = false;
+
+        SymbolKinds kinds = SymbolKinds::All;
+        OutputFormat format = OutputFormat::NDJSON;
+
+        // Zero stands for the number of hardware threads
+        size_t jobs = 0;
+
+        bool archiveMembers = true;
+        bool ordered = false;
+        bool verbose = false;
+        bool help = false;
+    };
+
+    void printUsage(std::FILE * stream, char const * program);
+
+    // Empty when the arguments are wrong, the reason is printed to stderr
+    std::optional<Options> parseCommandLine(int argc, char ** argv);
+
+    // The names of the files are kept as they are, only the encoding changes
+    String toString(std::string const & string);
+    std::string toUtf8(String const & string);
+}
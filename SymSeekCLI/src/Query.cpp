@@ -0,0 +1,63 @@
+#include "Query.h"
+
+import <algorithm>;
+
+using namespace SymSeek;
+using namespace SymSeek::CLI;
+
+Query::Query(Options const & options)
+: m_kinds{ options.kinds }
+, m_raw  { options.raw   }
+{
+    if (!options.names.empty())
+    {
+        m_matcher.emplace(options.names);
+        // The prefilter only knows how the demangled names are spelled in the mangled ones
+        if (!m_raw)
+        {
+            for (std::string const & name: options.names)
+            {
+                m_prefilters.emplace_back(name);
+            }
+        }
+    }
+    if (options.regex)
+    {
+        // Compiled up front, it is shared by all the workers
+        m_regex.emplace(*options.regex, std::regex::ECMAScript | std::regex::optimize);
+    }
+}
+
+RawNameFilter Query::rawNameFilter() const
+{
+    if (m_prefilters.empty())
+    {
+        return {};
+    }
+    return [prefilters = m_prefilters](std::string_view rawName)
+    {
+        return std::any_of(prefilters.begin(), prefilters.end(),
+            [rawName](RawNamePrefilter const & prefilter) { return prefilter(rawName); });
+    };
+}
+
+SymbolHandlerAction Query::operator()(Symbol const & symbol) const
+{
+    if ((m_kinds == SymbolKinds::Exports && !symbol.raw.implements) ||
+        (m_kinds == SymbolKinds::Imports && symbol.raw.implements))
+    {
+        return SymbolHandlerAction::Skip;
+    }
+
+    std::string_view const name = !m_raw && symbol.demangledName ? *symbol.demangledName : symbol.raw.name;
+    return matches(name) ? SymbolHandlerAction::Add : SymbolHandlerAction::Skip;
+}
+
+bool Query::matches(std::string_view name) const
+{
+    if (m_matcher && !(*m_matcher)(name))
+    {
+        return false;
+    }
+    return !m_regex || std::regex_search(name.begin(), name.end(), *m_regex);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+import <optional>;
+import <regex>;
+import <vector>;
+
+#include "CommandLine.h"
+
+import symseek;
+
+namespace SymSeek::CLI
+{
+    // The symbol handler of the scan, invoked concurrently from its workers.
+    // Immutable once built, so the copies taken by the scanner share nothing mutable.
+    class Query
+    {
+    public:
+        explicit Query(Options const & options);
+
+        // Passes the raw names which can match any of the --name texts, null when any can
+        RawNameFilter rawNameFilter() const;
+
+        SymbolHandlerAction operator()(Symbol const & symbol) const;
+
+    private:
+        bool matches(std::string_view name) const;
+
+        SymbolKinds m_kinds;
+        bool m_raw;
+        std::optional<SubstringMatcher> m_matcher;
+        std::optional<std::regex> m_regex;
+        std::vector<RawNamePrefilter> m_prefilters;
+    };
+}
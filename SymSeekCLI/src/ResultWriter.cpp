@@ -0,0 +1,287 @@
+#include "ResultWriter.h"
+
+import <cstdint>;
+import <string_view>;
+import <utility>;
+
+using namespace SymSeek;
+using namespace SymSeek::CLI;
+
+namespace
+{
+    char const * languageName(Mangler mangler)
+    {
+        switch (mangler)
+        {
+            case Mangler::MSVC:
+            case Mangler::GCC:
+                return "C++";
+            case Mangler::Rust:
+                return "Rust";
+            case Mangler::Swift:
+                return "Swift";
+            case Mangler::D:
+                return "D";
+            case Mangler::None:
+                break;
+        }
+        return "C";
+    }
+
+    char const * typeName(NameType type)
+    {
+        switch (type)
+        {
+            case NameType::Method:
+                return "method";
+            case NameType::Variable:
+                return "variable";
+            case NameType::Function:
+                break;
+        }
+        return "function";
+    }
+
+    char const * accessName(Access access)
+    {
+        switch (access)
+        {
+            case Access::Protected:
+                return "protected";
+            case Access::Private:
+                return "private";
+            case Access::Public:
+                break;
+        }
+        return "public";
+    }
+
+    // Length of the well-formed UTF-8 sequence at the beginning, zero when it is not one
+    size_t utf8SequenceLength(std::string_view text)
+    {
+        auto const lead = static_cast<unsigned char>(text[0]);
+        size_t length = 0;
+        unsigned char min = 0x80;
+        unsigned char max = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF)
+        {
+            length = 2;
+        }
+        else if (lead >= 0xE0 && lead <= 0xEF)
+        {
+            length = 3;
+            // Neither overlong forms nor surrogates
+            min = lead == 0xE0 ? 0xA0 : 0x80;
+            max = lead == 0xED ? 0x9F : 0xBF;
+        }
+        else if (lead >= 0xF0 && lead <= 0xF4)
+        {
+            length = 4;
+            min = lead == 0xF0 ? 0x90 : 0x80;
+            max = lead == 0xF4 ? 0x8F : 0xBF;
+        }
+        if (!length || text.size() < length)
+        {
+            return 0;
+        }
+
+        auto const second = static_cast<unsigned char>(text[1]);
+        if (second < min || second > max)
+        {
+            return 0;
+        }
+        for (size_t i = 2; i < length; ++i)
+        {
+            auto const next = static_cast<unsigned char>(text[i]);
+            if (next < 0x80 || next > 0xBF)
+            {
+                return 0;
+            }
+        }
+        return length;
+    }
+
+    void appendJSONString(std::string & output, std::string_view text)
+    {
+        static char const Hex[] = "0123456789abcdef";
+
+        output += '"';
+        for (size_t i = 0; i < text.size();)
+        {
+            auto const c = static_cast<unsigned char>(text[i]);
+            if (c >= 0x80)
+            {
+                size_t const length = utf8SequenceLength(text.substr(i));
+                if (length)
+                {
+                    output.append(text, i, length);
+                    i += length;
+                }
+                else
+                {
+                    output += "\\ufffd";
+                    ++i;
+                }
+                continue;
+            }
+
+            switch (c)
+            {
+                case '"':
+                    output += "\\\"";
+                    break;
+                case '\\':
+                    output += "\\\\";
+                    break;
+                case '\n':
+                    output += "\\n";
+                    break;
+                case '\t':
+                    output += "\\t";
+                    break;
+                case '\r':
+                    output += "\\r";
+                    break;
+                default:
+                    if (c < 0x20)
+                    {
+                        output += "\\u00";
+                        output += Hex[c >> 4];
+                        output += Hex[c & 0xF];
+                    }
+                    else
+                    {
+                        output += static_cast<char>(c);
+                    }
+            }
+            ++i;
+        }
+        output += '"';
+    }
+
+    // The fields cannot have the separators in them
+    void appendTSVField(std::string & output, std::string_view text)
+    {
+        for (char const c: text)
+        {
+            switch (c)
+            {
+                case '\t':
+                    output += "\\t";
+                    break;
+                case '\n':
+                    output += "\\n";
+                    break;
+                case '\r':
+                    output += "\\r";
+                    break;
+                case '\\':
+                    output += "\\\\";
+                    break;
+                default:
+                    output += c;
+            }
+        }
+    }
+}
+
+ResultWriter::ResultWriter(std::FILE * stream, OutputFormat format)
+: m_stream{ stream }
+, m_format{ format }
+{
+}
+
+void ResultWriter::write(String const & imagePath, std::vector<Symbol> const & symbols)
+{
+    if (symbols.empty())
+    {
+        return;
+    }
+
+    std::string const image = toUtf8(imagePath);
+    m_buffer.clear();
+    for (Symbol const & symbol: symbols)
+    {
+        if (m_format == OutputFormat::NDJSON)
+        {
+            appendJSON(image, symbol);
+        }
+        else
+        {
+            appendTSV(image, symbol);
+        }
+    }
+
+    // An image at a time, so the readers of the pipe see the results while the scan goes on
+    std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_stream);
+    std::fflush(m_stream);
+}
+
+bool ResultWriter::failed() const
+{
+    return std::ferror(m_stream) != 0;
+}
+
+void ResultWriter::appendJSON(std::string const & image, Symbol const & symbol)
+{
+    m_buffer += "{\"image\":";
+    appendJSONString(m_buffer, image);
+    m_buffer += symbol.raw.implements ? ",\"kind\":\"export\"" : ",\"kind\":\"import\"";
+    m_buffer += ",\"language\":\"";
+    m_buffer += languageName(symbol.mangler);
+    m_buffer += "\",\"name\":";
+    appendJSONString(m_buffer, symbol.raw.name);
+
+    // The rest is known from the demangled names only
+    if (symbol.demangledName)
+    {
+        m_buffer += ",\"demangled\":";
+        appendJSONString(m_buffer, *symbol.demangledName);
+        m_buffer += ",\"type\":\"";
+        m_buffer += typeName(symbol.type);
+        m_buffer += '"';
+        if (symbol.type == NameType::Method)
+        {
+            m_buffer += ",\"access\":\"";
+            m_buffer += accessName(symbol.access);
+            m_buffer += '"';
+        }
+
+        static constexpr std::pair<uint8_t, char const *> Modifiers[] = {
+            { Symbol::IsStatic, "static" }, { Symbol::IsVirtual, "virtual" },
+            { Symbol::IsConst, "const" }, { Symbol::IsVolatile, "volatile" } };
+        if (symbol.modifiers != Symbol::None)
+        {
+            char separator = '[';
+            m_buffer += ",\"modifiers\":";
+            for (auto const & [flag, name]: Modifiers)
+            {
+                if (symbol.modifiers & flag)
+                {
+                    m_buffer += separator;
+                    m_buffer += '"';
+                    m_buffer += name;
+                    m_buffer += '"';
+                    separator = ',';
+                }
+            }
+            m_buffer += ']';
+        }
+    }
+    m_buffer += "}\n";
+}
+
+void ResultWriter::appendTSV(std::string const & image, Symbol const & symbol)
+{
+    appendTSVField(m_buffer, image);
+    m_buffer += symbol.raw.implements ? "\texport\t" : "\timport\t";
+    m_buffer += languageName(symbol.mangler);
+    m_buffer += '\t';
+    appendTSVField(m_buffer, symbol.raw.name);
+    m_buffer += '\t';
+    if (symbol.demangledName)
+    {
+        appendTSVField(m_buffer, *symbol.demangledName);
+    }
+    m_buffer += '\n';
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+import <cstdio>;
+import <string>;
+import <vector>;
+
+#include "CommandLine.h"
+
+import symseek;
+
+namespace SymSeek::CLI
+{
+    // A line per symbol, written as soon as the scanner delivers the symbols of an image.
+    // NDJSON: {"image":…,"kind":"export"|"import","language":…,"name":…[,"demangled":…,"type":…]}
+    // TSV: image, kind, language, name and the demangled name, empty when there is none.
+    // The names not being valid UTF-8 have the stray bytes replaced with U+FFFD in NDJSON.
+    class ResultWriter
+    {
+    public:
+        ResultWriter(std::FILE * stream, OutputFormat format);
+
+        // Not thread-safe, the scanner serializes the result handler
+        void write(String const & imagePath, std::vector<Symbol> const & symbols);
+
+        // When stdout is closed or full, e.g. the reading end of the pipe is gone
+        bool failed() const;
+
+    private:
+        void appendJSON(std::string const & image, Symbol const & symbol);
+        void appendTSV(std::string const & image, Symbol const & symbol);
+
+        std::FILE * m_stream;
+        OutputFormat m_format;
+        std::string m_buffer;  // Reused by the images
+    };
+}
@@ -0,0 +1,99 @@
+#include "CommandLine.h"
+#include "Query.h"
+#include "ResultWriter.h"
+
+import <atomic>;
+import <csignal>;
+import <cstdio>;
+import <stop_token>;
+
+import symseek;
+
+using namespace SymSeek;
+using namespace SymSeek::CLI;
+
+namespace
+{
+    // Only a flag may be touched from a signal handler, the scan looks at it between the images
+    std::atomic<bool> g_interrupted{ false };
+
+    extern "C" void onInterrupt(int)
+    {
+        g_interrupted = true;
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    std::optional<Options> const options = parseCommandLine(argc, argv);
+    if (!options)
+    {
+        return ExitCode::Failure;
+    }
+    if (options->help)
+    {
+        printUsage(stdout, argv[0]);
+        return ExitCode::Found;
+    }
+
+    std::signal(SIGINT, onInterrupt);
+    std::signal(SIGTERM, onInterrupt);
+
+    ResultWriter writer{ stdout, options->format };
+    Query const query{ *options };
+    std::stop_source stopSource;
+    size_t symbolsFound = 0;
+
+    // Nothing is kept once printed, so the memory doesn't grow with the results
+    Scanner scanner{
+        ScanOptions{ .workersCount = options->jobs, .archiveMembers = options->archiveMembers,
+            .ordered = options->ordered, .rawNameFilter = query.rawNameFilter(), .deferDemangling = options->raw },
+        query,
+        [&](String const & imagePath, std::vector<Symbol> symbols)
+        {
+            symbolsFound += symbols.size();
+            writer.write(imagePath, symbols);
+            if (writer.failed())
+            {
+                stopSource.request_stop();
+            }
+        },
+        [&](String const & imagePath, ScanStatus status)
+        {
+            if (g_interrupted)
+            {
+                stopSource.request_stop();
+            }
+            if (status == ScanStatus::Reject && options->verbose)
+            {
+                std::fprintf(stderr, "Rejected %s\n", toUtf8(imagePath).c_str());
+            }
+        },
+        stopSource.get_token()
+    };
+
+    // The images are scanned while the directory is still being walked
+    CrawlOptions const crawlOptions{ .globs = options->globs, .excludes = options->excludes,
+        .caseSensitive = options->caseSensitive, .followSymlinks = options->followSymlinks };
+    bool const walked = crawl(options->directory, crawlOptions, [&](String path)
+    {
+        scanner.submit(std::move(path));
+        return !g_interrupted && !stopSource.stop_requested();
+    }, stopSource.get_token());
+    scanner.wait();
+
+    if (!walked)
+    {
+        std::fprintf(stderr, "Cannot read the directory %s\n", toUtf8(options->directory).c_str());
+        return ExitCode::Failure;
+    }
+    if (writer.failed())
+    {
+        return ExitCode::Failure;
+    }
+    if (g_interrupted)
+    {
+        return ExitCode::Interrupted;
+    }
+    return symbolsFound ? ExitCode::Found : ExitCode::NotFound;
+}
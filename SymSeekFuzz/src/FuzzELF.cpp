@@ -0,0 +1,6 @@
+#include "FuzzReader.h"
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const * data, size_t size)
+{
+    return SymSeek::Fuzz::fuzzReader(SymSeek::detail::ImageFormat::ELF, data, size);
+}
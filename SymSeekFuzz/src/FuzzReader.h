@@ -0,0 +1,50 @@
+#pragma once
+
+import <cstddef>;
+import <cstdint>;
+import <span>;
+
+import symseek;
+import symseek.internal.imageformat;
+
+namespace SymSeek::Fuzz
+{
+    // Reads whatever a scan or a lookup would, the members of the archives and the slices included
+    inline void drain(ISymbolReader const & reader)
+    {
+        for (RawSymbolRef const & symbolRef: reader.readSymbolRefs())
+        {
+            reader.definingMember(symbolRef.name);
+        }
+        for (size_t chunk = 0, chunksCount = reader.chunksCount(); chunk < chunksCount; ++chunk)
+        {
+            for ([[maybe_unused]] RawSymbolRef const & symbolRef: reader.readChunkRefs(chunk))
+            {
+            }
+        }
+        for (size_t member = 0, membersCount = reader.membersCount(); member < membersCount; ++member)
+        {
+            reader.memberName(member);
+            if (ISymbolReader::UPtr const memberReader = reader.memberReader(member))
+            {
+                drain(*memberReader);
+            }
+        }
+    }
+
+    // The inputs of the other formats are left to their own targets,
+    // each one goes through the reader(std::span) of its parser
+    inline int fuzzReader(detail::ImageFormat format, uint8_t const * data, size_t size)
+    {
+        std::span<uint8_t const> const imageBytes{ data, size };
+        if (detail::detectImageFormat(imageBytes) != format)
+        {
+            return 0;
+        }
+        if (ISymbolReader::UPtr const reader = createReader(imageBytes))
+        {
+            drain(*reader);
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+import <cstdio>;
+
+namespace SymSeek::Tests
+{
+    // Failed checks are reported and counted, the test goes on to report the rest of them
+    inline int g_failuresCount = 0;
+
+    inline bool check(bool condition, char const * expression, char const * file, int line)
+    {
+        if (!condition)
+        {
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+            ++g_failuresCount;
+        }
+        return condition;
+    }
+
+    // The exit code of the test
+    inline int report(char const * testName)
+    {
+        if (g_failuresCount)
+        {
+            std::fprintf(stderr, "%s: %d check(s) failed\n", testName, g_failuresCount);
+            return 1;
+        }
+        std::printf("%s: passed\n", testName);
+        return 0;
+    }
+}
+
+#define CHECK(cond) (SymSeek::Tests::check((cond), #cond, __FILE__, __LINE__))
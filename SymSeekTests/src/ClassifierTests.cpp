@@ -0,0 +1,176 @@
+#include "Check.h"
+#include "RegexClassifier.h"
+
+import <cstdint>;
+import <cstdio>;
+import <fstream>;
+import <iterator>;
+import <string>;
+import <string_view>;
+import <vector>;
+
+import symseek;
+
+using namespace SymSeek;
+using namespace SymSeek::Tests;
+
+namespace
+{
+    // Demangled by c++filt and undname, the way the scanner gets them
+    constexpr std::string_view RealNames[] = {
+        "foo()",
+        "foo(int, char const*)",
+        "ns::Foo::bar() const",
+        "ns::Foo::bar() const &",
+        "ns::Foo::bar() &&",
+        "ns::Foo::operator()(int) const",
+        "ns::Foo::operator<(ns::Foo const&) const",
+        "std::vector<int, std::allocator<int> >::push_back(int const&)",
+        "std::basic_string<char, std::char_traits<char>, std::allocator<char> >::~basic_string()",
+        "vtable for ns::Foo",
+        "typeinfo name for ns::Foo",
+        "guard variable for ns::instance()::s",
+        "ns::Foo::s_instance",
+        "ns::kConst",
+        "void (*ns::callback)(int)",
+        "ns::Foo::bar(void (*)(int)) const",
+        "public: virtual void __cdecl ns::Foo::bar(void)",
+        "public: virtual void __cdecl ns::Foo::bar(void)const ",
+        "protected: static int __cdecl ns::Foo::count(void)",
+        "private: int __cdecl ns::Foo::get(void)const ",
+        "public: static int const ns::Foo::kLimit",
+        "public: static int volatile ns::Foo::s_flag",
+        "int volatile ns::g_flag",
+        "int const volatile ns::g_register",
+        "public: __cdecl ns::Foo::Foo(class ns::Foo const &)",
+        "public: class ns::Foo & __cdecl ns::Foo::operator=(class ns::Foo &&)",
+        "const ns::Foo::`vftable'",
+        "`string'",
+        "static",
+        "virtual ",
+        "public:",
+        "public: ",
+        "a\nb()",
+        "f()\n",
+        "x const",
+        "x() const&&&",
+    };
+
+    // Fragments of the demangled names, the regexes hinge on them, and the corner cases around the line ends
+    constexpr std::string_view Tokens[] = {
+        "public: ", "protected: ", "private:", "static ", "virtual", " ", "const", "volatile ", "int",
+        "::", "(", ")", "&", "<", ">", ",", "*", "\n", "\t"
+    };
+
+    // splitmix64, the same names on every run
+    uint64_t nextRandom(uint64_t & state)
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    std::vector<std::string> buildCorpus()
+    {
+        constexpr size_t TokensCount = std::size(Tokens);
+        constexpr size_t ExhaustiveLength = 4;
+        constexpr size_t RandomNamesCount = 100'000;
+        constexpr size_t RandomMaxLength = 12;
+
+        std::vector<std::string> names{ std::begin(RealNames), std::end(RealNames) };
+
+        // Every sequence of up to ExhaustiveLength tokens
+        std::vector<size_t> indices;
+        for (size_t length = 1; length <= ExhaustiveLength; ++length)
+        {
+            indices.assign(length, 0);
+            while (true)
+            {
+                std::string & name = names.emplace_back();
+                for (size_t index: indices)
+                {
+                    name += Tokens[index];
+                }
+
+                size_t position = 0;
+                while (position < length && ++indices[position] == TokensCount)
+                {
+                    indices[position++] = 0;
+                }
+                if (position == length)
+                {
+                    break;
+                }
+            }
+        }
+
+        uint64_t state = 1;
+        for (size_t i = 0; i < RandomNamesCount; ++i)
+        {
+            std::string & name = names.emplace_back();
+            for (size_t length = 1 + nextRandom(state) % RandomMaxLength; length; --length)
+            {
+                name += Tokens[nextRandom(state) % TokensCount];
+            }
+        }
+        return names;
+    }
+
+    bool checkEquivalent(std::string const & name)
+    {
+        Symbol const expected = createSymbolByRegex(RawSymbol{ .name = "raw" }, name);
+        Symbol const actual = createSymbol(RawSymbol{ .name = "raw" }, name);
+
+        bool const equivalent = actual.type == expected.type && actual.access == expected.access &&
+            actual.modifiers == expected.modifiers && actual.demangledName == expected.demangledName &&
+            actual.raw.name == expected.raw.name;
+        if (!equivalent)
+        {
+            std::fprintf(stderr, "Classified differently: \"%s\"\n", name.c_str());
+        }
+        return equivalent;
+    }
+
+    void testKnownNames()
+    {
+        Symbol const method = createSymbol(RawSymbol{}, "protected: virtual int __cdecl ns::Foo::get(void)const ");
+        CHECK(method.type == NameType::Method);
+        CHECK(method.access == Access::Protected);
+        CHECK(method.modifiers == (Symbol::IsVirtual | Symbol::IsConst));
+
+        Symbol const function = createSymbol(RawSymbol{}, "ns::foo(int, char const*)");
+        CHECK(function.type == NameType::Function);
+        CHECK(function.modifiers == Symbol::None);
+
+        Symbol const variable = createSymbol(RawSymbol{}, "public: static int const volatile ns::Foo::s_port");
+        CHECK(variable.type == NameType::Variable);
+        CHECK(variable.modifiers == (Symbol::IsStatic | Symbol::IsConst | Symbol::IsVolatile));
+    }
+}
+
+// classifier-tests [file of demangled names, one per line]
+int main(int argc, char ** argv)
+{
+    testKnownNames();
+
+    std::vector<std::string> names = buildCorpus();
+    if (argc > 1)
+    {
+        std::ifstream input{ argv[1] };
+        for (std::string line; std::getline(input, line);)
+        {
+            names.push_back(std::move(line));
+        }
+    }
+
+    size_t differentCount = 0;
+    for (std::string const & name: names)
+    {
+        differentCount += !checkEquivalent(name);
+    }
+    CHECK(differentCount == 0);
+    std::printf("%zu names compared\n", names.size());
+
+    return report("classifier-tests");
+}
@@ -0,0 +1,58 @@
+#include "Check.h"
+
+import <string>;
+
+import symseek;
+
+using namespace SymSeek;
+
+namespace
+{
+    // The names are of the platform's String, narrow but on Windows
+    String name(char const * text)
+    {
+        return String{ text, text + std::char_traits<char>::length(text) };
+    }
+
+    bool matches(char const * fileName, char const * glob, bool caseSensitive)
+    {
+        return matchesGlob(name(fileName), name(glob), caseSensitive);
+    }
+
+    void testWildcards()
+    {
+        CHECK(matches("kernel32.lib", "*.lib", true));
+        CHECK(matches("kernel32.lib", "kernel??.lib", true));
+        CHECK(matches("libz.so.1.2", "*.so*", true));
+        CHECK(!matches("kernel32.dll", "*.lib", true));
+        CHECK(matches("a1.o", "a[0-9].o", true));
+        CHECK(!matches("ab.o", "a[0-9].o", true));
+        CHECK(matches("ab.o", "a[!0-9].o", true));
+        CHECK(matches("[.o", "[.o", true));
+    }
+
+    // QDir takes the name filters case-insensitively, the UI relies on it
+    void testCase()
+    {
+        CHECK(!matches("kernel32.Lib", "*.lib", true));
+        CHECK(matches("kernel32.Lib", "*.lib", false));
+        CHECK(matches("KERNEL32.LIB", "kernel32.lib", false));
+        CHECK(!matches("KERNEL32.DLL", "kernel32.lib", false));
+
+        CHECK(!matches("B.o", "[a-c].o", true));
+        CHECK(matches("B.o", "[a-c].o", false));
+        CHECK(matches("b.o", "[A-C].o", false));
+        CHECK(matches("B.o", "[abc].o", false));
+        CHECK(!matches("B.o", "[!a-c].o", false));
+        CHECK(!matches("D.o", "[a-c].o", false));
+        // Not letters, the case changes nothing
+        CHECK(!matches("_.o", "[a-c].o", false));
+    }
+}
+
+int main()
+{
+    testWildcards();
+    testCase();
+    return SymSeek::Tests::report("glob-tests");
+}
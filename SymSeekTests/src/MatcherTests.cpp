@@ -0,0 +1,167 @@
+#include "Check.h"
+
+import <cstdint>;
+import <cstdio>;
+import <optional>;
+import <string>;
+import <string_view>;
+import <vector>;
+
+import symseek;
+
+using namespace SymSeek;
+using namespace SymSeek::Tests;
+
+namespace
+{
+    constexpr InstructionSet InstructionSets[] = { InstructionSet::Scalar, InstructionSet::SSE42, InstructionSet::AVX2 };
+
+    char const * instructionSetName(InstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+            case InstructionSet::Scalar:
+                return "Scalar";
+            case InstructionSet::SSE42:
+                return "SSE4.2";
+            case InstructionSet::AVX2:
+                return "AVX2";
+        }
+        return "?";
+    }
+
+    // splitmix64, the same cases on every run
+    uint64_t nextRandom(uint64_t & state)
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Few distinct bytes, so the patterns do occur in the haystacks. The zero and the high bytes
+    // are there for the padding of the tail blocks and the nibble lookups.
+    std::string randomString(uint64_t & state, size_t length)
+    {
+        constexpr char Alphabet[] = { 'a', 'b', 'c', '_', ':', '\0', '\x80', '\xFF' };
+        std::string result(length, '\0');
+        for (char & c: result)
+        {
+            c = Alphabet[nextRandom(state) % std::size(Alphabet)];
+        }
+        return result;
+    }
+
+    bool naiveFind(std::string_view text, std::vector<std::string> const & patterns)
+    {
+        for (std::string const & pattern: patterns)
+        {
+            if (text.find(pattern) != std::string_view::npos)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The index may be of any of the patterns found, but it must be one of them
+    bool checkFind(SubstringMatcher const & matcher, std::string_view text)
+    {
+        std::vector<std::string> const & patterns = matcher.patterns();
+        std::optional<size_t> const found = matcher.find(text);
+        bool const expected = naiveFind(text, patterns);
+        bool const consistent = found.has_value() == expected &&
+            (!found || (*found < patterns.size() && text.find(patterns[*found]) != std::string_view::npos));
+        if (!consistent)
+        {
+            std::fprintf(stderr, "%s: %zu patterns, %zu bytes of text, found %s, expected %s\n",
+                instructionSetName(matcher.instructionSet()), patterns.size(), text.size(),
+                found ? std::to_string(*found).c_str() : "none", expected ? "a match" : "none");
+        }
+        return consistent;
+    }
+
+    // Every path the CPU has: the Teddy blocks of 16 and 32 bytes, their tails and the automaton above them
+    void testRandom(InstructionSet instructionSet)
+    {
+        constexpr size_t PatternsCounts[] = { 1, 2, 3, 8, 9, 16, 32, 33, 64, 200 };
+        constexpr size_t SetsPerCount = 60;
+        constexpr size_t MaxHaystackLength = 100;
+
+        uint64_t state = 1;
+        size_t failuresCount = 0;
+        for (size_t patternsCount: PatternsCounts)
+        {
+            for (size_t set = 0; set < SetsPerCount; ++set)
+            {
+                std::vector<std::string> patterns;
+                for (size_t i = 0; i < patternsCount; ++i)
+                {
+                    // Mostly short, at times longer than any haystack, rarely empty
+                    uint64_t const kind = nextRandom(state) % 50;
+                    size_t const length = kind == 0 ? 0 : kind == 1 ? MaxHaystackLength + 1 : 1 + nextRandom(state) % 6;
+                    patterns.push_back(randomString(state, length));
+                }
+
+                SubstringMatcher const matcher{ patterns, instructionSet };
+                for (size_t length = 0; length <= MaxHaystackLength; ++length)
+                {
+                    failuresCount += !checkFind(matcher, randomString(state, length));
+                }
+            }
+        }
+        CHECK(failuresCount == 0);
+    }
+
+    void testEmptyPattern(InstructionSet instructionSet)
+    {
+        SubstringMatcher const matcher{ { "foo", "bar", "", "baz" }, instructionSet };
+        CHECK(matcher.find("") == 2u);
+        CHECK(matcher.find("qux") == 2u);
+        CHECK(matcher.find("foo").has_value());
+    }
+
+    void testNoPatterns(InstructionSet instructionSet)
+    {
+        SubstringMatcher const matcher{ {}, instructionSet };
+        CHECK(!matcher.find(""));
+        CHECK(!matcher.find("foo"));
+    }
+
+    // A match across the last full block and the tail, at every alignment
+    void testBlockBoundaries(InstructionSet instructionSet)
+    {
+        SubstringMatcher const matcher{ { "needle", "pin" }, instructionSet };
+        for (size_t length = 6; length <= 70; ++length)
+        {
+            for (size_t position = 0; position + 6 <= length; ++position)
+            {
+                std::string text(length, 'x');
+                text.replace(position, 6, "needle");
+                CHECK(matcher.find(text) == 0u);
+            }
+            CHECK(!matcher.find(std::string(length, 'x') + "needl"));
+        }
+    }
+}
+
+int main()
+{
+    InstructionSet const supported = detectInstructionSet();
+    for (InstructionSet const instructionSet: InstructionSets)
+    {
+        if (instructionSet > supported)
+        {
+            std::printf("%s: not supported by the CPU, skipped\n", instructionSetName(instructionSet));
+            continue;
+        }
+        CHECK(SubstringMatcher({ "foo" }, instructionSet).instructionSet() == instructionSet);
+
+        testRandom(instructionSet);
+        testEmptyPattern(instructionSet);
+        testNoPatterns(instructionSet);
+        testBlockBoundaries(instructionSet);
+        std::printf("%s: checked\n", instructionSetName(instructionSet));
+    }
+    return report("matcher-tests");
+}
@@ -0,0 +1,90 @@
+#include "Check.h"
+
+import <cstdio>;
+import <string>;
+import <string_view>;
+
+import symseek;
+
+using namespace SymSeek;
+using namespace SymSeek::Tests;
+
+namespace
+{
+    // As ELF, COFF and Mach-O spell them, the latter with an extra underscore
+    constexpr std::string_view RawNames[] = {
+        "_ZN3foo3barEv",
+        "__ZN3foo3barEv",
+        "_ZNK3foo3bazEi",
+        "__ZNK3foo3bazEi",
+        "__ZNSt6vectorIiSaIiEE9push_backERKi",
+        "__ZTV3foo",
+        "__ZTI3foo",
+        "__ZGVZN3foo8instanceEvE1s",
+        "?bar@foo@@QEAAXXZ",
+        "??_7foo@@6B@",
+        "_foo_bar",
+        "foo_bar",
+        "__Z",
+        "_$s3foo3barSiyF",
+        "_RNvC3foo3bar",
+    };
+
+    constexpr std::string_view Queries[] = {
+        "foo::bar", "foo::baz", "bar()", "baz(int) const", "vector<int", "push_back", "std::allocator",
+        "vtable for foo", "typeinfo", "guard variable", "instance", "void __cdecl foo::bar", "vftable",
+        "foo_bar", "qux", "foo", "bar",
+    };
+
+    // The prefilter is a necessary condition only, it must never reject a name the search would find
+    void testNeverRejectsMatches()
+    {
+        std::string demangled;
+        for (std::string_view const query: Queries)
+        {
+            RawNamePrefilter const prefilter{ query };
+            for (std::string_view const rawName: RawNames)
+            {
+                std::string_view const name = demangle(rawName, demangled) ? std::string_view{ demangled } : rawName;
+                if (name.find(query) != std::string_view::npos && !CHECK(prefilter(rawName)))
+                {
+                    std::fprintf(stderr, "\"%.*s\" rejected \"%.*s\" (%.*s)\n", int(query.size()), query.data(),
+                        int(rawName.size()), rawName.data(), int(name.size()), name.data());
+                }
+            }
+        }
+    }
+
+    void testMachONames()
+    {
+        RawNamePrefilter const prefilter{ "foo::bar" };
+        CHECK(prefilter("__ZN3foo3barEv"));
+        CHECK(prefilter("_ZN3foo3barEv"));
+        CHECK(!prefilter("__ZN3baz3quxEv"));
+        CHECK(!prefilter("_ZN3baz3quxEv"));
+
+        // The special names are never rejected, in either spelling
+        RawNamePrefilter const special{ "vtable for" };
+        CHECK(special("__ZTV3baz"));
+        CHECK(special("_ZTV3baz"));
+        CHECK(special("__ZGVZN3baz8instanceEvE1s"));
+    }
+
+    void testPlainNames()
+    {
+        RawNamePrefilter const prefilter{ "foo_bar" };
+        CHECK(prefilter("_foo_bar"));
+        CHECK(!prefilter("_foo_baz"));
+        // Not demangled, so matched as they are
+        CHECK(!prefilter("_RNvC3foo3bar"));
+        CHECK(!prefilter("_$s3foo3barSiyF"));
+    }
+}
+
+int main()
+{
+    testNeverRejectsMatches();
+    testMachONames();
+    testPlainNames();
+    return report("prefilter-tests");
+}
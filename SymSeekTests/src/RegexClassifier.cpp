@@ -0,0 +1,78 @@
+#include "RegexClassifier.h"
+
+import <regex>;
+
+namespace SymSeek::Tests
+{
+    Symbol createSymbolByRegex(RawSymbol rawSymbol, std::string demangledName)
+    {
+        std::string name = demangledName;
+        Symbol result;
+        result.raw = std::move(rawSymbol);
+
+        static std::regex const constRx{
+            R"(^.+\W+\s*const\s*(&|&&)?$)", std::regex::optimize};
+        if (std::smatch match; std::regex_match(name, match, constRx))
+        {
+            result.modifiers |= Symbol::IsConst;
+            result.type = NameType::Method;
+        }
+
+        static std::regex const accessModifierRx{
+            R"(^(public|protected|private):.+)", std::regex::optimize};
+        if (std::smatch match; std::regex_match(name, match, accessModifierRx))
+        {
+            result.type = NameType::Method;
+            result.access = Access::Public;
+            std::string const & accessStr = match[1];
+
+            if (accessStr == "protected")
+            {
+                result.access = Access::Protected;
+            }
+            else if (accessStr == "private")
+            {
+                result.access = Access::Private;
+            }
+
+            name.erase(0, accessStr.length() + 2 /*colon and space*/);
+        }
+
+        static std::regex const modifierRx{
+            R"(^(virtual|static).+)", std::regex::optimize};
+        if (std::smatch match; std::regex_match(name, match, modifierRx))
+        {
+            std::string const & modifier = match[1];
+            if (modifier == "static")
+            {
+                result.modifiers |= Symbol::IsStatic;
+            }
+            else
+            {
+                result.modifiers |= Symbol::IsVirtual;
+            }
+
+            name.erase(0, modifier.length() + 1/*space*/);
+        }
+
+        static std::regex const signatureRx{
+             R"(^(.+)\((.*)\)(\s*const\s*)?(&|&&)?$)", std::regex::optimize};
+        if (std::smatch match; !std::regex_match(name, match, signatureRx))
+        {
+            result.type = NameType::Variable;
+            if (name.find("const ") != std::string::npos)
+            {
+                result.modifiers |= Symbol::IsConst;
+            }
+            // The only addition, the regexes never told the volatile variables
+            if (name.find("volatile ") != std::string::npos)
+            {
+                result.modifiers |= Symbol::IsVolatile;
+            }
+        }
+
+        result.demangledName = std::move(demangledName);
+
+        return result;
+    }
+}
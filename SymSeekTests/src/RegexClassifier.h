@@ -0,0 +1,13 @@
+#pragma once
+
+import <string>;
+
+import symseek;
+
+namespace SymSeek::Tests
+{
+    // createSymbol() as it was before the single-pass classifier, std::regex and all, but for the volatile
+    // variables being told the way the const ones are. The oracle of the equivalence test and the baseline
+    // of the benchmark.
+    Symbol createSymbolByRegex(RawSymbol rawSymbol, std::string demangledName);
+}
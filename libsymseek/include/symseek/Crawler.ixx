@@ -0,0 +1,57 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek.crawler;
+
+import <functional>;
+import <stop_token>;
+import <string>;
+import <string_view>;
+import <vector>;
+
+import symseek.definitions;
+
+export namespace SymSeek
+{
+    using StringView = std::basic_string_view<String::value_type>;
+
+    // The names compare as the file system does by default, case-insensitively on Windows only
+    constexpr bool CaseSensitiveNames = !SYMSEEK_OS_WIN();
+
+    // '*' and '?' wildcards and [] classes, as QDir takes the name filters.
+    // Compares the bytes of the names as they are, but for the case of ASCII letters when case-insensitive.
+    bool matchesGlob(StringView name, StringView glob, bool caseSensitive = CaseSensitiveNames);
+
+    struct CrawlOptions
+    {
+        // Names of the files to report, all the regular ones when empty
+        std::vector<String> globs;
+
+        // Names of the files and directories left out, the subtrees of the latter aren't entered at all
+        std::vector<String> excludes;
+
+        // Of both the globs and the excludes. QDir matches the name filters case-insensitively anywhere.
+        bool caseSensitive = CaseSensitiveNames;
+
+        // Zero stands for the number of hardware threads, but no less than MinWorkersCount:
+        // the walk mostly waits for the file system, the network shares especially
+        size_t workersCount = 0;
+
+        // Otherwise the symbolic links are neither followed nor reported.
+        // Either way a directory reached by several paths is listed once, so the loops end.
+        bool followSymlinks = false;
+
+        static constexpr size_t MinWorkersCount = 4;
+    };
+
+    // Invoked with the files as soon as they are found, returns false to stop the walk.
+    // Called from the crawler threads, but never concurrently.
+    using FileHandler = std::function<bool(String path)>;
+
+    // Lists every directory of the tree exactly once, the subdirectories are shared by the threads.
+    // The unreadable ones are skipped. Blocks until the whole tree is walked or the walk is stopped.
+    // False when the directory itself cannot be read.
+    bool crawl(String const & directory, CrawlOptions const & options, FileHandler const & handler,
+        std::stop_token stopToken = {});
+}
@@ -15,3 +15,17 @@
 #else
 #    error Unsupported platform
 #endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#    define SYMSEEK_ARCH_X86() 1
+#else
+#    define SYMSEEK_ARCH_X86() 0
+#endif
+
+// Lets a single function use an instruction set the rest of the code is not compiled for,
+// MSVC accepts the intrinsics anywhere
+#if defined(__GNUC__) || defined(__clang__)
+#    define SYMSEEK_TARGET(isa) __attribute__((target(isa)))
+#else
+#    define SYMSEEK_TARGET(isa)
+#endif
@@ -19,9 +19,21 @@ export namespace SymSeek
     using String = std::string;
 #endif
 
+    // The mangling schemes told apart by the first bytes of a name, see DemangleDispatcher
     enum class Mangler: uint8_t
     {
         MSVC = 0,
-        GCC
+        // Itanium C++ ABI of GCC and Clang, "_Z" ("__Z" on Mach-O)
+        GCC,
+        // Rust v0, "_R"; the legacy Rust names are Itanium ones
+        Rust,
+        // "$s", "_$s" and the older Swift prefixes
+        Swift,
+        // "_D" followed by the length of the outermost qualifier
+        D,
+        // Plain C names and anything else, left as they are
+        None
     };
+
+    constexpr size_t ManglersCount = static_cast<size_t>(Mangler::None) + 1;
 }
@@ -0,0 +1,63 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek.demanglecache;
+
+import <cstdint>;
+import <memory>;
+import <string>;
+import <string_view>;
+
+import symseek.definitions;
+
+export namespace SymSeek
+{
+    // Memoized demangled names shared by all the scanner workers, and by the scans of different trees:
+    // STL, Qt and CRT names repeat across thousands of binaries.
+    // Keyed by a 64-bit hash of the mangled bytes, bounded by the memory the entries take,
+    // the least recently hit ones are evicted first (CLOCK). Thread-safe.
+    class DemangleCache
+    {
+    public:
+        static constexpr size_t DefaultCapacity = 64 * 1024 * 1024;
+
+        struct Stats
+        {
+            uint64_t hits{};
+            uint64_t misses{};
+            uint64_t evictions{};
+            // By insert(), the entries of load() aside: the cache needs saving when it changed
+            uint64_t insertions{};
+            size_t entriesCount{};
+            // Including the bookkeeping of every entry
+            size_t memoryUsage{};
+        };
+
+        explicit DemangleCache(size_t capacity = DefaultCapacity);
+        ~DemangleCache();
+
+        DemangleCache(DemangleCache const &) = delete;
+        DemangleCache & operator=(DemangleCache const &) = delete;
+
+        // False on a miss. On a hit the output is assigned the demangled name,
+        // which is empty when none of the demanglers accepted the mangled one.
+        bool find(std::string_view mangled, std::string & demangled);
+
+        // Empty demangled name remembers the failure to demangle
+        void insert(std::string_view mangled, std::string_view demangled);
+
+        Stats stats() const;
+        void clear();
+
+        // Merges the entries of the file written by save(), up to the capacity.
+        // Missing or incompatible files are ignored (false).
+        bool load(String const & path);
+        // Atomically replaces the file
+        bool save(String const & path) const;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+}
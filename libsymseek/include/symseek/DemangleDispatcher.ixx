@@ -0,0 +1,86 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek.dispatcher;
+
+import <array>;
+import <span>;
+import <string>;
+import <string_view>;
+
+import symseek.definitions;
+import symseek.interfaces.demangler;
+
+export namespace SymSeek
+{
+    // The mangling scheme by the first three bytes of the name at most, nothing is parsed.
+    // Mach-O prepends an underscore to every name: "__Z", "__R" and "_$s".
+    constexpr Mangler detectMangler(std::string_view name) noexcept
+    {
+        if (name.size() < 3)
+        {
+            return Mangler::None;
+        }
+        if (name[0] == '?')
+        {
+            return Mangler::MSVC;
+        }
+        if (name[0] == '$')
+        {
+            return name[1] == 's' || name[1] == 'S' ? Mangler::Swift : Mangler::None;
+        }
+        if (name[0] != '_')
+        {
+            return Mangler::None;
+        }
+
+        char const next = name[2];
+        switch (name[1])
+        {
+            case 'Z':
+                return Mangler::GCC;
+            case 'R':
+                // The optional encoding version, then the path tag
+                return (next >= 'A' && next <= 'Z') || (next >= '0' && next <= '9') ? Mangler::Rust : Mangler::None;
+            case 'D':
+                return next >= '1' && next <= '9' ? Mangler::D : Mangler::None;
+            case 'T':
+                return next == '0' ? Mangler::Swift : Mangler::None;
+            case '$':
+                return next == 's' || next == 'S' ? Mangler::Swift : Mangler::None;
+            case '_':
+                return next == 'Z' ? Mangler::GCC : next == 'R' ? Mangler::Rust : Mangler::None;
+        }
+        return Mangler::None;
+    }
+
+    // Routes every name straight to the engine of its scheme instead of offering it to each one in turn.
+    // The schemes without an engine are classified all the same and left undemangled.
+    class DemangleDispatcher : public IDemangler
+    {
+    public:
+        // With all the engines of createDemangler()
+        DemangleDispatcher();
+
+        // Null when the names of the scheme are left as they are
+        IDemangler const * demangler(Mangler mangler) const noexcept
+        {
+            return m_demanglers[static_cast<size_t>(mangler)].get();
+        }
+
+        // Whether the name has a chance to be demangled at all
+        bool accepts(std::string_view name) const noexcept
+        {
+            return demangler(detectMangler(name)) != nullptr;
+        }
+
+        bool demangleInto(std::string_view name, std::string & output) const override;
+
+        // The names are grouped by their scheme, every engine takes its group in one call
+        void demangleBatch(std::span<std::string_view const> names, std::span<std::string> outputs) const override;
+
+    private:
+        std::array<IDemangler::UPtr, ManglersCount> m_demanglers;
+    };
+}
@@ -6,7 +6,9 @@ export module symseek.interfaces.demangler;
 
 import <memory>;
 import <optional>;
+import <span>;
 import <string>;
+import <string_view>;
 
 export namespace SymSeek
 {
@@ -15,6 +17,31 @@ export namespace SymSeek
     public:
         using UPtr = std::unique_ptr<IDemangler>;
 
-        virtual std::optional<std::string> demangleName(char const * name) const = 0;
+        virtual ~IDemangler() = default;
+
+        // Replaces the content of the output, which keeps its capacity from one call to another.
+        // False for the names of the other manglings and the malformed ones, the output is cleared then.
+        // Invoked concurrently from the scanner threads.
+        virtual bool demangleInto(std::string_view name, std::string & output) const = 0;
+
+        // Demangles a whole symbol table per call, the outputs of the rejected names are left empty.
+        // The engines set up their state once per batch rather than once per name.
+        virtual void demangleBatch(std::span<std::string_view const> names, std::span<std::string> outputs) const
+        {
+            for (size_t i = 0; i < names.size(); ++i)
+            {
+                demangleInto(names[i], outputs[i]);
+            }
+        }
+
+        std::optional<std::string> demangleName(std::string_view name) const
+        {
+            std::string result;
+            if (!demangleInto(name, result))
+            {
+                return std::nullopt;
+            }
+            return result;
+        }
     };
 }
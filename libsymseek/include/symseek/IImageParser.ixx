@@ -4,11 +4,14 @@ module;
 
 export module symseek.interfaces.parser;
 
+import <cstdint>;
 import <experimental/generator>;
 import <functional>;
 import <iterator>;
 import <memory>;
+import <span>;
 import <string>;
+import <string_view>;
 
 import symseek.definitions;
 import symseek.symbol;
@@ -21,11 +24,42 @@ export namespace SymSeek
         using UPtr = std::unique_ptr<ISymbolReader>;
 
         using SymbolsGen = std::experimental::generator<RawSymbol>;
+        using SymbolRefsGen = std::experimental::generator<RawSymbolRef>;
 
         virtual size_t symbolsCount() const = 0;  // for reserving enough space
-        virtual SymbolsGen readSymbols() const = 0;
+
+        // The names are borrowed from the image, no allocation per symbol
+        virtual SymbolRefsGen readSymbolRefs() const = 0;
+
+        // Readers of huge images may split them into parts, which can be read concurrently.
+        // All the chunks together yield the same symbols as readSymbolRefs().
+        virtual size_t chunksCount() const { return 1; }
+        virtual SymbolRefsGen readChunkRefs([[maybe_unused]] size_t chunk) const { return readSymbolRefs(); }
+
+        // Archives are made of images of their own, the members are reported separately as "archive(member)".
+        // The first call lists them, the readers of the members may be requested concurrently afterwards.
+        virtual size_t membersCount() const { return 0; }
+        virtual std::string_view memberName([[maybe_unused]] size_t member) const { return {}; }
+        // Null for the members which aren't object files
+        virtual std::unique_ptr<ISymbolReader> memberReader([[maybe_unused]] size_t member) const { return {}; }
+        // The archive indexes of the names answer "which member defines it?" at once, empty when none does
+        virtual std::string_view definingMember([[maybe_unused]] std::string_view rawName) const { return {}; }
+
+        // Owning counterparts, for the callers keeping every symbol anyway
+        SymbolsGen readSymbols() const { return materialize(readSymbolRefs()); }
+        SymbolsGen readChunk(size_t chunk) const { return materialize(readChunkRefs(chunk)); }
 
         virtual ~ISymbolReader() = default;
+
+    private:
+        static SymbolsGen materialize(SymbolRefsGen symbolRefs)
+        {
+            for (RawSymbolRef const & symbolRef: symbolRefs)
+            {
+                RawSymbol rawSymbol = symbolRef.materialize();
+                co_yield rawSymbol;
+            }
+        }
     };
 
     class IImageParser
@@ -34,6 +68,8 @@ export namespace SymSeek
         using UPtr = std::unique_ptr<IImageParser>;
 
         virtual ISymbolReader::UPtr reader(String const & imagePath) const = 0;
+        // For the images embedded into others, the bytes outlive the reader
+        virtual ISymbolReader::UPtr reader([[maybe_unused]] std::span<uint8_t const> imageBytes) const { return {}; }
         virtual ~IImageParser() = default;
     };
 }
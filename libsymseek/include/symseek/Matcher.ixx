@@ -0,0 +1,80 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek.matcher;
+
+import <array>;
+import <cstdint>;
+import <optional>;
+import <string>;
+import <string_view>;
+import <vector>;
+
+export namespace SymSeek
+{
+    enum class InstructionSet: uint8_t
+    {
+        Scalar,
+        SSE42,
+        AVX2
+    };
+
+    // The best one of the running CPU
+    InstructionSet detectInstructionSet();
+
+    // Byte-level search of many substrings at once, e.g. a list of banned API names.
+    // Up to a few dozens of patterns are looked for with the SIMD Teddy algorithm
+    // (https://github.com/BurntSushi/aho-corasick/tree/master/src/packed/teddy),
+    // bigger sets and the CPUs without SIMD go through an Aho-Corasick automaton.
+    // Immutable once built, so it is shared by all the scanner threads.
+    class SubstringMatcher
+    {
+    public:
+        // The instruction set is the best supported one, but not above the limit
+        explicit SubstringMatcher(std::vector<std::string> patterns,
+            InstructionSet limit = InstructionSet::AVX2);
+
+        // Index of a pattern found in the text
+        std::optional<size_t> find(std::string_view text) const noexcept;
+
+        bool operator()(std::string_view text) const noexcept
+        {
+            return find(text).has_value();
+        }
+
+        std::vector<std::string> const & patterns() const noexcept { return m_patterns; }
+        InstructionSet instructionSet() const noexcept { return m_instructionSet; }
+
+    private:
+        static constexpr size_t BucketsCount = 8;
+        static constexpr size_t MaxFingerprintLength = 3;
+
+        void buildTeddy();
+        void buildAutomaton();
+
+        std::optional<size_t> findTeddy(std::string_view text) const noexcept;
+        std::optional<size_t> findAutomaton(std::string_view text) const noexcept;
+
+        // Candidates of a SIMD block: a set of buckets for each position
+        std::optional<size_t> verify(std::string_view text, size_t position, uint8_t buckets) const noexcept;
+
+        std::vector<std::string> m_patterns;
+        InstructionSet m_instructionSet = InstructionSet::Scalar;
+        std::optional<size_t> m_emptyPattern;  // Found in any text
+        size_t m_minLength{};
+
+        // Teddy: a bit per bucket for the low and high nibbles of the first bytes of the patterns
+        bool m_useTeddy = false;
+        size_t m_fingerprintLength{};
+        std::array<std::array<uint8_t, 16>, MaxFingerprintLength> m_lowMasks{};
+        std::array<std::array<uint8_t, 16>, MaxFingerprintLength> m_highMasks{};
+        std::array<std::vector<uint32_t>, BucketsCount> m_buckets;
+
+        // Aho-Corasick: DFA over the classes of bytes, the bytes absent from the patterns share class 0
+        std::array<uint16_t, 256> m_byteClasses{};
+        size_t m_classesCount{};
+        std::vector<uint32_t> m_transitions;
+        std::vector<uint32_t> m_outputs;  // A pattern ending in the state, NoOutput otherwise
+    };
+}
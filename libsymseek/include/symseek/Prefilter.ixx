@@ -0,0 +1,44 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek.prefilter;
+
+import <string>;
+import <string_view>;
+import <vector>;
+
+namespace SymSeek::detail
+{
+    // Must be found in the mangled name, unless one of the encodings printing it is there
+    struct RequiredToken
+    {
+        std::string text;
+        std::vector<std::string> unless;
+    };
+}
+
+export namespace SymSeek
+{
+    // Necessary condition of a substring search over the demangled names, checked on the raw ones.
+    // The identifiers of a demangled name are spelled verbatim in its mangled form
+    // (Itanium <length><name>, MSVC name@), so the identifier fragments of the query must be there too,
+    // unless the demangler could have synthesized them (std::, builtin types, keywords and so on).
+    // The names rejected by it can never match the query, whatever the demangler makes of them.
+    class RawNamePrefilter
+    {
+    public:
+        // Passes everything
+        RawNamePrefilter() = default;
+        explicit RawNamePrefilter(std::string_view query);
+
+        bool operator()(std::string_view rawName) const noexcept;
+
+    private:
+        std::string m_query;
+
+        // Fragments the respective demangler cannot synthesize, the longest first
+        std::vector<detail::RequiredToken> m_itaniumTokens;
+        std::vector<detail::RequiredToken> m_microsoftTokens;
+    };
+}
@@ -0,0 +1,101 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek.scanner;
+
+import <cstdint>;
+import <functional>;
+import <memory>;
+import <stop_token>;
+import <string_view>;
+import <vector>;
+
+import symseek.definitions;
+import symseek.demanglecache;
+import symseek.symbol;
+
+export namespace SymSeek
+{
+    enum class SymbolHandlerAction: uint8_t
+    {
+        // Add the symbol to the result
+        Add,
+
+        // Skip the symbol,
+        Skip,
+
+        // Stop processing the binary
+        Stop
+    };
+
+    // Invoked concurrently from the worker threads
+    using SymbolHandler = std::function<SymbolHandlerAction(Symbol const &)>;
+
+    // Cheap check of the raw name before it is demangled, see RawNamePrefilter.
+    // The symbols it rejects never reach the SymbolHandler. Invoked concurrently as well.
+    using RawNameFilter = std::function<bool(std::string_view rawName)>;
+
+    enum class ScanStatus: uint8_t
+    {
+        Start,
+        Finish,
+        Reject
+    };
+
+    struct ScanOptions
+    {
+        // Zero stands for the number of hardware threads
+        size_t workersCount = 0;
+
+        // Let the readers of huge images (archives mostly) split them into chunks
+        // which are stolen by the idle workers
+        bool splitImages = true;
+
+        // Parse every member of the archives on its own and report its symbols as "archive(member)",
+        // instead of the names of the archive symbol table. The status handler still gets the archive.
+        bool archiveMembers = true;
+
+        // Deliver the results in the order the images were submitted
+        bool ordered = false;
+
+        RawNameFilter rawNameFilter;
+
+        // Leave the names raw, tagged with their scheme, for the consumers to demangle the few they show.
+        // The SymbolHandler gets the raw symbols as well, see demangle().
+        bool deferDemangling = false;
+
+        // Shared by the scans, so each distinct name is demangled once
+        std::shared_ptr<DemangleCache> demangleCache;
+    };
+
+    class Scanner
+    {
+    public:
+        // The handlers are never invoked concurrently
+        using ResultHandler = std::function<void(String const & imagePath, std::vector<Symbol> symbols)>;
+        using StatusHandler = std::function<void(String const & imagePath, ScanStatus status)>;
+
+        Scanner(ScanOptions options, SymbolHandler symbolHandler, ResultHandler resultHandler,
+            StatusHandler statusHandler = {}, std::stop_token stopToken = {});
+
+        Scanner(Scanner const &) = delete;
+        Scanner & operator=(Scanner const &) = delete;
+
+        // Images in progress are abandoned
+        ~Scanner();
+
+        void submit(String imagePath);
+
+        // Blocks until all the submitted images are processed
+        void wait();
+
+        // Cooperative, the workers abandon the images at the next check point
+        void cancel();
+        bool isCancelled() const;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+}
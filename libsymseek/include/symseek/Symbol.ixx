@@ -7,8 +7,11 @@ export module symseek.symbol;
 import <functional>;
 import <optional>;
 import <string>;
+import <string_view>;
 import <vector>;
 
+import symseek.definitions;
+
 export namespace SymSeek
 {
     enum class Access: uint8_t
@@ -25,13 +28,26 @@ export namespace SymSeek
         Variable
     };
 
-    // TODO Squeeze these structs
+    // Convenient to build and pass around, large result sets are better kept packed in a SymbolStore
     struct RawSymbol
     {
         std::string name;
         bool implements = true;   // Implements or Imports?
     };
 
+    // Borrowed form of RawSymbol, the name refers to the image being read,
+    // so it is only valid until the next symbol is requested from the reader
+    struct RawSymbolRef
+    {
+        std::string_view name;
+        bool implements = true;
+
+        RawSymbol materialize() const
+        {
+            return RawSymbol{ .name = std::string{ name }, .implements = implements };
+        }
+    };
+
     struct Symbol
     {
         RawSymbol raw;
@@ -44,8 +60,11 @@ export namespace SymSeek
             IsVolatile = 0b0010,  // When type == Variable
             IsVirtual  = 0b0100,  // When type == Method
             IsStatic   = 0b1000,  // When type == Method
-        };  //:3 bit field?
-        int modifiers = None;
+        };
+        uint8_t modifiers = None;
+        // Of the raw name. Unless demangledName is set, the name is left for the consumers
+        // to demangle when they need it, see ScanOptions::deferDemangling.
+        Mangler mangler = Mangler::None;
         std::optional<std::string> demangledName;
     };
 }
@@ -0,0 +1,67 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek.index;
+
+import <cstdint>;
+import <memory>;
+import <stop_token>;
+import <vector>;
+
+import symseek.definitions;
+import symseek.scanner;
+import symseek.symbol;
+
+export namespace SymSeek
+{
+    struct IndexOptions
+    {
+        // Files whose size or modification time changed are compared by contents
+        // before being parsed again, handy for the trees which are re-copied as a whole
+        bool hashContents = false;
+
+        ScanOptions scan{};
+    };
+
+    // Persistent index of all the symbols found in a set of images, usually a directory tree.
+    // Images are keyed by their path, size and modification time, so a refresh
+    // parses only the ones changed since the index was written.
+    // The members of the archives are stored one by one under the key of their archive,
+    // unless ScanOptions::archiveMembers is off.
+    class SymbolIndex
+    {
+    public:
+        SymbolIndex();
+        ~SymbolIndex();
+
+        SymbolIndex(SymbolIndex const &) = delete;
+        SymbolIndex & operator=(SymbolIndex const &) = delete;
+
+        // Maps the index file, missing or incompatible files result in an empty index
+        bool open(String const & indexPath);
+        bool isOpen() const;
+        void close();
+
+        size_t imagesCount() const;
+        size_t symbolsCount() const;
+
+        // True when the index holds exactly these images, none of them has changed
+        // and the archives were read the way the options tell
+        bool isFresh(std::vector<String> const & imagePaths, IndexOptions const & options) const;
+
+        // Parses the new and changed images, drops the vanished ones,
+        // then atomically replaces the index file and opens it again.
+        // The index is left untouched if the refresh is cancelled.
+        bool refresh(std::vector<String> const & imagePaths, IndexOptions const & options,
+            Scanner::StatusHandler statusHandler = {}, std::stop_token stopToken = {});
+
+        // One pass over the stored symbols, in the same way Scanner delivers them
+        void query(SymbolHandler const & symbolHandler, Scanner::ResultHandler const & resultHandler,
+            std::stop_token stopToken = {}) const;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+}
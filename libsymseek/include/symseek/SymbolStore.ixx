@@ -0,0 +1,124 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek.store;
+
+import <cstdint>;
+import <optional>;
+import <string_view>;
+import <vector>;
+
+import symseek.definitions;
+import symseek.symbol;
+import symseek.internal.stringpool;
+
+export namespace SymSeek
+{
+    // Fixed-size record of a symbol kept by SymbolStore, the names are addressed in its string pool
+    struct PackedSymbol
+    {
+        enum Flags: uint32_t
+        {
+            Implements     = 0b0001,
+            HasDemangled   = 0b0010,
+            TypeShift      = 2,
+            AccessShift    = 4,
+            ModifiersShift = 6,
+            // The name of a known scheme isn't demangled yet, see SymbolStore::resolve()
+            Deferred       = 0b0100'0000'0000,
+            ManglerShift   = 11,
+            TwoBitsMask    = 0b0011,
+            ThreeBitsMask  = 0b0111,
+            FourBitsMask   = 0b1111,
+        };
+
+        uint32_t rawOffset{};
+        uint32_t rawLength{};
+        uint32_t demangledOffset{};
+        uint32_t demangledLength{};
+        uint32_t image{};
+        uint32_t flags{};
+
+        bool implements() const noexcept { return flags & Implements; }
+        bool hasDemangledName() const noexcept { return flags & HasDemangled; }
+        NameType type() const noexcept { return static_cast<NameType>((flags >> TypeShift) & TwoBitsMask); }
+        Access access() const noexcept { return static_cast<Access>((flags >> AccessShift) & TwoBitsMask); }
+        uint8_t modifiers() const noexcept { return static_cast<uint8_t>((flags >> ModifiersShift) & FourBitsMask); }
+        bool isDeferred() const noexcept { return flags & Deferred; }
+        Mangler mangler() const noexcept { return static_cast<Mangler>((flags >> ManglerShift) & ThreeBitsMask); }
+
+        static uint32_t packFlags(Symbol const & symbol) noexcept;
+        static void unpackFlags(uint32_t flags, Symbol & symbol) noexcept;
+    };
+    static_assert(sizeof(PackedSymbol) == 24);
+
+    // Append-only arena of symbols: every name is interned once into a pool of blocks which never move
+    // and each symbol takes a single PackedSymbol, instead of a couple of heap strings.
+    // The views handed out stay valid until the store is cleared or destroyed.
+    class SymbolStore
+    {
+    public:
+        SymbolStore() = default;
+
+        SymbolStore(SymbolStore const &) = delete;
+        SymbolStore & operator=(SymbolStore const &) = delete;
+
+        // The symbols added afterwards belong to this image
+        void addImage(String imagePath);
+
+        // Fail (return false) when the string pool is exhausted, i.e. outgrows 4GB
+        bool add(Symbol const & symbol);
+        // The names are copied, so they may refer to a mapped image about to be closed
+        bool add(std::string_view rawName, bool implements, std::optional<std::string_view> demangledName = {},
+            uint32_t flags = 0);
+
+        size_t size() const noexcept { return m_symbols.size(); }
+        bool empty() const noexcept { return m_symbols.empty(); }
+        size_t imagesCount() const noexcept { return m_images.size(); }
+
+        PackedSymbol const & operator[](size_t index) const noexcept { return m_symbols[index]; }
+
+        // Replaces the deferred record with its demangled form, or marks it as having none.
+        // The views handed out before stay valid.
+        bool resolve(size_t index, Symbol const & symbol);
+
+        std::string_view rawName(PackedSymbol const & symbol) const noexcept
+        {
+            return m_strings.view({ symbol.rawOffset, symbol.rawLength });
+        }
+
+        std::optional<std::string_view> demangledName(PackedSymbol const & symbol) const noexcept
+        {
+            if (!symbol.hasDemangledName())
+            {
+                return std::nullopt;
+            }
+            return m_strings.view({ symbol.demangledOffset, symbol.demangledLength });
+        }
+
+        // Demangled one when available
+        std::string_view name(PackedSymbol const & symbol) const noexcept
+        {
+            return demangledName(symbol).value_or(rawName(symbol));
+        }
+
+        String const & imagePath(PackedSymbol const & symbol) const noexcept
+        {
+            return m_images[symbol.image];
+        }
+
+        Symbol unpack(PackedSymbol const & symbol) const;
+
+        // Bytes taken by the records and the names
+        size_t memoryUsage() const noexcept;
+
+        void reserve(size_t symbolsCount, size_t stringBytes);
+        void clear() noexcept;
+
+    private:
+        std::vector<PackedSymbol> m_symbols;
+        std::vector<String> m_images;
+        detail::StringPool m_strings;
+    };
+}
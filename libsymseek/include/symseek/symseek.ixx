@@ -2,14 +2,30 @@ module;
 
 export module symseek;
 
+import <cstdint>;
+import <span>;
+
+export import symseek.crawler;
 export import symseek.definitions;
+export import symseek.demanglecache;
+export import symseek.dispatcher;
 export import symseek.interfaces.demangler;
 export import symseek.interfaces.parser;
+export import symseek.matcher;
+export import symseek.prefilter;
+export import symseek.scanner;
 export import symseek.symbol;
+export import symseek.index;
+export import symseek.store;
 
 export namespace SymSeek
 {
     ISymbolReader::UPtr createReader(String const & imagePath);
+    // Of the images in memory, the bytes outlive the reader
+    ISymbolReader::UPtr createReader(std::span<uint8_t const> imageBytes);
     IDemangler::UPtr createDemangler(Mangler mangler);
     Symbol createSymbol(RawSymbol rawSymbol, std::string demangledName);
+
+    // Demangles the way the scanner does, for the symbols left raw. Thread-safe.
+    bool demangle(std::string_view rawName, std::string & output);
 }
@@ -0,0 +1,96 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek.internal.arena;
+
+import <algorithm>;
+import <cstddef>;
+import <cstring>;
+import <memory>;
+import <new>;
+import <span>;
+import <type_traits>;
+import <vector>;
+
+export namespace SymSeek::detail
+{
+    // Bump allocator for the short-lived trees of a single operation, e.g. demangling a name.
+    // The objects are never destroyed one by one, reset() rewinds the arena for the next operation
+    // and keeps the blocks, so a warmed-up arena makes no heap allocations.
+    class Arena
+    {
+    public:
+        Arena() = default;
+
+        Arena(Arena const &) = delete;
+        Arena & operator=(Arena const &) = delete;
+
+        template<typename T, typename... Args>
+        T * make(Args &&... args)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "The arena never destroys its objects");
+            return new (allocate(sizeof(T), alignof(T))) T{ std::forward<Args>(args)... };
+        }
+
+        template<typename T>
+        std::span<T const> copy(std::span<T const> values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (values.empty())
+            {
+                return {};
+            }
+            auto * data = static_cast<T *>(allocate(values.size_bytes(), alignof(T)));
+            std::memcpy(data, values.data(), values.size_bytes());
+            return { data, values.size() };
+        }
+
+        void * allocate(size_t size, size_t alignment);
+
+        void reset() noexcept
+        {
+            m_current = 0;
+            m_offset = 0;
+        }
+
+    private:
+        static constexpr size_t MinBlockSize = 16 * 1024;
+
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> data;
+            size_t size{};
+        };
+
+        std::vector<Block> m_blocks;
+        size_t m_current{};
+        size_t m_offset{};
+    };
+}
+
+// Implementation
+
+using namespace SymSeek::detail;
+
+void * Arena::allocate(size_t size, size_t alignment)
+{
+    while (m_current < m_blocks.size())
+    {
+        Block & block = m_blocks[m_current];
+        size_t const offset = (m_offset + alignment - 1) & ~(alignment - 1);
+        if (offset + size <= block.size)
+        {
+            m_offset = offset + size;
+            return block.data.get() + offset;
+        }
+        ++m_current;
+        m_offset = 0;
+    }
+
+    size_t const blockSize = std::max(size + alignment, MinBlockSize);
+    m_blocks.push_back(Block{ .data = std::make_unique_for_overwrite<std::byte[]>(blockSize), .size = blockSize });
+    m_current = m_blocks.size() - 1;
+    m_offset = size;
+    return m_blocks.back().data.get();
+}
@@ -0,0 +1,122 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek.internal.byteview;
+
+import <concepts>;
+import <cstdint>;
+import <cstring>;
+import <optional>;
+import <span>;
+import <string_view>;
+import <type_traits>;
+
+import symseek.internal.helpers;
+
+export namespace SymSeek::detail
+{
+    // The bytes of a mapped image, or a part of them, which are never read past.
+    // A failed access yields null or an empty result, so the parsers stay zero-copy
+    // and a malformed image is told apart with a check per structure rather than per byte.
+    class ByteView
+    {
+    public:
+        ByteView() = default;
+
+        ByteView(uint8_t const * data, size_t size) noexcept
+        : m_data{ data }
+        , m_size{ data ? size : 0 }
+        {
+        }
+
+        ByteView(std::span<uint8_t const> bytes) noexcept
+        : ByteView{ bytes.data(), bytes.size() }
+        {
+        }
+
+        uint8_t const * data() const noexcept { return m_data; }
+        size_t size() const noexcept { return m_size; }
+        bool empty() const noexcept { return !m_size; }
+
+        std::span<uint8_t const> bytes() const noexcept { return { m_data, m_size }; }
+
+        bool contains(uint64_t offset, uint64_t length) const noexcept
+        {
+            return offset <= m_size && length <= m_size - offset;
+        }
+
+        // Null unless all the objects fit, the structures of the images are packed, so no alignment is needed
+        template<typename T>
+        T const * at(uint64_t offset, uint64_t count = 1) const noexcept
+        {
+            if (count > m_size / sizeof(T) || !contains(offset, sizeof(T) * count))
+            {
+                return nullptr;
+            }
+            return reinterpret_cast<T const *>(m_data + offset);
+        }
+
+        // Empty unless the whole range fits
+        ByteView sub(uint64_t offset, uint64_t length) const noexcept
+        {
+            return contains(offset, length) ? ByteView{ m_data + offset, static_cast<size_t>(length) } : ByteView{};
+        }
+
+        // Up to the end, empty past it
+        ByteView tail(uint64_t offset) const noexcept
+        {
+            return offset <= m_size ? ByteView{ m_data + offset, static_cast<size_t>(m_size - offset) } : ByteView{};
+        }
+
+        // Empty unless the string is terminated within the view
+        std::string_view string(uint64_t offset) const noexcept
+        {
+            if (offset >= m_size)
+            {
+                return {};
+            }
+            auto const begin = reinterpret_cast<char const *>(m_data + offset);
+            auto const terminator = static_cast<char const *>(std::memchr(begin, 0, static_cast<size_t>(m_size - offset)));
+            return terminator ? std::string_view{ begin, static_cast<size_t>(terminator - begin) } : std::string_view{};
+        }
+
+        // A copy, for the structures which aren't packed and may lie unaligned
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        std::optional<T> load(uint64_t offset) const noexcept
+        {
+            if (!contains(offset, sizeof(T)))
+            {
+                return std::nullopt;
+            }
+            T value;
+            std::memcpy(&value, m_data + offset, sizeof(T));
+            return value;
+        }
+
+        template<std::unsigned_integral T>
+        std::optional<T> loadLittleEndian(uint64_t offset) const noexcept
+        {
+            if (!contains(offset, sizeof(T)))
+            {
+                return std::nullopt;
+            }
+            return detail::loadLittleEndian<T>(m_data + offset);
+        }
+
+        template<std::unsigned_integral T>
+        std::optional<T> loadBigEndian(uint64_t offset) const noexcept
+        {
+            if (!contains(offset, sizeof(T)))
+            {
+                return std::nullopt;
+            }
+            return detail::loadBigEndian<T>(m_data + offset);
+        }
+
+    private:
+        uint8_t const * m_data{};
+        size_t m_size{};
+    };
+}
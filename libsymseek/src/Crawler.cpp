@@ -0,0 +1,507 @@
+module;
+
+#include <symseek/Definitions.h>
+
+#if SYMSEEK_OS_LIN()
+#   include <dirent.h>
+#   include <fcntl.h>
+#   include <sys/stat.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#endif
+
+module symseek.crawler;
+
+import <algorithm>;
+import <atomic>;
+import <condition_variable>;
+import <cwctype>;
+import <filesystem>;
+import <memory>;
+import <mutex>;
+import <optional>;
+import <set>;
+import <system_error>;
+import <thread>;
+import <utility>;
+
+using namespace SymSeek;
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    using Char = String::value_type;
+
+    Char toLower(Char c)
+    {
+#if SYMSEEK_OS_WIN()
+        return static_cast<Char>(std::towlower(static_cast<wint_t>(c)));
+#else
+        // The bytes of UTF-8 past ASCII are left as they are, whatever the locale
+        return c >= 'A' && c <= 'Z' ? static_cast<Char>(c - 'A' + 'a') : c;
+#endif
+    }
+
+    Char toUpper(Char c)
+    {
+#if SYMSEEK_OS_WIN()
+        return static_cast<Char>(std::towupper(static_cast<wint_t>(c)));
+#else
+        return c >= 'a' && c <= 'z' ? static_cast<Char>(c - 'a' + 'A') : c;
+#endif
+    }
+
+    bool sameChar(Char left, Char right, bool caseSensitive)
+    {
+        return left == right || (!caseSensitive && toLower(left) == toLower(right));
+    }
+
+    // "[a-f]" takes 'C' as well when case-insensitive, as QDir does
+    bool inRange(Char first, Char last, Char c, bool caseSensitive)
+    {
+        auto const contains = [first, last](Char other) { return first <= other && other <= last; };
+        return contains(c) || (!caseSensitive && (contains(toLower(c)) || contains(toUpper(c))));
+    }
+
+    // The class begins past '[', the position is moved past ']'.
+    // An unterminated class is a plain '[' then.
+    std::optional<bool> matchesClass(StringView glob, size_t & position, Char c, bool caseSensitive)
+    {
+        size_t i = position;
+        bool const negated = i < glob.size() && (glob[i] == '!' || glob[i] == '^');
+        i += negated;
+
+        bool matched = false;
+        for (bool first = true; i < glob.size() && (first || glob[i] != ']'); first = false, ++i)
+        {
+            if (i + 2 < glob.size() && glob[i + 1] == '-' && glob[i + 2] != ']')
+            {
+                matched |= inRange(glob[i], glob[i + 2], c, caseSensitive);
+                i += 2;
+            }
+            else
+            {
+                matched |= sameChar(glob[i], c, caseSensitive);
+            }
+        }
+        if (i >= glob.size())
+        {
+            return std::nullopt;
+        }
+        position = i + 1;
+        return matched != negated;
+    }
+
+    bool matchesAny(StringView name, std::vector<String> const & globs, bool caseSensitive)
+    {
+        return std::any_of(globs.begin(), globs.end(),
+            [name, caseSensitive](String const & glob) { return matchesGlob(name, glob, caseSensitive); });
+    }
+
+    constexpr Char Separator = static_cast<Char>(fs::path::preferred_separator);
+
+    String joinPath(String const & directory, StringView name)
+    {
+        String path;
+        path.reserve(directory.size() + name.size() + 1);
+        path = directory;
+        if (path.empty() || path.back() != Separator)
+        {
+            path += Separator;
+        }
+        path += name;
+        return path;
+    }
+
+#if SYMSEEK_OS_LIN()
+    // Shared by the subdirectories waiting to be opened relative to it, closed once they all are
+    class Descriptor
+    {
+    public:
+        explicit Descriptor(int fd) noexcept
+        : m_fd{ fd }
+        {
+        }
+
+        Descriptor(Descriptor const &) = delete;
+        Descriptor & operator=(Descriptor const &) = delete;
+
+        ~Descriptor()
+        {
+            ::close(m_fd);
+        }
+
+        int get() const noexcept { return m_fd; }
+
+    private:
+        int m_fd;
+    };
+
+    // The entries of getdents64(2), glibc before 2.30 has no wrapper for it
+    struct LinuxDirent64
+    {
+        uint64_t d_ino;
+        int64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[1];
+    };
+
+    // Large enough for a network share to send a whole directory in a few round trips
+    constexpr size_t ListingBufferSize = 64 * 1024;
+
+    // openat(2) relative to the parent, the kernel doesn't resolve the whole path again
+    struct Directory
+    {
+        std::shared_ptr<Descriptor const> parent;  // Null for the root, opened by its path
+        String path;
+        size_t nameOffset{};
+    };
+
+    using DirectoryKey = std::pair<uint64_t, uint64_t>;  // Device and inode
+#else
+    struct Directory
+    {
+        String path;
+    };
+
+    using DirectoryKey = fs::path;  // Canonical
+#endif
+
+    class Crawl
+    {
+    public:
+        Crawl(CrawlOptions const & options, FileHandler const & handler, std::stop_token stopToken)
+        : m_options  { options              }
+        , m_handler  { handler              }
+        , m_stopToken{ std::move(stopToken) }
+        {
+        }
+
+        bool run(String const & directory)
+        {
+            String root = directory;
+            while (root.size() > 1 && root.back() == Separator)
+            {
+                root.pop_back();
+            }
+            if (!canEnter(root))
+            {
+                return false;
+            }
+            m_pending.push_back(Directory{ .path = std::move(root) });
+
+            size_t workersCount = m_options.workersCount;
+            if (!workersCount)
+            {
+                workersCount = std::max<size_t>(CrawlOptions::MinWorkersCount, std::thread::hardware_concurrency());
+            }
+            std::vector<std::jthread> workers;
+            workers.reserve(workersCount);
+            for (size_t i = 0; i < workersCount; ++i)
+            {
+                workers.emplace_back([this] { workerLoop(); });
+            }
+            return true;
+        }
+
+    private:
+        bool stopped() const
+        {
+            return m_stopped || m_stopToken.stop_requested();
+        }
+
+        void workerLoop()
+        {
+#if SYMSEEK_OS_LIN()
+            auto const buffer = std::make_unique_for_overwrite<char[]>(ListingBufferSize);
+#endif
+            for (;;)
+            {
+                Directory directory;
+                {
+                    std::unique_lock lock{ m_mutex };
+                    m_condition.wait(lock, [this] { return !m_pending.empty() || !m_busyCount || stopped(); });
+                    if (m_pending.empty() || stopped())
+                    {
+                        m_condition.notify_all();
+                        return;
+                    }
+                    // Depth first, the descriptors of the parents are released sooner
+                    directory = std::move(m_pending.back());
+                    m_pending.pop_back();
+                    ++m_busyCount;
+                }
+
+#if SYMSEEK_OS_LIN()
+                enter(directory, buffer.get());
+#else
+                enter(directory);
+#endif
+
+                bool done = false;
+                {
+                    std::lock_guard lock{ m_mutex };
+                    done = !--m_busyCount && m_pending.empty();
+                }
+                if (done)
+                {
+                    m_condition.notify_all();
+                }
+            }
+        }
+
+        void push(Directory directory)
+        {
+            {
+                std::lock_guard lock{ m_mutex };
+                m_pending.push_back(std::move(directory));
+            }
+            m_condition.notify_one();
+        }
+
+        void report(String path)
+        {
+            std::lock_guard lock{ m_handlerMutex };
+            if (!stopped() && !m_handler(std::move(path)))
+            {
+                m_stopped = true;
+                m_condition.notify_all();
+            }
+        }
+
+        // Only the links may lead to a directory once more
+        bool isFirstVisit(DirectoryKey key)
+        {
+            if (!m_options.followSymlinks)
+            {
+                return true;
+            }
+            std::lock_guard lock{ m_visitedMutex };
+            return m_visited.insert(std::move(key)).second;
+        }
+
+        // The entry names are taken as they are, so both the excludes and the globs see the raw bytes
+        void visit(StringView name, bool isDirectory, auto makeDirectory, String const & parentPath)
+        {
+            if (!m_options.excludes.empty() && matchesAny(name, m_options.excludes, m_options.caseSensitive))
+            {
+                return;
+            }
+            if (isDirectory)
+            {
+                push(makeDirectory());
+            }
+            else if (m_options.globs.empty() || matchesAny(name, m_options.globs, m_options.caseSensitive))
+            {
+                report(joinPath(parentPath, name));
+            }
+        }
+
+#if SYMSEEK_OS_LIN()
+        int openDirectory(Directory const & directory) const
+        {
+            int const flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC | (m_options.followSymlinks ? 0 : O_NOFOLLOW);
+            if (!directory.parent)
+            {
+                return ::open(directory.path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            }
+            return ::openat(directory.parent->get(), directory.path.c_str() + directory.nameOffset, flags);
+        }
+
+        bool canEnter(String const & root) const
+        {
+            int const fd = ::open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return false;
+            }
+            ::close(fd);
+            return true;
+        }
+
+        void enter(Directory const & directory, char * buffer)
+        {
+            int const fd = openDirectory(directory);
+            if (fd < 0)
+            {
+                return;
+            }
+            auto const descriptor = std::make_shared<Descriptor const>(fd);
+
+            struct stat status{};
+            if (m_options.followSymlinks &&
+                (::fstat(fd, &status) || !isFirstVisit({ uint64_t(status.st_dev), uint64_t(status.st_ino) })))
+            {
+                return;
+            }
+
+            for (;;)
+            {
+                long const size = ::syscall(SYS_getdents64, fd, buffer, ListingBufferSize);
+                if (size <= 0)
+                {
+                    return;
+                }
+
+                for (long offset = 0; offset < size;)
+                {
+                    auto const * entry = reinterpret_cast<LinuxDirent64 const *>(buffer + offset);
+                    offset += entry->d_reclen;
+
+                    std::string_view const name = entry->d_name;
+                    if (name == "." || name == "..")
+                    {
+                        continue;
+                    }
+                    if (stopped())
+                    {
+                        return;
+                    }
+
+                    // The file systems not filling the type in, and the links to follow, take a stat
+                    unsigned char type = entry->d_type;
+                    if (type == DT_UNKNOWN || (type == DT_LNK && m_options.followSymlinks))
+                    {
+                        int const statFlags = m_options.followSymlinks ? 0 : AT_SYMLINK_NOFOLLOW;
+                        if (::fstatat(fd, entry->d_name, &status, statFlags))
+                        {
+                            continue;
+                        }
+                        type = S_ISDIR(status.st_mode) ? DT_DIR : S_ISREG(status.st_mode) ? DT_REG : DT_UNKNOWN;
+                    }
+                    if (type != DT_DIR && type != DT_REG)
+                    {
+                        continue;
+                    }
+
+                    visit(name, type == DT_DIR, [&]
+                    {
+                        String path = joinPath(directory.path, name);
+                        size_t const nameOffset = path.size() - name.size();
+                        return Directory{ .parent = descriptor, .path = std::move(path), .nameOffset = nameOffset };
+                    }, directory.path);
+                }
+            }
+        }
+#else
+        bool canEnter(String const & root) const
+        {
+            std::error_code error;
+            return fs::is_directory(root, error);
+        }
+
+        void enter(Directory const & directory)
+        {
+            std::error_code error;
+            if (m_options.followSymlinks)
+            {
+                fs::path canonical = fs::canonical(directory.path, error);
+                if (error || !isFirstVisit(std::move(canonical)))
+                {
+                    return;
+                }
+            }
+
+            fs::directory_iterator iterator{ directory.path, fs::directory_options::skip_permission_denied, error };
+            for (fs::directory_iterator const end; !error && iterator != end; iterator.increment(error))
+            {
+                if (stopped())
+                {
+                    return;
+                }
+
+                fs::directory_entry const & entry = *iterator;
+                if (!m_options.followSymlinks && entry.is_symlink(error))
+                {
+                    continue;
+                }
+                bool const isDirectory = entry.is_directory(error);
+                if (!isDirectory && !entry.is_regular_file(error))
+                {
+                    continue;
+                }
+
+                String const name = entry.path().filename().string<Char>();
+                visit(name, isDirectory, [&] { return Directory{ entry.path().string<Char>() }; }, directory.path);
+            }
+        }
+#endif
+
+        CrawlOptions const & m_options;
+        FileHandler const & m_handler;
+        std::stop_token m_stopToken;
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::vector<Directory> m_pending;  // Guarded by m_mutex
+        size_t m_busyCount{};               // Directories being listed, guarded by m_mutex
+        std::atomic<bool> m_stopped{ false };
+
+        std::mutex m_handlerMutex;
+
+        std::mutex m_visitedMutex;
+        std::set<DirectoryKey> m_visited;
+    };
+}
+
+bool SymSeek::matchesGlob(StringView name, StringView glob, bool caseSensitive)
+{
+    // Backtracks to the last '*' only, which is enough as it can absorb any of the earlier mismatches
+    size_t n = 0;
+    size_t g = 0;
+    size_t starGlob = StringView::npos;
+    size_t starName = 0;
+    while (n < name.size())
+    {
+        if (g < glob.size() && glob[g] == '*')
+        {
+            starGlob = ++g;
+            starName = n;
+            continue;
+        }
+        if (g < glob.size())
+        {
+            size_t next = g + 1;
+            bool matched = false;
+            if (glob[g] == '?')
+            {
+                matched = true;
+            }
+            else if (std::optional<bool> inClass;
+                glob[g] == '[' && (inClass = matchesClass(glob, next, name[n], caseSensitive)))
+            {
+                matched = *inClass;
+            }
+            else
+            {
+                matched = sameChar(glob[g], name[n], caseSensitive);
+            }
+            if (matched)
+            {
+                g = next;
+                ++n;
+                continue;
+            }
+        }
+        if (starGlob == StringView::npos)
+        {
+            return false;
+        }
+        g = starGlob;
+        n = ++starName;
+    }
+
+    while (g < glob.size() && glob[g] == '*')
+    {
+        ++g;
+    }
+    return g == glob.size();
+}
+
+bool SymSeek::crawl(String const & directory, CrawlOptions const & options, FileHandler const & handler,
+    std::stop_token stopToken)
+{
+    return Crawl{ options, handler, std::move(stopToken) }.run(directory);
+}
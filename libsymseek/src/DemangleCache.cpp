@@ -0,0 +1,297 @@
+module;
+
+#include <symseek/Definitions.h>
+
+module symseek.demanglecache;
+
+import <array>;
+import <cstring>;
+import <mutex>;
+import <unordered_map>;
+import <vector>;
+
+import symseek.internal.helpers;
+import symseek.internal.interfaces.mappedfile;
+
+using namespace SymSeek;
+
+namespace
+{
+    // On-disk layout: header, entry records, demangled names back to back.
+    // Native byte order, like the symbol index.
+    constexpr char cacheMagic[8] = { 'S', 'Y', 'M', 'S', 'D', 'M', 'C', '\0' };
+    constexpr uint32_t cacheVersion = 1;
+
+    struct CacheHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t entriesCount;
+        uint64_t stringsSize;
+        uint64_t entriesOffset;
+        uint64_t stringsOffset;
+    };
+    static_assert(sizeof(CacheHeader) == 48);
+
+    struct EntryRecord
+    {
+        uint64_t hash;
+        uint32_t mangledLength;
+        uint32_t demangledLength;
+        uint64_t demangledOffset;
+    };
+    static_assert(sizeof(EntryRecord) == 24);
+
+    // The length tells apart most of the names colliding in the hash
+    struct Entry
+    {
+        uint64_t hash{};
+        uint32_t mangledLength{};
+        // Set by the hits, cleared by the clock hand passing by
+        bool referenced{};
+        std::string demangled;
+    };
+
+    // The entry, its slot in the map and the allocator headers, roughly
+    constexpr size_t entryOverhead = sizeof(Entry) + 4 * sizeof(void *);
+
+    size_t entryCost(std::string_view demangled) noexcept
+    {
+        return entryOverhead + demangled.size();
+    }
+
+    // Every shard is a CLOCK ring of its own, the shards are picked by the top bits of the hash
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, uint32_t> slots;
+        std::vector<Entry> entries;
+        size_t hand{};
+        size_t memoryUsage{};
+        uint64_t hits{};
+        uint64_t misses{};
+        uint64_t evictions{};
+        uint64_t insertions{};
+    };
+
+    constexpr size_t shardsCount = 16;
+}
+
+struct DemangleCache::Impl
+{
+    explicit Impl(size_t capacity)
+    : shardCapacity{ capacity / shardsCount }
+    {
+    }
+
+    static uint64_t hash(std::string_view mangled) noexcept
+    {
+        return detail::hashBytes(mangled.data(), mangled.size());
+    }
+
+    Shard & shardOf(uint64_t hash) noexcept
+    {
+        return shards[hash >> 60];
+    }
+
+    // Under the shard mutex
+    void evictOne(Shard & shard)
+    {
+        while (true)
+        {
+            if (shard.hand >= shard.entries.size())
+            {
+                shard.hand = 0;
+            }
+            Entry & victim = shard.entries[shard.hand];
+            if (victim.referenced)
+            {
+                victim.referenced = false;
+                ++shard.hand;
+                continue;
+            }
+
+            shard.memoryUsage -= entryCost(victim.demangled);
+            shard.slots.erase(victim.hash);
+            if (shard.hand + 1 != shard.entries.size())
+            {
+                // The last entry takes the slot, the hand checks it next
+                victim = std::move(shard.entries.back());
+                shard.slots[victim.hash] = static_cast<uint32_t>(shard.hand);
+            }
+            shard.entries.pop_back();
+            ++shard.evictions;
+            return;
+        }
+    }
+
+    void insert(uint64_t hash, uint32_t mangledLength, std::string_view demangled, bool loaded)
+    {
+        size_t const cost = entryCost(demangled);
+        if (cost > shardCapacity)
+        {
+            return;
+        }
+
+        Shard & shard = shardOf(hash);
+        std::lock_guard lock{ shard.mutex };
+        shard.insertions += !loaded;
+        if (auto found = shard.slots.find(hash); found != shard.slots.end())
+        {
+            // Another worker got there first, or the hash collided
+            Entry & entry = shard.entries[found->second];
+            shard.memoryUsage -= entryCost(entry.demangled);
+            entry.mangledLength = mangledLength;
+            entry.demangled.assign(demangled);
+            shard.memoryUsage += cost;
+            return;
+        }
+
+        while (shard.memoryUsage + cost > shardCapacity && !shard.entries.empty())
+        {
+            evictOne(shard);
+        }
+        shard.slots.emplace(hash, static_cast<uint32_t>(shard.entries.size()));
+        shard.entries.push_back(Entry{ .hash = hash, .mangledLength = mangledLength,
+            .demangled = std::string{ demangled } });
+        shard.memoryUsage += cost;
+    }
+
+    size_t const shardCapacity;
+    std::array<Shard, shardsCount> shards;
+};
+
+DemangleCache::DemangleCache(size_t capacity)
+: m_impl{ std::make_unique<Impl>(capacity) }
+{
+}
+
+DemangleCache::~DemangleCache() = default;
+
+bool DemangleCache::find(std::string_view mangled, std::string & demangled)
+{
+    uint64_t const hash = Impl::hash(mangled);
+    Shard & shard = m_impl->shardOf(hash);
+    std::lock_guard lock{ shard.mutex };
+    auto found = shard.slots.find(hash);
+    if (found == shard.slots.end() || shard.entries[found->second].mangledLength != mangled.size())
+    {
+        ++shard.misses;
+        return false;
+    }
+
+    Entry & entry = shard.entries[found->second];
+    entry.referenced = true;
+    demangled.assign(entry.demangled);
+    ++shard.hits;
+    return true;
+}
+
+void DemangleCache::insert(std::string_view mangled, std::string_view demangled)
+{
+    m_impl->insert(Impl::hash(mangled), static_cast<uint32_t>(mangled.size()), demangled, /*loaded=*/false);
+}
+
+DemangleCache::Stats DemangleCache::stats() const
+{
+    Stats result;
+    for (Shard & shard: m_impl->shards)
+    {
+        std::lock_guard lock{ shard.mutex };
+        result.hits += shard.hits;
+        result.misses += shard.misses;
+        result.evictions += shard.evictions;
+        result.insertions += shard.insertions;
+        result.entriesCount += shard.entries.size();
+        result.memoryUsage += shard.memoryUsage;
+    }
+    return result;
+}
+
+void DemangleCache::clear()
+{
+    for (Shard & shard: m_impl->shards)
+    {
+        std::lock_guard lock{ shard.mutex };
+        shard.slots.clear();
+        shard.entries.clear();
+        shard.hand = 0;
+        shard.memoryUsage = 0;
+    }
+}
+
+bool DemangleCache::load(String const & path)
+{
+    auto file = detail::createMappedFile(path);
+    if (!file || file->size() < sizeof(CacheHeader))
+    {
+        return false;
+    }
+    size_t const fileSize = file->size();
+    uint8_t const * bytes = file->map(/*offset=*/0, /*length=*/0, detail::MapMode::Populate);
+    if (!bytes)
+    {
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) || header.version != cacheVersion ||
+        header.entriesOffset > fileSize ||
+        header.entriesCount > (fileSize - header.entriesOffset) / sizeof(EntryRecord) ||
+        header.stringsOffset > fileSize || header.stringsSize > fileSize - header.stringsOffset)
+    {
+        return false;
+    }
+
+    auto const * strings = reinterpret_cast<char const *>(bytes + header.stringsOffset);
+    for (uint64_t i = 0; i < header.entriesCount; ++i)
+    {
+        EntryRecord record;
+        std::memcpy(&record, bytes + header.entriesOffset + i * sizeof(EntryRecord), sizeof(record));
+        if (record.demangledOffset > header.stringsSize ||
+            record.demangledLength > header.stringsSize - record.demangledOffset)
+        {
+            return false;
+        }
+        m_impl->insert(record.hash, record.mangledLength,
+            { strings + record.demangledOffset, record.demangledLength }, /*loaded=*/true);
+    }
+    return true;
+}
+
+bool DemangleCache::save(String const & path) const
+{
+    std::vector<EntryRecord> records;
+    std::string strings;
+    for (Shard & shard: m_impl->shards)
+    {
+        std::lock_guard lock{ shard.mutex };
+        records.reserve(records.size() + shard.entries.size());
+        for (Entry const & entry: shard.entries)
+        {
+            records.push_back(EntryRecord{
+                .hash = entry.hash,
+                .mangledLength = entry.mangledLength,
+                .demangledLength = static_cast<uint32_t>(entry.demangled.size()),
+                .demangledOffset = strings.size()
+            });
+            strings.append(entry.demangled);
+        }
+    }
+
+    CacheHeader header{};
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = cacheVersion;
+    header.entriesCount = records.size();
+    header.stringsSize = strings.size();
+    header.entriesOffset = sizeof(CacheHeader);
+    header.stringsOffset = header.entriesOffset + records.size() * sizeof(EntryRecord);
+
+    return detail::replaceFile(path, {
+        { reinterpret_cast<char const *>(&header), sizeof(header) },
+        { reinterpret_cast<char const *>(records.data()), records.size() * sizeof(EntryRecord) },
+        strings
+    });
+}
@@ -0,0 +1,101 @@
+module;
+
+#include <symseek/Definitions.h>
+
+module symseek.dispatcher;
+
+import <cstdint>;
+import <utility>;
+import <vector>;
+
+import symseek;
+
+using namespace SymSeek;
+
+namespace
+{
+    // The engines know the names the way the other platforms spell them
+    std::string_view engineName(Mangler mangler, std::string_view name) noexcept
+    {
+        if ((mangler == Mangler::GCC || mangler == Mangler::Rust) && name.starts_with("__"))
+        {
+            name.remove_prefix(1);
+        }
+        return name;
+    }
+
+    // Reused by the batches of the thread, the outputs lend their buffers to it and take them back
+    struct Group
+    {
+        std::vector<std::string_view> names;
+        std::vector<std::string> outputs;
+        std::vector<uint32_t> indices;
+
+        void clear()
+        {
+            names.clear();
+            indices.clear();
+        }
+    };
+}
+
+DemangleDispatcher::DemangleDispatcher()
+{
+    for (size_t i = 0; i < ManglersCount; ++i)
+    {
+        m_demanglers[i] = createDemangler(static_cast<Mangler>(i));
+    }
+}
+
+bool DemangleDispatcher::demangleInto(std::string_view name, std::string & output) const
+{
+    Mangler const mangler = detectMangler(name);
+    if (IDemangler const * engine = demangler(mangler))
+    {
+        return engine->demangleInto(engineName(mangler, name), output);
+    }
+    output.clear();
+    return false;
+}
+
+void DemangleDispatcher::demangleBatch(std::span<std::string_view const> names,
+    std::span<std::string> outputs) const
+{
+    thread_local std::array<Group, ManglersCount> groups;
+
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        Mangler const mangler = detectMangler(names[i]);
+        if (!demangler(mangler))
+        {
+            outputs[i].clear();
+            continue;
+        }
+
+        Group & group = groups[static_cast<size_t>(mangler)];
+        size_t const slot = group.names.size();
+        if (slot == group.outputs.size())
+        {
+            group.outputs.emplace_back();
+        }
+        group.names.push_back(engineName(mangler, names[i]));
+        group.indices.push_back(static_cast<uint32_t>(i));
+        std::swap(group.outputs[slot], outputs[i]);
+    }
+
+    for (size_t mangler = 0; mangler < ManglersCount; ++mangler)
+    {
+        Group & group = groups[mangler];
+        if (group.names.empty())
+        {
+            continue;
+        }
+
+        m_demanglers[mangler]->demangleBatch(group.names, { group.outputs.data(), group.names.size() });
+        for (size_t slot = 0; slot < group.indices.size(); ++slot)
+        {
+            std::swap(group.outputs[slot], outputs[group.indices[slot]]);
+        }
+        group.clear();
+    }
+}
@@ -0,0 +1,4178 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek:demanglers.gcc;
+
+import <cstddef>;
+import <cstdint>;
+import <span>;
+import <string>;
+import <string_view>;
+import <utility>;
+import <vector>;
+
+import symseek.interfaces.demangler;
+import symseek.internal.arena;
+
+export namespace SymSeek
+{
+    // Itanium C++ ABI names (GCC, Clang), printed the way __cxa_demangle of libstdc++ does.
+    // Doesn't depend on the host runtime, so the MinGW and Linux binaries are demangled on any platform.
+    class GCCDemangler : public IDemangler
+    {
+    public:
+        bool demangleInto(std::string_view name, std::string & output) const override;
+        void demangleBatch(std::span<std::string_view const> names, std::span<std::string> outputs) const override;
+    };
+}
+
+// Implementation
+
+using namespace SymSeek;
+
+namespace
+{
+    using detail::Arena;
+
+    class Node;
+    using NodeArray = std::span<Node * const>;
+
+    constexpr size_t NoPack = static_cast<size_t>(-1);
+
+    struct Printer
+    {
+        std::string & out;
+        // The element of the parameter packs printed by the innermost pack expansion
+        size_t packIndex = 0;
+        size_t packSize = NoPack;
+        // Guards the forward template references against the cycles of a malformed name
+        unsigned depth = 0;
+        // libiberty still sees the separator of an empty pack it has taken back, "A<B<int>> >"
+        bool separatorTakenBack = false;
+        // Within the signature of a lambda, where its template parameters are "auto"
+        bool lambdaParams = false;
+
+        char last() const noexcept
+        {
+            if (separatorTakenBack)
+            {
+                return ' ';
+            }
+            return out.empty() ? '\0' : out.back();
+        }
+
+        void takeBack(size_t size)
+        {
+            out.resize(size);
+            separatorTakenBack = true;
+        }
+
+        Printer & operator<<(std::string_view text)
+        {
+            separatorTakenBack = separatorTakenBack && text.empty();
+            out.append(text);
+            return *this;
+        }
+
+        Printer & operator<<(char c)
+        {
+            separatorTakenBack = false;
+            out.push_back(c);
+            return *this;
+        }
+    };
+
+    void printNumber(Printer & p, size_t number)
+    {
+        char digits[20];
+        size_t count = 0;
+        do
+        {
+            digits[count++] = static_cast<char>('0' + number % 10);
+            number /= 10;
+        }
+        while (number);
+        while (count)
+        {
+            p << digits[--count];
+        }
+    }
+
+    enum Qualifiers : uint8_t
+    {
+        QualNone     = 0,
+        QualConst    = 1,
+        QualVolatile = 2,
+        QualRestrict = 4,
+    };
+
+    enum class RefQualifier : uint8_t
+    {
+        None,
+        LValue,
+        RValue,
+    };
+
+    void printQualifiers(Printer & p, uint8_t qualifiers)
+    {
+        if (qualifiers & QualConst)
+        {
+            p << " const";
+        }
+        if (qualifiers & QualVolatile)
+        {
+            p << " volatile";
+        }
+        if (qualifiers & QualRestrict)
+        {
+            p << " restrict";
+        }
+    }
+
+    void printRefQualifier(Printer & p, RefQualifier qualifier)
+    {
+        if (qualifier == RefQualifier::LValue)
+        {
+            p << " &";
+        }
+        else if (qualifier == RefQualifier::RValue)
+        {
+            p << " &&";
+        }
+    }
+
+    // The types are printed in two parts around the declarator,
+    // e.g. "void (*" and ")(int)" of a function pointer. Every node lives in the arena.
+    class Node
+    {
+    public:
+        enum class Kind : uint8_t
+        {
+            Name,
+            Nested,
+            SpecialSubstitution,
+            NameWithTemplateArgs,
+            Qualified,
+            Pointer,
+            Reference,
+            Array,
+            Function,
+            Encoding,
+            ParameterPack,
+            TemplateArgumentPack,
+            ForwardReference,
+            Literal,
+            Expression,
+            Other,
+        };
+
+        explicit Node(Kind kind) noexcept : m_kind{ kind } {}
+
+        Kind kind() const noexcept
+        {
+            return m_kind;
+        }
+
+        virtual bool hasRight(Printer &) const { return false; }
+        virtual bool hasArray(Printer &) const { return false; }
+        virtual bool hasFunction(Printer &) const { return false; }
+
+        // The node a pack or a forward reference stands for, the node itself otherwise
+        virtual Node const * resolve(Printer &) const { return this; }
+
+        // The name of a class, which its constructors and destructor are named after
+        virtual std::string_view baseName() const { return {}; }
+
+        // Printed without parentheses as an operand
+        virtual bool isSimpleExpression() const { return false; }
+
+        virtual void printLeft(Printer & p) const = 0;
+        virtual void printRight(Printer &) const {}
+
+        void print(Printer & p) const
+        {
+            printLeft(p);
+            if (hasRight(p))
+            {
+                printRight(p);
+            }
+        }
+
+    private:
+        Kind m_kind;
+    };
+
+    // Prints the nodes separated. As in libiberty, only the separators of the empty packs
+    // ending the list are taken back, "A<, int>" stays for an empty leading one
+    void printList(Printer & p, NodeArray nodes, std::string_view separator = ", ")
+    {
+        size_t printedEnd = p.out.size();
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            if (i)
+            {
+                p << separator;
+            }
+            size_t const nodeStart = p.out.size();
+            nodes[i]->print(p);
+            if (p.out.size() != nodeStart)
+            {
+                printedEnd = p.out.size();
+            }
+        }
+        if (p.out.size() != printedEnd)
+        {
+            p.takeBack(printedEnd);
+        }
+    }
+
+    // Operand of an expression, the names stay unparenthesized
+    void printOperand(Printer & p, Node const * node)
+    {
+        bool const simple = node->isSimpleExpression();
+        if (!simple)
+        {
+            p << '(';
+        }
+        node->print(p);
+        if (!simple)
+        {
+            p << ')';
+        }
+    }
+
+    class NameNode : public Node
+    {
+    public:
+        explicit NameNode(std::string_view name) noexcept : Node{ Kind::Name }, m_name{ name } {}
+
+        std::string_view baseName() const override { return m_name; }
+        bool isSimpleExpression() const override { return true; }
+
+        void printLeft(Printer & p) const override
+        {
+            p << m_name;
+        }
+
+    private:
+        std::string_view m_name;
+    };
+
+    class NestedName : public Node
+    {
+    public:
+        NestedName(Node const * qualifier, Node const * name) noexcept
+        : Node{ Kind::Nested }, m_qualifier{ qualifier }, m_name{ name } {}
+
+        std::string_view baseName() const override { return m_name->baseName(); }
+        bool isSimpleExpression() const override { return true; }
+
+        void printLeft(Printer & p) const override
+        {
+            m_qualifier->print(p);
+            p << "::";
+            m_name->print(p);
+        }
+
+    private:
+        Node const * m_qualifier;
+        Node const * m_name;
+    };
+
+    class LocalName : public Node
+    {
+    public:
+        LocalName(Node const * encoding, Node const * entity) noexcept
+        : Node{ Kind::Other }, m_encoding{ encoding }, m_entity{ entity } {}
+
+        std::string_view baseName() const override { return m_entity->baseName(); }
+
+        void printLeft(Printer & p) const override;
+
+    private:
+        Node const * m_encoding;
+        Node const * m_entity;
+    };
+
+    // Sa, Sb, Ss, Si, So and Sd
+    class SpecialSubstitution : public Node
+    {
+    public:
+        SpecialSubstitution(std::string_view name, std::string_view base, std::string_view expanded) noexcept
+        : Node{ Kind::SpecialSubstitution }, m_name{ name }, m_base{ base }, m_expanded{ expanded } {}
+
+        // The constructors and destructors are printed as the members of the full template name
+        SpecialSubstitution * expand(Arena & arena) const
+        {
+            return arena.make<SpecialSubstitution>(m_expanded, m_base, m_expanded);
+        }
+
+        std::string_view baseName() const override { return m_base; }
+        bool isSimpleExpression() const override { return true; }
+
+        void printLeft(Printer & p) const override
+        {
+            p << m_name;
+        }
+
+    private:
+        std::string_view m_name;
+        std::string_view m_base;
+        std::string_view m_expanded;
+    };
+
+    class AbiTaggedName : public Node
+    {
+    public:
+        AbiTaggedName(Node const * name, std::string_view tag) noexcept
+        : Node{ Kind::Other }, m_name{ name }, m_tag{ tag } {}
+
+        std::string_view baseName() const override { return m_name->baseName(); }
+
+        void printLeft(Printer & p) const override
+        {
+            m_name->print(p);
+            p << "[abi:" << m_tag << ']';
+        }
+
+    private:
+        Node const * m_name;
+        std::string_view m_tag;
+    };
+
+    class TemplateArgs : public Node
+    {
+    public:
+        explicit TemplateArgs(NodeArray args) noexcept : Node{ Kind::Other }, m_args{ args } {}
+
+        NodeArray args() const noexcept
+        {
+            return m_args;
+        }
+
+        void printLeft(Printer & p) const override
+        {
+            // "operator< <int>" and "A<B<int> >"
+            if (p.last() == '<')
+            {
+                p << ' ';
+            }
+            p << '<';
+            printList(p, m_args);
+            if (p.last() == '>')
+            {
+                p << ' ';
+            }
+            p << '>';
+        }
+
+    private:
+        NodeArray m_args;
+    };
+
+    class NameWithTemplateArgs : public Node
+    {
+    public:
+        NameWithTemplateArgs(Node const * name, Node const * args) noexcept
+        : Node{ Kind::NameWithTemplateArgs }, m_name{ name }, m_args{ args } {}
+
+        std::string_view baseName() const override { return m_name->baseName(); }
+
+        void printLeft(Printer & p) const override
+        {
+            m_name->print(p);
+            m_args->print(p);
+        }
+
+    private:
+        Node const * m_name;
+        Node const * m_args;
+    };
+
+    class CtorDtorName : public Node
+    {
+    public:
+        CtorDtorName(std::string_view name, bool destructor) noexcept
+        : Node{ Kind::Other }, m_name{ name }, m_destructor{ destructor } {}
+
+        std::string_view baseName() const override { return m_name; }
+
+        void printLeft(Printer & p) const override
+        {
+            if (m_destructor)
+            {
+                p << '~';
+            }
+            p << m_name;
+        }
+
+    private:
+        std::string_view m_name;
+        bool m_destructor;
+    };
+
+    class OperatorName : public Node
+    {
+    public:
+        explicit OperatorName(std::string_view symbol) noexcept : Node{ Kind::Other }, m_symbol{ symbol } {}
+
+        bool isSimpleExpression() const override { return true; }
+
+        void printLeft(Printer & p) const override
+        {
+            p << "operator";
+            if (!m_symbol.empty() && m_symbol.front() >= 'a' && m_symbol.front() <= 'z')
+            {
+                p << ' ';
+            }
+            p << m_symbol;
+        }
+
+    private:
+        std::string_view m_symbol;
+    };
+
+    class ConversionOperatorName : public Node
+    {
+    public:
+        explicit ConversionOperatorName(Node const * type) noexcept : Node{ Kind::Other }, m_type{ type } {}
+
+        bool isSimpleExpression() const override { return true; }
+
+        void printLeft(Printer & p) const override
+        {
+            p << "operator ";
+            m_type->print(p);
+        }
+
+    private:
+        Node const * m_type;
+    };
+
+    class LiteralOperatorName : public Node
+    {
+    public:
+        explicit LiteralOperatorName(std::string_view suffix) noexcept : Node{ Kind::Other }, m_suffix{ suffix } {}
+
+        void printLeft(Printer & p) const override
+        {
+            p << "operator\"\" " << m_suffix;
+        }
+
+    private:
+        std::string_view m_suffix;
+    };
+
+    // "{lambda(int)#1}" and "{unnamed type#1}", the number is 1-based
+    class UnnamedTypeName : public Node
+    {
+    public:
+        UnnamedTypeName(size_t number, NodeArray lambdaParams, bool lambda) noexcept
+        : Node{ Kind::Other }, m_number{ number }, m_params{ lambdaParams }, m_lambda{ lambda } {}
+
+        void printLeft(Printer & p) const override
+        {
+            if (m_lambda)
+            {
+                bool const lambdaParams = std::exchange(p.lambdaParams, true);
+                p << "{lambda(";
+                printList(p, m_params);
+                p << ")#";
+                p.lambdaParams = lambdaParams;
+            }
+            else
+            {
+                p << "{unnamed type#";
+            }
+            printNumber(p, m_number);
+            p << '}';
+        }
+
+    private:
+        size_t m_number;
+        NodeArray m_params;
+        bool m_lambda;
+    };
+
+    // The scope of the entities of a default argument of a function, "{default arg#1}"
+    class DefaultArgName : public Node
+    {
+    public:
+        explicit DefaultArgName(size_t number) noexcept : Node{ Kind::Other }, m_number{ number } {}
+
+        void printLeft(Printer & p) const override
+        {
+            p << "{default arg#";
+            printNumber(p, m_number);
+            p << '}';
+        }
+
+    private:
+        size_t m_number;
+    };
+
+    class StructuredBindingName : public Node
+    {
+    public:
+        explicit StructuredBindingName(NodeArray names) noexcept : Node{ Kind::Other }, m_names{ names } {}
+
+        void printLeft(Printer & p) const override
+        {
+            p << '[';
+            printList(p, m_names);
+            p << ']';
+        }
+
+    private:
+        NodeArray m_names;
+    };
+
+    class QualifiedType : public Node
+    {
+    public:
+        QualifiedType(Node const * child, uint8_t qualifiers) noexcept
+        : Node{ Kind::Qualified }, m_child{ child }, m_qualifiers{ qualifiers } {}
+
+        bool hasRight(Printer & p) const override { return m_child->hasRight(p); }
+        bool hasArray(Printer & p) const override { return m_child->hasArray(p); }
+        bool hasFunction(Printer & p) const override { return m_child->hasFunction(p); }
+
+        void printLeft(Printer & p) const override
+        {
+            // "char const" for K T_ with T_ = "char const", the qualifier isn't repeated
+            Node const * child = m_child->resolve(p);
+            if (child->kind() == Kind::Qualified)
+            {
+                auto const * qualified = static_cast<QualifiedType const *>(child);
+                qualified->m_child->printLeft(p);
+                printQualifiers(p, qualified->m_qualifiers & ~m_qualifiers);
+            }
+            else
+            {
+                m_child->printLeft(p);
+            }
+            printQualifiers(p, m_qualifiers);
+        }
+
+        void printRight(Printer & p) const override
+        {
+            m_child->printRight(p);
+        }
+
+    private:
+        Node const * m_child;
+        uint8_t m_qualifiers;
+    };
+
+    // "int foo" for U3foo, including "int __vector" of the old AltiVec mangling
+    class VendorQualifiedType : public Node
+    {
+    public:
+        VendorQualifiedType(Node const * child, std::string_view qualifier, Node const * args) noexcept
+        : Node{ Kind::Other }, m_child{ child }, m_qualifier{ qualifier }, m_args{ args } {}
+
+        void printLeft(Printer & p) const override
+        {
+            m_child->print(p);
+            p << ' ' << m_qualifier;
+            if (m_args)
+            {
+                m_args->print(p);
+            }
+        }
+
+    private:
+        Node const * m_child;
+        std::string_view m_qualifier;
+        Node const * m_args;
+    };
+
+    // "_Complex" and "_Imaginary"
+    class PostfixQualifiedType : public Node
+    {
+    public:
+        PostfixQualifiedType(Node const * child, std::string_view postfix) noexcept
+        : Node{ Kind::Other }, m_child{ child }, m_postfix{ postfix } {}
+
+        void printLeft(Printer & p) const override
+        {
+            m_child->print(p);
+            p << m_postfix;
+        }
+
+    private:
+        Node const * m_child;
+        std::string_view m_postfix;
+    };
+
+    class PointerType : public Node
+    {
+    public:
+        explicit PointerType(Node const * pointee) noexcept : Node{ Kind::Pointer }, m_pointee{ pointee } {}
+
+        bool hasRight(Printer & p) const override { return m_pointee->hasRight(p); }
+
+        void printLeft(Printer & p) const override
+        {
+            m_pointee->printLeft(p);
+            if (m_pointee->hasArray(p))
+            {
+                p << ' ';
+            }
+            if (m_pointee->hasArray(p) || m_pointee->hasFunction(p))
+            {
+                p << '(';
+            }
+            p << '*';
+        }
+
+        void printRight(Printer & p) const override
+        {
+            if (m_pointee->hasArray(p) || m_pointee->hasFunction(p))
+            {
+                p << ')';
+            }
+            m_pointee->printRight(p);
+        }
+
+    private:
+        Node const * m_pointee;
+    };
+
+    class ReferenceType : public Node
+    {
+    public:
+        ReferenceType(Node const * pointee, bool rvalue) noexcept
+        : Node{ Kind::Reference }, m_pointee{ pointee }, m_rvalue{ rvalue } {}
+
+        bool hasRight(Printer & p) const override { return collapse(p).pointee->hasRight(p); }
+
+        void printLeft(Printer & p) const override
+        {
+            Collapsed const collapsed = collapse(p);
+            collapsed.pointee->printLeft(p);
+            if (collapsed.pointee->hasArray(p))
+            {
+                p << ' ';
+            }
+            if (collapsed.pointee->hasArray(p) || collapsed.pointee->hasFunction(p))
+            {
+                p << '(';
+            }
+            p << (collapsed.rvalue ? "&&" : "&");
+        }
+
+        void printRight(Printer & p) const override
+        {
+            Collapsed const collapsed = collapse(p);
+            if (collapsed.pointee->hasArray(p) || collapsed.pointee->hasFunction(p))
+            {
+                p << ')';
+            }
+            collapsed.pointee->printRight(p);
+        }
+
+    private:
+        struct Collapsed
+        {
+            Node const * pointee;
+            bool rvalue;
+        };
+
+        // A reference to a reference substituted for a template parameter,
+        // "T&&" with T = int& is int&
+        Collapsed collapse(Printer & p) const
+        {
+            Collapsed result{ m_pointee->resolve(p), m_rvalue };
+            for (unsigned steps = 0; result.pointee->kind() == Kind::Reference && steps < 64; ++steps)
+            {
+                auto const * reference = static_cast<ReferenceType const *>(result.pointee);
+                result.rvalue = result.rvalue && reference->m_rvalue;
+                result.pointee = reference->m_pointee->resolve(p);
+            }
+            return result;
+        }
+
+        Node const * m_pointee;
+        bool m_rvalue;
+    };
+
+    class PointerToMemberType : public Node
+    {
+    public:
+        PointerToMemberType(Node const * classType, Node const * memberType) noexcept
+        : Node{ Kind::Other }, m_class{ classType }, m_member{ memberType } {}
+
+        bool hasRight(Printer & p) const override { return m_member->hasRight(p); }
+
+        void printLeft(Printer & p) const override
+        {
+            m_member->printLeft(p);
+            if (m_member->hasArray(p) || m_member->hasFunction(p))
+            {
+                p << '(';
+            }
+            else
+            {
+                p << ' ';
+            }
+            m_class->print(p);
+            p << "::*";
+        }
+
+        void printRight(Printer & p) const override
+        {
+            if (m_member->hasArray(p) || m_member->hasFunction(p))
+            {
+                p << ')';
+            }
+            m_member->printRight(p);
+        }
+
+    private:
+        Node const * m_class;
+        Node const * m_member;
+    };
+
+    class ArrayType : public Node
+    {
+    public:
+        ArrayType(Node const * element, Node const * dimension) noexcept
+        : Node{ Kind::Array }, m_element{ element }, m_dimension{ dimension } {}
+
+        bool hasRight(Printer &) const override { return true; }
+        bool hasArray(Printer &) const override { return true; }
+
+        void printLeft(Printer & p) const override
+        {
+            m_element->printLeft(p);
+        }
+
+        void printRight(Printer & p) const override
+        {
+            if (p.last() != ']')
+            {
+                p << ' ';
+            }
+            p << '[';
+            if (m_dimension)
+            {
+                m_dimension->print(p);
+            }
+            p << ']';
+            m_element->printRight(p);
+        }
+
+    private:
+        Node const * m_element;
+        Node const * m_dimension;
+    };
+
+    class VectorType : public Node
+    {
+    public:
+        VectorType(Node const * element, Node const * dimension) noexcept
+        : Node{ Kind::Other }, m_element{ element }, m_dimension{ dimension } {}
+
+        void printLeft(Printer & p) const override
+        {
+            m_element->print(p);
+            p << " __vector(";
+            if (m_dimension)
+            {
+                m_dimension->print(p);
+            }
+            p << ')';
+        }
+
+    private:
+        Node const * m_element;
+        Node const * m_dimension;
+    };
+
+    struct FunctionTraits
+    {
+        uint8_t qualifiers = QualNone;
+        RefQualifier refQualifier = RefQualifier::None;
+        // noexcept, noexcept(expr) or throw(types), printed after the qualifiers
+        Node const * exceptionSpec = nullptr;
+    };
+
+    void printFunctionTraits(Printer & p, FunctionTraits const & traits)
+    {
+        printQualifiers(p, traits.qualifiers);
+        printRefQualifier(p, traits.refQualifier);
+        if (traits.exceptionSpec)
+        {
+            p << ' ';
+            traits.exceptionSpec->print(p);
+        }
+    }
+
+    class FunctionType : public Node
+    {
+    public:
+        FunctionType(Node const * returnType, NodeArray params, FunctionTraits traits) noexcept
+        : Node{ Kind::Function }, m_return{ returnType }, m_params{ params }, m_traits{ traits } {}
+
+        void qualify(uint8_t qualifiers) noexcept
+        {
+            m_traits.qualifiers |= qualifiers;
+        }
+
+        bool hasRight(Printer &) const override { return true; }
+        bool hasFunction(Printer &) const override { return true; }
+
+        void printLeft(Printer & p) const override
+        {
+            m_return->printLeft(p);
+            // "void (*(int))()" for a function returning a function pointer
+            if (!m_return->hasRight(p))
+            {
+                p << ' ';
+            }
+        }
+
+        void printRight(Printer & p) const override
+        {
+            p << '(';
+            printList(p, m_params);
+            p << ')';
+            m_return->printRight(p);
+            printFunctionTraits(p, m_traits);
+        }
+
+    private:
+        Node const * m_return;
+        NodeArray m_params;
+        FunctionTraits m_traits;
+    };
+
+    class FunctionEncoding : public Node
+    {
+    public:
+        FunctionEncoding(Node const * returnType, Node const * name, NodeArray params, FunctionTraits traits) noexcept
+        : Node{ Kind::Encoding }, m_return{ returnType }, m_name{ name }, m_params{ params }, m_traits{ traits } {}
+
+        Node const * returnType() const noexcept
+        {
+            return m_return;
+        }
+
+        Node const * name() const noexcept
+        {
+            return m_name;
+        }
+
+        FunctionTraits const & traits() const noexcept
+        {
+            return m_traits;
+        }
+
+        bool hasRight(Printer &) const override { return true; }
+        bool hasFunction(Printer &) const override { return true; }
+
+        std::string_view baseName() const override { return m_name->baseName(); }
+
+        void printLeft(Printer & p) const override
+        {
+            if (m_return)
+            {
+                m_return->printLeft(p);
+                if (!m_return->hasRight(p))
+                {
+                    p << ' ';
+                }
+            }
+            m_name->print(p);
+        }
+
+        void printRight(Printer & p) const override
+        {
+            printSignature(p, /*withReturn=*/true);
+        }
+
+        // The scope of a local entity is printed without its return type
+        void printAsScope(Printer & p) const
+        {
+            m_name->print(p);
+            printSignature(p, /*withReturn=*/false);
+        }
+
+    private:
+        void printSignature(Printer & p, bool withReturn) const
+        {
+            p << '(';
+            printList(p, m_params);
+            p << ')';
+            if (withReturn && m_return)
+            {
+                m_return->printRight(p);
+            }
+            printFunctionTraits(p, m_traits);
+        }
+
+        Node const * m_return;
+        Node const * m_name;
+        NodeArray m_params;
+        FunctionTraits m_traits;
+    };
+
+    void LocalName::printLeft(Printer & p) const
+    {
+        if (m_encoding->kind() == Kind::Encoding)
+        {
+            static_cast<FunctionEncoding const *>(m_encoding)->printAsScope(p);
+        }
+        else
+        {
+            m_encoding->print(p);
+        }
+        p << "::";
+        m_entity->print(p);
+    }
+
+    // "vtable for A", "guard variable for x" and so on
+    class SpecialName : public Node
+    {
+    public:
+        SpecialName(std::string_view prefix, Node const * child) noexcept
+        : Node{ Kind::Other }, m_prefix{ prefix }, m_child{ child } {}
+
+        void printLeft(Printer & p) const override
+        {
+            p << m_prefix;
+            m_child->print(p);
+        }
+
+    private:
+        std::string_view m_prefix;
+        Node const * m_child;
+    };
+
+    class ConstructionVtableName : public Node
+    {
+    public:
+        ConstructionVtableName(Node const * derived, Node const * base) noexcept
+        : Node{ Kind::Other }, m_derived{ derived }, m_base{ base } {}
+
+        void printLeft(Printer & p) const override
+        {
+            p << "construction vtable for ";
+            m_base->print(p);
+            p << "-in-";
+            m_derived->print(p);
+        }
+
+    private:
+        Node const * m_derived;
+        Node const * m_base;
+    };
+
+    class ReferenceTemporaryName : public Node
+    {
+    public:
+        ReferenceTemporaryName(Node const * name, size_t number) noexcept
+        : Node{ Kind::Other }, m_name{ name }, m_number{ number } {}
+
+        void printLeft(Printer & p) const override
+        {
+            p << "reference temporary #";
+            printNumber(p, m_number);
+            p << " for ";
+            m_name->print(p);
+        }
+
+    private:
+        Node const * m_name;
+        size_t m_number;
+    };
+
+    class ClonedName : public Node
+    {
+    public:
+        ClonedName(Node const * name, std::string_view suffix) noexcept
+        : Node{ Kind::Other }, m_name{ name }, m_suffix{ suffix } {}
+
+        void printLeft(Printer & p) const override
+        {
+            m_name->print(p);
+            p << " [clone " << m_suffix << ']';
+        }
+
+    private:
+        Node const * m_name;
+        std::string_view m_suffix;
+    };
+
+    // What a template parameter referring to a pack stands for, printed an element at a time
+    class ParameterPack : public Node
+    {
+    public:
+        explicit ParameterPack(NodeArray elements) noexcept : Node{ Kind::ParameterPack }, m_elements{ elements } {}
+
+        size_t size() const noexcept
+        {
+            return m_elements.size();
+        }
+
+        bool hasRight(Printer & p) const override { return current(p) && current(p)->hasRight(p); }
+        bool hasArray(Printer & p) const override { return current(p) && current(p)->hasArray(p); }
+        bool hasFunction(Printer & p) const override { return current(p) && current(p)->hasFunction(p); }
+
+        Node const * resolve(Printer & p) const override
+        {
+            Node const * element = current(p);
+            return element ? element->resolve(p) : this;
+        }
+
+        void printLeft(Printer & p) const override
+        {
+            if (Node const * element = current(p))
+            {
+                element->printLeft(p);
+            }
+        }
+
+        void printRight(Printer & p) const override
+        {
+            if (Node const * element = current(p))
+            {
+                element->printRight(p);
+            }
+        }
+
+    private:
+        // The first pack met by an expansion defines its size
+        Node const * current(Printer & p) const
+        {
+            if (p.packSize == NoPack)
+            {
+                p.packSize = m_elements.size();
+            }
+            return p.packIndex < m_elements.size() ? m_elements[p.packIndex] : nullptr;
+        }
+
+        NodeArray m_elements;
+    };
+
+    // J...E, the arguments of a variadic template
+    class TemplateArgumentPack : public Node
+    {
+    public:
+        explicit TemplateArgumentPack(NodeArray elements) noexcept
+        : Node{ Kind::TemplateArgumentPack }, m_elements{ elements } {}
+
+        NodeArray elements() const noexcept
+        {
+            return m_elements;
+        }
+
+        void printLeft(Printer & p) const override
+        {
+            printList(p, m_elements);
+        }
+
+    private:
+        NodeArray m_elements;
+    };
+
+    class PackExpansion : public Node
+    {
+    public:
+        explicit PackExpansion(Node const * pattern) noexcept : Node{ Kind::Other }, m_pattern{ pattern } {}
+
+        void printLeft(Printer & p) const override
+        {
+            size_t const savedIndex = p.packIndex;
+            size_t const savedSize = p.packSize;
+            p.packIndex = 0;
+            p.packSize = NoPack;
+
+            size_t const start = p.out.size();
+            m_pattern->print(p);
+            if (p.packSize == NoPack)
+            {
+                // Only the function parameter packs are involved
+                p.out.resize(start);
+                printOperand(p, m_pattern);
+                p << "...";
+            }
+            else if (p.packSize == 0)
+            {
+                p.out.resize(start);
+            }
+            else
+            {
+                for (size_t i = 1, size = p.packSize; i < size; ++i)
+                {
+                    p << ", ";
+                    p.packIndex = i;
+                    m_pattern->print(p);
+                }
+            }
+
+            p.packIndex = savedIndex;
+            p.packSize = savedSize;
+        }
+
+    private:
+        Node const * m_pattern;
+    };
+
+    // A template parameter of a conversion operator used before the template arguments are parsed
+    class ForwardTemplateReference : public Node
+    {
+    public:
+        explicit ForwardTemplateReference(size_t index) noexcept : Node{ Kind::ForwardReference }, m_index{ index } {}
+
+        size_t index() const noexcept
+        {
+            return m_index;
+        }
+
+        void resolveTo(Node const * target) noexcept
+        {
+            m_target = target;
+        }
+
+        bool resolved() const noexcept
+        {
+            return m_target;
+        }
+
+        bool hasRight(Printer & p) const override { return guarded(p, [&p](Node const * n) { return n->hasRight(p); }); }
+        bool hasArray(Printer & p) const override { return guarded(p, [&p](Node const * n) { return n->hasArray(p); }); }
+        bool hasFunction(Printer & p) const override { return guarded(p, [&p](Node const * n) { return n->hasFunction(p); }); }
+
+        Node const * resolve(Printer & p) const override
+        {
+            return m_target && p.depth < MaxDepth ? m_target->resolve(p) : this;
+        }
+
+        void printLeft(Printer & p) const override
+        {
+            guarded(p, [&p](Node const * n) { n->printLeft(p); return true; });
+        }
+
+        void printRight(Printer & p) const override
+        {
+            guarded(p, [&p](Node const * n) { n->printRight(p); return true; });
+        }
+
+    private:
+        static constexpr unsigned MaxDepth = 32;
+
+        template<typename Callback>
+        bool guarded(Printer & p, Callback && callback) const
+        {
+            if (!m_target || p.depth >= MaxDepth)
+            {
+                return false;
+            }
+            ++p.depth;
+            bool const result = callback(m_target);
+            --p.depth;
+            return result;
+        }
+
+        size_t m_index;
+        Node const * m_target = nullptr;
+    };
+
+    // "auto:1" in the signature of a generic lambda, the argument of its call operator elsewhere
+    class AutoParamName : public Node
+    {
+    public:
+        AutoParamName(size_t number, ForwardTemplateReference const * argument) noexcept
+        : Node{ Kind::Other }, m_number{ number }, m_argument{ argument } {}
+
+        bool hasRight(Printer & p) const override { return !isAuto(p) && m_argument->hasRight(p); }
+        bool hasArray(Printer & p) const override { return !isAuto(p) && m_argument->hasArray(p); }
+        bool hasFunction(Printer & p) const override { return !isAuto(p) && m_argument->hasFunction(p); }
+
+        void printLeft(Printer & p) const override
+        {
+            if (!isAuto(p))
+            {
+                m_argument->printLeft(p);
+                return;
+            }
+            p << "auto:";
+            printNumber(p, m_number);
+        }
+
+        void printRight(Printer & p) const override
+        {
+            if (!isAuto(p))
+            {
+                m_argument->printRight(p);
+            }
+        }
+
+    private:
+        bool isAuto(Printer const & p) const noexcept
+        {
+            return p.lambdaParams || !m_argument->resolved();
+        }
+
+        size_t m_number;
+        ForwardTemplateReference const * m_argument;
+    };
+
+    // Expressions, parenthesized the way libiberty does it
+
+    class BinaryExpression : public Node
+    {
+    public:
+        BinaryExpression(Node const * left, std::string_view op, Node const * right) noexcept
+        : Node{ Kind::Expression }, m_left{ left }, m_op{ op }, m_right{ right } {}
+
+        void printLeft(Printer & p) const override
+        {
+            // Keeps "a>b" from closing a template argument list
+            bool const greater = m_op == ">";
+            if (greater)
+            {
+                p << '(';
+            }
+            printOperand(p, m_left);
+            p << m_op;
+            printOperand(p, m_right);
+            if (greater)
+            {
+                p << ')';
+            }
+        }
+
+    private:
+        Node const * m_left;
+        std::string_view m_op;
+        Node const * m_right;
+    };
+
+    // "a.b", "a->b" and "a[b]", the member is printed as is
+    class MemberExpression : public Node
+    {
+    public:
+        MemberExpression(Node const * object, std::string_view op, Node const * member, std::string_view close = {}) noexcept
+        : Node{ Kind::Expression }, m_object{ object }, m_op{ op }, m_member{ member }, m_close{ close } {}
+
+        void printLeft(Printer & p) const override
+        {
+            printOperand(p, m_object);
+            p << m_op;
+            m_member->print(p);
+            p << m_close;
+        }
+
+    private:
+        Node const * m_object;
+        std::string_view m_op;
+        Node const * m_member;
+        std::string_view m_close;
+    };
+
+    class PrefixExpression : public Node
+    {
+    public:
+        PrefixExpression(std::string_view op, Node const * operand) noexcept
+        : Node{ Kind::Expression }, m_op{ op }, m_operand{ operand } {}
+
+        void printLeft(Printer & p) const override
+        {
+            p << m_op;
+            printOperand(p, m_operand);
+        }
+
+    private:
+        std::string_view m_op;
+        Node const * m_operand;
+    };
+
+    class PostfixExpression : public Node
+    {
+    public:
+        PostfixExpression(Node const * operand, std::string_view op) noexcept
+        : Node{ Kind::Expression }, m_operand{ operand }, m_op{ op } {}
+
+        void printLeft(Printer & p) const override
+        {
+            printOperand(p, m_operand);
+            p << m_op;
+        }
+
+    private:
+        Node const * m_operand;
+        std::string_view m_op;
+    };
+
+    class ConditionalExpression : public Node
+    {
+    public:
+        ConditionalExpression(Node const * condition, Node const * then, Node const * otherwise) noexcept
+        : Node{ Kind::Expression }, m_condition{ condition }, m_then{ then }, m_otherwise{ otherwise } {}
+
+        void printLeft(Printer & p) const override
+        {
+            printOperand(p, m_condition);
+            p << '?';
+            printOperand(p, m_then);
+            p << " : ";
+            printOperand(p, m_otherwise);
+        }
+
+    private:
+        Node const * m_condition;
+        Node const * m_then;
+        Node const * m_otherwise;
+    };
+
+    // "prefix" child "postfix" with the child printed as is, e.g. "decltype (" x ")" or "sizeof (" T ")"
+    class EnclosingExpression : public Node
+    {
+    public:
+        EnclosingExpression(std::string_view prefix, Node const * child, std::string_view postfix) noexcept
+        : Node{ Kind::Expression }, m_prefix{ prefix }, m_child{ child }, m_postfix{ postfix } {}
+
+        void printLeft(Printer & p) const override
+        {
+            p << m_prefix;
+            if (m_child)
+            {
+                m_child->print(p);
+            }
+            p << m_postfix;
+        }
+
+    private:
+        std::string_view m_prefix;
+        Node const * m_child;
+        std::string_view m_postfix;
+    };
+
+    class CallExpression : public Node
+    {
+    public:
+        CallExpression(Node const * callee, NodeArray args) noexcept
+        : Node{ Kind::Expression }, m_callee{ callee }, m_args{ args } {}
+
+        void printLeft(Printer & p) const override
+        {
+            // The signature of a called function is left out
+            Node const * callee = m_callee;
+            if (callee->kind() == Kind::Encoding)
+            {
+                callee = static_cast<FunctionEncoding const *>(callee)->name();
+            }
+            printOperand(p, callee);
+            p << '(';
+            printList(p, m_args);
+            p << ')';
+        }
+
+    private:
+        Node const * m_callee;
+        NodeArray m_args;
+    };
+
+    // "static_cast<int>(x)" and the like
+    class NamedCastExpression : public Node
+    {
+    public:
+        NamedCastExpression(std::string_view cast, Node const * type, Node const * operand) noexcept
+        : Node{ Kind::Expression }, m_cast{ cast }, m_type{ type }, m_operand{ operand } {}
+
+        void printLeft(Printer & p) const override
+        {
+            p << m_cast << '<';
+            m_type->print(p);
+            if (p.last() == '>')
+            {
+                p << ' ';
+            }
+            p << ">(";
+            m_operand->print(p);
+            p << ')';
+        }
+
+    private:
+        std::string_view m_cast;
+        Node const * m_type;
+        Node const * m_operand;
+    };
+
+    // "(int)x", a conversion with several arguments is "(T)(a, b)"
+    class ConversionExpression : public Node
+    {
+    public:
+        ConversionExpression(Node const * type, NodeArray args, bool list) noexcept
+        : Node{ Kind::Expression }, m_type{ type }, m_args{ args }, m_list{ list } {}
+
+        void printLeft(Printer & p) const override
+        {
+            p << '(';
+            m_type->print(p);
+            p << ')';
+            if (!m_list && m_args.size() == 1)
+            {
+                printOperand(p, m_args.front());
+                return;
+            }
+            p << '(';
+            printList(p, m_args);
+            p << ')';
+        }
+
+    private:
+        Node const * m_type;
+        NodeArray m_args;
+        bool m_list;
+    };
+
+    // "T{a, b}" and "{a, b}"
+    class InitListExpression : public Node
+    {
+    public:
+        InitListExpression(Node const * type, NodeArray inits) noexcept
+        : Node{ Kind::Expression }, m_type{ type }, m_inits{ inits } {}
+
+        bool isSimpleExpression() const override { return true; }
+
+        void printLeft(Printer & p) const override
+        {
+            if (m_type)
+            {
+                m_type->print(p);
+            }
+            p << '{';
+            printList(p, m_inits);
+            p << '}';
+        }
+
+    private:
+        Node const * m_type;
+        NodeArray m_inits;
+    };
+
+    class NewExpression : public Node
+    {
+    public:
+        NewExpression(bool global, bool array, NodeArray placement, Node const * type, NodeArray inits, bool hasInit) noexcept
+        : Node{ Kind::Expression }, m_global{ global }, m_array{ array }, m_placement{ placement }
+        , m_type{ type }, m_inits{ inits }, m_hasInit{ hasInit } {}
+
+        void printLeft(Printer & p) const override
+        {
+            if (m_global)
+            {
+                p << "::";
+            }
+            p << (m_array ? "new[] " : "new ");
+            if (!m_placement.empty())
+            {
+                p << '(';
+                printList(p, m_placement);
+                p << ") ";
+            }
+            m_type->print(p);
+            if (m_hasInit)
+            {
+                p << '(';
+                printList(p, m_inits);
+                p << ')';
+            }
+        }
+
+    private:
+        bool m_global;
+        bool m_array;
+        NodeArray m_placement;
+        Node const * m_type;
+        NodeArray m_inits;
+        bool m_hasInit;
+    };
+
+    // "{parm#1}"
+    class FunctionParam : public Node
+    {
+    public:
+        explicit FunctionParam(size_t number) noexcept : Node{ Kind::Expression }, m_number{ number } {}
+
+        bool isSimpleExpression() const override { return true; }
+
+        void printLeft(Printer & p) const override
+        {
+            p << "{parm#";
+            printNumber(p, m_number);
+            p << '}';
+        }
+
+    private:
+        size_t m_number;
+    };
+
+    // sizeof...(T), printed as the number of the arguments the way libiberty does it
+    class SizeofPackExpression : public Node
+    {
+    public:
+        explicit SizeofPackExpression(Node const * pack) noexcept : Node{ Kind::Expression }, m_pack{ pack } {}
+
+        void printLeft(Printer & p) const override
+        {
+            bool const pack = m_pack->kind() == Kind::ParameterPack;
+            printNumber(p, pack ? static_cast<ParameterPack const *>(m_pack)->size() : 0);
+        }
+
+    private:
+        Node const * m_pack;
+    };
+
+    // "(" ... ")" folds of C++17
+    class FoldExpression : public Node
+    {
+    public:
+        FoldExpression(Node const * pack, std::string_view op, Node const * init, bool left) noexcept
+        : Node{ Kind::Expression }, m_pack{ pack }, m_op{ op }, m_init{ init }, m_left{ left } {}
+
+        void printLeft(Printer & p) const override
+        {
+            p << '(';
+            if (m_left)
+            {
+                if (m_init)
+                {
+                    printOperand(p, m_init);
+                    p << m_op;
+                }
+                p << "..." << m_op;
+                printOperand(p, m_pack);
+            }
+            else
+            {
+                printOperand(p, m_pack);
+                p << m_op << "...";
+                if (m_init)
+                {
+                    p << m_op;
+                    printOperand(p, m_init);
+                }
+            }
+            p << ')';
+        }
+
+    private:
+        Node const * m_pack;
+        std::string_view m_op;
+        Node const * m_init;
+        bool m_left;
+    };
+
+    // L <type> <value> E, the integers of the common types are printed with their C suffixes
+    class Literal : public Node
+    {
+    public:
+        enum class Style : uint8_t
+        {
+            Plain,
+            Suffixed,
+            Bool,
+            Float,
+            Cast,
+        };
+
+        Literal(Node const * type, std::string_view value, bool negative, Style style, std::string_view suffix) noexcept
+        : Node{ Kind::Literal }, m_type{ type }, m_value{ value }, m_suffix{ suffix }
+        , m_negative{ negative }, m_style{ style } {}
+
+        void printLeft(Printer & p) const override
+        {
+            switch (m_style)
+            {
+                case Style::Bool:
+                    if (!m_negative && (m_value == "0" || m_value == "1"))
+                    {
+                        p << (m_value == "0" ? "false" : "true");
+                        return;
+                    }
+                    break;
+                case Style::Plain:
+                case Style::Suffixed:
+                    if (m_negative)
+                    {
+                        p << '-';
+                    }
+                    p << m_value << m_suffix;
+                    return;
+                default:
+                    break;
+            }
+
+            p << '(';
+            m_type->print(p);
+            p << ')';
+            if (m_negative)
+            {
+                p << '-';
+            }
+            if (m_style == Style::Float)
+            {
+                p << '[' << m_value << ']';
+            }
+            else
+            {
+                p << m_value;
+            }
+        }
+
+    private:
+        Node const * m_type;
+        std::string_view m_value;
+        std::string_view m_suffix;
+        bool m_negative;
+        Style m_style;
+    };
+
+    enum class OperatorKind : uint8_t
+    {
+        Binary,
+        Prefix,
+        // ++ and --, prefix ones when followed by '_'
+        Increment,
+        Member,
+        Subscript,
+        Call,
+        Conditional,
+        NamedCast,
+        // The rest is only parsed as names
+        Other,
+    };
+
+    struct OperatorInfo
+    {
+        char code[2];
+        OperatorKind kind;
+        std::string_view symbol;
+    };
+
+    // Sorted by the code, the symbols are the libiberty ones
+    constexpr OperatorInfo operators[] = {
+        { { 'a', 'N' }, OperatorKind::Binary,      "&="               },
+        { { 'a', 'S' }, OperatorKind::Binary,      "="                },
+        { { 'a', 'a' }, OperatorKind::Binary,      "&&"               },
+        { { 'a', 'd' }, OperatorKind::Prefix,      "&"                },
+        { { 'a', 'n' }, OperatorKind::Binary,      "&"                },
+        { { 'a', 'w' }, OperatorKind::Prefix,      "co_await "        },
+        { { 'c', 'c' }, OperatorKind::NamedCast,   "const_cast"       },
+        { { 'c', 'l' }, OperatorKind::Call,        "()"               },
+        { { 'c', 'm' }, OperatorKind::Binary,      ","                },
+        { { 'c', 'o' }, OperatorKind::Prefix,      "~"                },
+        { { 'd', 'V' }, OperatorKind::Binary,      "/="               },
+        { { 'd', 'a' }, OperatorKind::Other,       "delete[]"         },
+        { { 'd', 'c' }, OperatorKind::NamedCast,   "dynamic_cast"     },
+        { { 'd', 'e' }, OperatorKind::Prefix,      "*"                },
+        { { 'd', 'l' }, OperatorKind::Other,       "delete"           },
+        { { 'd', 's' }, OperatorKind::Binary,      ".*"               },
+        { { 'd', 't' }, OperatorKind::Member,      "."                },
+        { { 'd', 'v' }, OperatorKind::Binary,      "/"                },
+        { { 'e', 'O' }, OperatorKind::Binary,      "^="               },
+        { { 'e', 'o' }, OperatorKind::Binary,      "^"                },
+        { { 'e', 'q' }, OperatorKind::Binary,      "=="               },
+        { { 'g', 'e' }, OperatorKind::Binary,      ">="               },
+        { { 'g', 't' }, OperatorKind::Binary,      ">"                },
+        { { 'i', 'x' }, OperatorKind::Subscript,   "[]"               },
+        { { 'l', 'S' }, OperatorKind::Binary,      "<<="              },
+        { { 'l', 'e' }, OperatorKind::Binary,      "<="               },
+        { { 'l', 's' }, OperatorKind::Binary,      "<<"               },
+        { { 'l', 't' }, OperatorKind::Binary,      "<"                },
+        { { 'm', 'I' }, OperatorKind::Binary,      "-="               },
+        { { 'm', 'L' }, OperatorKind::Binary,      "*="               },
+        { { 'm', 'i' }, OperatorKind::Binary,      "-"                },
+        { { 'm', 'l' }, OperatorKind::Binary,      "*"                },
+        { { 'm', 'm' }, OperatorKind::Increment,   "--"               },
+        { { 'n', 'a' }, OperatorKind::Other,       "new[]"            },
+        { { 'n', 'e' }, OperatorKind::Binary,      "!="               },
+        { { 'n', 'g' }, OperatorKind::Prefix,      "-"                },
+        { { 'n', 't' }, OperatorKind::Prefix,      "!"                },
+        { { 'n', 'w' }, OperatorKind::Other,       "new"              },
+        { { 'o', 'R' }, OperatorKind::Binary,      "|="               },
+        { { 'o', 'o' }, OperatorKind::Binary,      "||"               },
+        { { 'o', 'r' }, OperatorKind::Binary,      "|"                },
+        { { 'p', 'L' }, OperatorKind::Binary,      "+="               },
+        { { 'p', 'l' }, OperatorKind::Binary,      "+"                },
+        { { 'p', 'm' }, OperatorKind::Binary,      "->*"              },
+        { { 'p', 'p' }, OperatorKind::Increment,   "++"               },
+        { { 'p', 's' }, OperatorKind::Prefix,      "+"                },
+        { { 'p', 't' }, OperatorKind::Member,      "->"               },
+        { { 'q', 'u' }, OperatorKind::Conditional, "?"                },
+        { { 'r', 'M' }, OperatorKind::Binary,      "%="               },
+        { { 'r', 'S' }, OperatorKind::Binary,      ">>="              },
+        { { 'r', 'c' }, OperatorKind::NamedCast,   "reinterpret_cast" },
+        { { 'r', 'm' }, OperatorKind::Binary,      "%"                },
+        { { 'r', 's' }, OperatorKind::Binary,      ">>"               },
+        { { 's', 'c' }, OperatorKind::NamedCast,   "static_cast"      },
+        { { 's', 's' }, OperatorKind::Binary,      "<=>"              },
+    };
+
+    OperatorInfo const * findOperator(char first, char second) noexcept
+    {
+        for (OperatorInfo const & info: operators)
+        {
+            if (info.code[0] == first && info.code[1] == second)
+            {
+                return &info;
+            }
+        }
+        return nullptr;
+    }
+
+    // Reused by the calls made on a thread, so that a warmed-up demangler makes no heap allocations
+    struct Scratch
+    {
+        Arena arena;
+        // The lists being built, the finished ones are copied into the arena
+        std::vector<Node *> names;
+        std::vector<Node *> substitutions;
+        std::vector<Node *> templateParams;
+        std::vector<ForwardTemplateReference *> forwardReferences;
+        std::vector<ForwardTemplateReference *> lambdaArguments;
+
+        void reset() noexcept
+        {
+            arena.reset();
+            names.clear();
+            substitutions.clear();
+            templateParams.clear();
+            forwardReferences.clear();
+            lambdaArguments.clear();
+        }
+    };
+
+    // Recursive descent over the grammar of https://itanium-cxx-abi.github.io/cxx-abi/abi.html#mangling,
+    // the substitution candidates are the ones libiberty records
+    class ItaniumParser
+    {
+    public:
+        ItaniumParser(std::string_view mangled, Scratch & scratch, bool legacyUnresolvedNames) noexcept
+        : m_text{ mangled }, m_scratch{ scratch }, m_legacyUnresolvedNames{ legacyUnresolvedNames } {}
+
+        Node * parseMangledName();
+
+        // The name might be valid in the older unresolved name syntax
+        bool triedQualifierLevels() const noexcept
+        {
+            return m_triedQualifierLevels;
+        }
+
+    private:
+        struct NameState
+        {
+            bool ctorDtorConversion = false;
+            bool endsWithTemplateArgs = false;
+            FunctionTraits traits;
+            size_t forwardReferencesBegin = 0;
+            size_t lambdaArgumentsBegin = 0;
+        };
+
+        // The template parameters of an encoding are unrelated to the enclosing ones
+        class ParamsScope
+        {
+        public:
+            explicit ParamsScope(ItaniumParser & parser) noexcept
+            : m_parser{ parser }, m_begin{ parser.m_paramsBegin }, m_end{ parser.m_scratch.templateParams.size() }
+            {
+                parser.m_paramsBegin = m_end;
+            }
+
+            ~ParamsScope()
+            {
+                m_parser.m_scratch.templateParams.resize(m_end);
+                m_parser.m_paramsBegin = m_begin;
+            }
+
+        private:
+            ItaniumParser & m_parser;
+            size_t m_begin;
+            size_t m_end;
+        };
+
+        class Flag
+        {
+        public:
+            Flag(bool & flag, bool value) noexcept : m_flag{ flag }, m_saved{ flag }
+            {
+                flag = value;
+            }
+
+            ~Flag()
+            {
+                m_flag = m_saved;
+            }
+
+        private:
+            bool & m_flag;
+            bool m_saved;
+        };
+
+        // The names come from arbitrary binaries, their nesting is bounded to keep the stack safe
+        class DepthGuard
+        {
+        public:
+            explicit DepthGuard(ItaniumParser & parser) noexcept : m_parser{ parser }
+            {
+                ++parser.m_depth;
+            }
+
+            ~DepthGuard()
+            {
+                --m_parser.m_depth;
+            }
+
+            bool exceeded() const noexcept
+            {
+                return m_parser.m_depth > MaxDepth;
+            }
+
+        private:
+            ItaniumParser & m_parser;
+        };
+
+        static constexpr unsigned MaxDepth = 256;
+
+        Node * parseEncoding();
+        Node * parseSpecialName();
+        bool parseCallOffset();
+        Node * parseName(NameState * state);
+        Node * parseUnscopedName(NameState * state);
+        Node * parseNestedName(NameState * state);
+        Node * parseLocalName(NameState * state);
+        Node * parseUnqualifiedName(NameState * state, Node * scope);
+        Node * parseSourceName();
+        Node * parseOperatorName(NameState * state);
+        Node * parseCtorDtorName(NameState * state);
+        Node * parseUnnamedTypeName();
+        Node * parseAbiTags(Node * name);
+        Node * parseSubstitution();
+        Node * parseTemplateParam();
+        Node * parseTemplateArgs(bool tag);
+        Node * parseTemplateArg();
+        Node * parseType();
+        Node * parseBuiltinType();
+        Node * parseQualifiedType();
+        Node * parseFunctionType(FunctionTraits traits);
+        Node * parseArrayType();
+        Node * parseVectorType();
+        Node * parseDecltype();
+        Node * parseExpression();
+        Node * parseExpressionPrimary();
+        Node * parseFunctionParam();
+        Node * parseUnresolvedName();
+        Node * parseNewExpression(bool global, bool array);
+        Node * parseFoldExpression();
+        bool parseDiscriminator();
+        bool resolveForwardReferences(NameState const & state);
+
+        bool atEnd() const noexcept
+        {
+            return m_pos >= m_text.size();
+        }
+
+        char look(size_t ahead = 0) const noexcept
+        {
+            return m_pos + ahead < m_text.size() ? m_text[m_pos + ahead] : '\0';
+        }
+
+        bool consume(char c) noexcept
+        {
+            if (look() != c)
+            {
+                return false;
+            }
+            ++m_pos;
+            return true;
+        }
+
+        bool consume(std::string_view prefix) noexcept
+        {
+            if (!m_text.substr(m_pos).starts_with(prefix))
+            {
+                return false;
+            }
+            m_pos += prefix.size();
+            return true;
+        }
+
+        static bool isDigit(char c) noexcept
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        static bool isLower(char c) noexcept
+        {
+            return c >= 'a' && c <= 'z';
+        }
+
+        static bool isUpper(char c) noexcept
+        {
+            return c >= 'A' && c <= 'Z';
+        }
+
+        // Decimal digits, empty if there are none
+        std::string_view parseDigits() noexcept
+        {
+            size_t const start = m_pos;
+            while (isDigit(look()))
+            {
+                ++m_pos;
+            }
+            return m_text.substr(start, m_pos - start);
+        }
+
+        bool parseNumber(size_t & number) noexcept
+        {
+            std::string_view const digits = parseDigits();
+            if (digits.empty() || digits.size() > 9)
+            {
+                return false;
+            }
+            number = 0;
+            for (char digit: digits)
+            {
+                number = number * 10 + static_cast<size_t>(digit - '0');
+            }
+            return true;
+        }
+
+        // [0-9A-Z]* _, 0 for the bare underscore and the base-36 value + 1 otherwise
+        bool parseSeqId(size_t & id) noexcept
+        {
+            if (consume('_'))
+            {
+                id = 0;
+                return true;
+            }
+            size_t value = 0;
+            size_t digits = 0;
+            for (char c = look(); isDigit(c) || isUpper(c); c = look())
+            {
+                value = value * 36 + static_cast<size_t>(isDigit(c) ? c - '0' : c - 'A' + 10);
+                ++m_pos;
+                if (++digits > 8)
+                {
+                    return false;
+                }
+            }
+            if (!digits || !consume('_'))
+            {
+                return false;
+            }
+            id = value + 1;
+            return true;
+        }
+
+        template<typename T, typename... Args>
+        T * make(Args &&... args)
+        {
+            return m_scratch.arena.make<T>(std::forward<Args>(args)...);
+        }
+
+        Node * makeName(std::string_view name)
+        {
+            return make<NameNode>(name);
+        }
+
+        std::string_view concat(std::string_view first, std::string_view second, std::string_view third)
+        {
+            size_t const size = first.size() + second.size() + third.size();
+            auto * data = static_cast<char *>(m_scratch.arena.allocate(size, 1));
+            first.copy(data, first.size());
+            second.copy(data + first.size(), second.size());
+            third.copy(data + first.size() + second.size(), third.size());
+            return { data, size };
+        }
+
+        size_t mark() const noexcept
+        {
+            return m_scratch.names.size();
+        }
+
+        void push(Node * node)
+        {
+            m_scratch.names.push_back(node);
+        }
+
+        // Moves the names pushed since the mark into the arena
+        NodeArray popArray(size_t from)
+        {
+            std::span<Node * const> const pushed{ m_scratch.names.data() + from, m_scratch.names.size() - from };
+            NodeArray const result = m_scratch.arena.copy(pushed);
+            m_scratch.names.resize(from);
+            return result;
+        }
+
+        void addSubstitution(Node * node)
+        {
+            m_scratch.substitutions.push_back(node);
+        }
+
+        std::span<Node * const> templateParams() const noexcept
+        {
+            return { m_scratch.templateParams.data() + m_paramsBegin, m_scratch.templateParams.size() - m_paramsBegin };
+        }
+
+        std::string_view m_text;
+        size_t m_pos = 0;
+        Scratch & m_scratch;
+        size_t m_paramsBegin = 0;
+        unsigned m_depth = 0;
+
+        // A conversion operator refers to the template arguments following it
+        bool m_permitForwardReferences = false;
+        // Off in the type of a conversion operator, where "I" starts the arguments of the operator
+        bool m_tryTemplateArgs = true;
+        // The template parameters of a generic lambda signature are its auto parameters
+        bool m_parsingLambdaParams = false;
+        // "sr <type> <name>" instead of "sr <qualifier levels> E <name>"
+        bool m_legacyUnresolvedNames = false;
+        bool m_triedQualifierLevels = false;
+        // The constructors are named after the last source name outside of the template arguments,
+        // not after their scope, which differs for the members of the unnamed types and of the lambdas
+        std::string_view m_lastName;
+    };
+}
+
+Node * ItaniumParser::parseMangledName()
+{
+    if (!consume("_Z"))
+    {
+        return nullptr;
+    }
+    Node * result = parseEncoding();
+    if (!result)
+    {
+        return nullptr;
+    }
+
+    // GCC clones, e.g. ".constprop.0.isra.0"
+    while (look() == '.' && (isLower(look(1)) || isDigit(look(1)) || look(1) == '_'))
+    {
+        size_t const start = m_pos;
+        m_pos += 2;
+        while (isLower(look()) || isDigit(look()) || look() == '_')
+        {
+            ++m_pos;
+        }
+        while (look() == '.' && isDigit(look(1)))
+        {
+            m_pos += 2;
+            parseDigits();
+        }
+        result = make<ClonedName>(result, m_text.substr(start, m_pos - start));
+    }
+    return atEnd() ? result : nullptr;
+}
+
+Node * ItaniumParser::parseEncoding()
+{
+    DepthGuard depth{ *this };
+    if (depth.exceeded())
+    {
+        return nullptr;
+    }
+
+    if (look() == 'G' || look() == 'T')
+    {
+        return parseSpecialName();
+    }
+
+    ParamsScope paramsScope{ *this };
+
+    NameState state;
+    state.forwardReferencesBegin = m_scratch.forwardReferences.size();
+    state.lambdaArgumentsBegin = m_scratch.lambdaArguments.size();
+    Node * name = parseName(&state);
+    if (!name || !resolveForwardReferences(state))
+    {
+        return nullptr;
+    }
+
+    // A variable
+    if (atEnd() || look() == 'E' || look() == '.')
+    {
+        return name;
+    }
+
+    // The return types are only mangled for the template functions
+    Node * returnType = nullptr;
+    if (state.endsWithTemplateArgs && !state.ctorDtorConversion)
+    {
+        returnType = parseType();
+        if (!returnType)
+        {
+            return nullptr;
+        }
+    }
+
+    size_t const params = mark();
+    if (!(look() == 'v' && (m_pos + 1 == m_text.size() || look(1) == 'E' || look(1) == '.') && consume('v')))
+    {
+        do
+        {
+            Node * param = parseType();
+            if (!param)
+            {
+                return nullptr;
+            }
+            push(param);
+        }
+        while (!atEnd() && look() != 'E' && look() != '.');
+    }
+
+    return make<FunctionEncoding>(returnType, name, popArray(params), state.traits);
+}
+
+Node * ItaniumParser::parseSpecialName()
+{
+    if (consume('T'))
+    {
+        char const kind = look();
+        ++m_pos;
+        switch (kind)
+        {
+            case 'V':
+            case 'T':
+            case 'I':
+            case 'S':
+            case 'F':
+            case 'J':
+            {
+                Node * type = parseType();
+                if (!type)
+                {
+                    return nullptr;
+                }
+                std::string_view prefix =
+                    kind == 'V' ? "vtable for " :
+                    kind == 'T' ? "VTT for " :
+                    kind == 'I' ? "typeinfo for " :
+                    kind == 'S' ? "typeinfo name for " :
+                    kind == 'F' ? "typeinfo fn for " : "java Class for ";
+                return make<SpecialName>(prefix, type);
+            }
+            case 'h':
+            case 'v':
+            {
+                --m_pos;
+                if (!parseCallOffset())
+                {
+                    return nullptr;
+                }
+                Node * encoding = parseEncoding();
+                if (!encoding)
+                {
+                    return nullptr;
+                }
+                return make<SpecialName>(kind == 'h' ? "non-virtual thunk to " : "virtual thunk to ", encoding);
+            }
+            case 'c':
+            {
+                if (!parseCallOffset() || !parseCallOffset())
+                {
+                    return nullptr;
+                }
+                Node * encoding = parseEncoding();
+                if (!encoding)
+                {
+                    return nullptr;
+                }
+                return make<SpecialName>("covariant return thunk to ", encoding);
+            }
+            case 'C':
+            {
+                Node * derived = parseType();
+                size_t offset{};
+                if (!derived || !parseNumber(offset) || !consume('_'))
+                {
+                    return nullptr;
+                }
+                Node * base = parseType();
+                if (!base)
+                {
+                    return nullptr;
+                }
+                return make<ConstructionVtableName>(derived, base);
+            }
+            case 'H':
+            case 'W':
+            {
+                Node * name = parseName(nullptr);
+                if (!name)
+                {
+                    return nullptr;
+                }
+                return make<SpecialName>(kind == 'H' ? "TLS init function for " : "TLS wrapper function for ", name);
+            }
+            case 'A':
+            {
+                Node * arg = parseTemplateArg();
+                if (!arg)
+                {
+                    return nullptr;
+                }
+                return make<SpecialName>("template parameter object for ", arg);
+            }
+            default:
+                return nullptr;
+        }
+    }
+
+    if (consume('G'))
+    {
+        char const kind = look();
+        ++m_pos;
+        switch (kind)
+        {
+            case 'V':
+            {
+                Node * name = parseName(nullptr);
+                if (!name)
+                {
+                    return nullptr;
+                }
+                return make<SpecialName>("guard variable for ", name);
+            }
+            case 'R':
+            {
+                Node * name = parseName(nullptr);
+                size_t number{};
+                if (!name || (look() != '_' && !parseSeqId(number)) || (look() == '_' && !consume('_')))
+                {
+                    return nullptr;
+                }
+                return make<ReferenceTemporaryName>(name, number);
+            }
+            case 'A':
+            {
+                Node * encoding = parseEncoding();
+                if (!encoding)
+                {
+                    return nullptr;
+                }
+                return make<SpecialName>("hidden alias for ", encoding);
+            }
+            case 'T':
+            {
+                char const clone = look();
+                if (clone != 't' && clone != 'n')
+                {
+                    return nullptr;
+                }
+                ++m_pos;
+                Node * encoding = parseEncoding();
+                if (!encoding)
+                {
+                    return nullptr;
+                }
+                return make<SpecialName>(
+                    clone == 't' ? "transaction clone for " : "non-transaction clone for ", encoding);
+            }
+            default:
+                return nullptr;
+        }
+    }
+
+    return nullptr;
+}
+
+// h <offset> _ | v <offset> _ <virtual offset> _, the offsets aren't printed
+bool ItaniumParser::parseCallOffset()
+{
+    auto parseOffset = [this]
+    {
+        consume('n');
+        return !parseDigits().empty() && consume('_');
+    };
+
+    if (consume('h'))
+    {
+        return parseOffset();
+    }
+    if (consume('v'))
+    {
+        return parseOffset() && parseOffset();
+    }
+    return false;
+}
+
+bool ItaniumParser::resolveForwardReferences(NameState const & state)
+{
+    auto & references = m_scratch.forwardReferences;
+    std::span<Node * const> const params = templateParams();
+    for (size_t i = state.forwardReferencesBegin; i < references.size(); ++i)
+    {
+        if (references[i]->index() >= params.size())
+        {
+            return false;
+        }
+        references[i]->resolveTo(params[references[i]->index()]);
+    }
+    references.resize(state.forwardReferencesBegin);
+
+    // The arguments of the call operator of a generic lambda, if the name ends with them
+    auto & lambdaArguments = m_scratch.lambdaArguments;
+    for (size_t i = state.lambdaArgumentsBegin; i < lambdaArguments.size(); ++i)
+    {
+        if (lambdaArguments[i]->index() < params.size())
+        {
+            lambdaArguments[i]->resolveTo(params[lambdaArguments[i]->index()]);
+        }
+    }
+    lambdaArguments.resize(state.lambdaArgumentsBegin);
+    return true;
+}
+
+Node * ItaniumParser::parseName(NameState * state)
+{
+    DepthGuard depth{ *this };
+    if (depth.exceeded())
+    {
+        return nullptr;
+    }
+
+    if (look() == 'N')
+    {
+        return parseNestedName(state);
+    }
+    if (look() == 'Z')
+    {
+        return parseLocalName(state);
+    }
+
+    Node * name = nullptr;
+    if (look() == 'S' && look(1) != 't')
+    {
+        // Only a template name or a special one is substituted here
+        name = parseSubstitution();
+        if (!name)
+        {
+            return nullptr;
+        }
+        if (look() != 'I')
+        {
+            return name->kind() == Node::Kind::SpecialSubstitution ? name : nullptr;
+        }
+    }
+    else
+    {
+        name = parseUnscopedName(state);
+        if (!name)
+        {
+            return nullptr;
+        }
+        if (look() == 'I')
+        {
+            addSubstitution(name);
+        }
+    }
+
+    if (look() == 'I')
+    {
+        Node * args = parseTemplateArgs(state != nullptr);
+        if (!args)
+        {
+            return nullptr;
+        }
+        if (state)
+        {
+            state->endsWithTemplateArgs = true;
+        }
+        name = make<NameWithTemplateArgs>(name, args);
+    }
+    return name;
+}
+
+Node * ItaniumParser::parseUnscopedName(NameState * state)
+{
+    bool const std = consume("St");
+    Node * name = parseUnqualifiedName(state, nullptr);
+    if (!name)
+    {
+        return nullptr;
+    }
+    return std ? make<NestedName>(makeName("std"), name) : name;
+}
+
+Node * ItaniumParser::parseNestedName(NameState * state)
+{
+    if (!consume('N'))
+    {
+        return nullptr;
+    }
+
+    FunctionTraits traits;
+    if (consume('r'))
+    {
+        traits.qualifiers |= QualRestrict;
+    }
+    if (consume('V'))
+    {
+        traits.qualifiers |= QualVolatile;
+    }
+    if (consume('K'))
+    {
+        traits.qualifiers |= QualConst;
+    }
+    if (consume('R'))
+    {
+        traits.refQualifier = RefQualifier::LValue;
+    }
+    else if (consume('O'))
+    {
+        traits.refQualifier = RefQualifier::RValue;
+    }
+    if (state)
+    {
+        state->traits = traits;
+    }
+
+    Node * soFar = nullptr;
+    auto append = [this, &soFar, state](Node * component)
+    {
+        soFar = soFar ? make<NestedName>(soFar, component) : component;
+        if (state)
+        {
+            state->endsWithTemplateArgs = false;
+        }
+    };
+
+    while (!consume('E'))
+    {
+        if (atEnd())
+        {
+            return nullptr;
+        }
+
+        char const c = look();
+        if (c == 'M')
+        {
+            // The closure prefix of a data member initializer
+            if (!soFar)
+            {
+                return nullptr;
+            }
+            ++m_pos;
+            continue;
+        }
+        else if (c == 'T')
+        {
+            if (soFar)
+            {
+                return nullptr;
+            }
+            Node * param = parseTemplateParam();
+            if (!param)
+            {
+                return nullptr;
+            }
+            append(param);
+        }
+        else if (c == 'I')
+        {
+            if (!soFar)
+            {
+                return nullptr;
+            }
+            Node * args = parseTemplateArgs(state != nullptr);
+            if (!args)
+            {
+                return nullptr;
+            }
+            soFar = make<NameWithTemplateArgs>(soFar, args);
+            if (state)
+            {
+                state->endsWithTemplateArgs = true;
+            }
+        }
+        else if (c == 'D' && (look(1) == 't' || look(1) == 'T'))
+        {
+            if (soFar)
+            {
+                return nullptr;
+            }
+            Node * decltypeNode = parseDecltype();
+            if (!decltypeNode)
+            {
+                return nullptr;
+            }
+            append(decltypeNode);
+        }
+        else if (c == 'S')
+        {
+            if (soFar)
+            {
+                return nullptr;
+            }
+            Node * substitution = parseSubstitution();
+            if (!substitution)
+            {
+                return nullptr;
+            }
+            // The special ones are spelled out as the scope of a constructor or destructor
+            if (substitution->kind() == Node::Kind::SpecialSubstitution && (look() == 'C' || look() == 'D'))
+            {
+                substitution = static_cast<SpecialSubstitution *>(substitution)->expand(m_scratch.arena);
+            }
+            soFar = substitution;
+            continue;
+        }
+        else
+        {
+            consume('L');
+            Node * component = parseUnqualifiedName(state, soFar);
+            if (!component)
+            {
+                return nullptr;
+            }
+            append(component);
+        }
+
+        if (look() != 'E')
+        {
+            addSubstitution(soFar);
+        }
+    }
+
+    return soFar;
+}
+
+Node * ItaniumParser::parseLocalName(NameState * state)
+{
+    if (!consume('Z'))
+    {
+        return nullptr;
+    }
+    Node * encoding = parseEncoding();
+    if (!encoding || !consume('E'))
+    {
+        return nullptr;
+    }
+
+    if (consume('s'))
+    {
+        parseDiscriminator();
+        return make<LocalName>(encoding, makeName("string literal"));
+    }
+
+    if (consume('d'))
+    {
+        size_t number = 0;
+        if (isDigit(look()))
+        {
+            if (!parseNumber(number))
+            {
+                return nullptr;
+            }
+            ++number;
+        }
+        if (!consume('_'))
+        {
+            return nullptr;
+        }
+        Node * entity = parseName(state);
+        if (!entity)
+        {
+            return nullptr;
+        }
+        return make<LocalName>(encoding, make<NestedName>(make<DefaultArgName>(number + 1), entity));
+    }
+
+    Node * entity = parseName(state);
+    if (!entity || !parseDiscriminator())
+    {
+        return nullptr;
+    }
+    return make<LocalName>(encoding, entity);
+}
+
+// _ <digit> | __ <number> _, not printed
+bool ItaniumParser::parseDiscriminator()
+{
+    if (look() != '_')
+    {
+        return true;
+    }
+    if (isDigit(look(1)))
+    {
+        m_pos += 2;
+        return true;
+    }
+    if (look(1) == '_')
+    {
+        m_pos += 2;
+        return !parseDigits().empty() && consume('_');
+    }
+    return true;
+}
+
+Node * ItaniumParser::parseUnqualifiedName(NameState * state, Node * scope)
+{
+    Node * name = nullptr;
+    char const c = look();
+    if (isDigit(c))
+    {
+        name = parseSourceName();
+    }
+    else if (c == 'U')
+    {
+        name = parseUnnamedTypeName();
+    }
+    else if (c == 'L')
+    {
+        // Internal linkage
+        ++m_pos;
+        name = parseSourceName();
+        if (name && !parseDiscriminator())
+        {
+            return nullptr;
+        }
+    }
+    else if (c == 'C' || (c == 'D' && look(1) != 'C'))
+    {
+        if (!scope)
+        {
+            return nullptr;
+        }
+        name = parseCtorDtorName(state);
+    }
+    else if (c == 'D' && look(1) == 'C')
+    {
+        m_pos += 2;
+        size_t const names = mark();
+        while (!consume('E'))
+        {
+            Node * binding = parseSourceName();
+            if (!binding)
+            {
+                return nullptr;
+            }
+            push(binding);
+        }
+        name = make<StructuredBindingName>(popArray(names));
+    }
+    else
+    {
+        name = parseOperatorName(state);
+    }
+
+    return name ? parseAbiTags(name) : nullptr;
+}
+
+Node * ItaniumParser::parseSourceName()
+{
+    size_t length{};
+    if (!parseNumber(length) || length == 0 || length > m_text.size() - m_pos)
+    {
+        return nullptr;
+    }
+    std::string_view const identifier = m_text.substr(m_pos, length);
+    m_pos += length;
+
+    // _GLOBAL__N_1 and the like
+    if (identifier.size() >= 10 && identifier.starts_with("_GLOBAL_") &&
+        (identifier[8] == '.' || identifier[8] == '_' || identifier[8] == '$') && identifier[9] == 'N')
+    {
+        m_lastName = "(anonymous namespace)";
+    }
+    else
+    {
+        m_lastName = identifier;
+    }
+    return makeName(m_lastName);
+}
+
+Node * ItaniumParser::parseAbiTags(Node * name)
+{
+    while (consume('B'))
+    {
+        size_t length{};
+        if (!parseNumber(length) || length == 0 || length > m_text.size() - m_pos)
+        {
+            return nullptr;
+        }
+        name = make<AbiTaggedName>(name, m_text.substr(m_pos, length));
+        m_pos += length;
+    }
+    return name;
+}
+
+Node * ItaniumParser::parseOperatorName(NameState * state)
+{
+    char const first = look();
+    char const second = look(1);
+
+    if (first == 'c' && second == 'v')
+    {
+        m_pos += 2;
+        Flag noTemplateArgs{ m_tryTemplateArgs, false };
+        Flag forwardReferences{ m_permitForwardReferences, m_permitForwardReferences || state != nullptr };
+        Node * type = parseType();
+        if (!type)
+        {
+            return nullptr;
+        }
+        if (state)
+        {
+            state->ctorDtorConversion = true;
+        }
+        return make<ConversionOperatorName>(type);
+    }
+    if (first == 'l' && second == 'i')
+    {
+        m_pos += 2;
+        Node * suffix = parseSourceName();
+        if (!suffix)
+        {
+            return nullptr;
+        }
+        return make<LiteralOperatorName>(suffix->baseName());
+    }
+    if (first == 'v' && isDigit(second))
+    {
+        // Vendor extended operator
+        m_pos += 2;
+        Node * vendorName = parseSourceName();
+        if (!vendorName)
+        {
+            return nullptr;
+        }
+        return make<OperatorName>(vendorName->baseName());
+    }
+
+    OperatorInfo const * info = findOperator(first, second);
+    if (!info)
+    {
+        return nullptr;
+    }
+    m_pos += 2;
+    return make<OperatorName>(info->symbol);
+}
+
+Node * ItaniumParser::parseCtorDtorName(NameState * state)
+{
+    if (consume('C'))
+    {
+        bool const inheriting = consume('I');
+        char const variant = look();
+        if (variant < '1' || variant > '5')
+        {
+            return nullptr;
+        }
+        ++m_pos;
+        // The base class of an inheriting constructor isn't printed, though it names the constructor
+        if (inheriting && !parseName(nullptr))
+        {
+            return nullptr;
+        }
+        if (state)
+        {
+            state->ctorDtorConversion = true;
+        }
+        return make<CtorDtorName>(m_lastName, /*destructor=*/false);
+    }
+
+    if (consume('D'))
+    {
+        char const variant = look();
+        if (variant != '0' && variant != '1' && variant != '2' && variant != '4' && variant != '5')
+        {
+            return nullptr;
+        }
+        ++m_pos;
+        if (state)
+        {
+            state->ctorDtorConversion = true;
+        }
+        return make<CtorDtorName>(m_lastName, /*destructor=*/true);
+    }
+
+    return nullptr;
+}
+
+// Ut [<number>] _ and Ul <lambda-sig> E [<number>] _
+Node * ItaniumParser::parseUnnamedTypeName()
+{
+    if (consume("Ut"))
+    {
+        size_t number = 0;
+        if (isDigit(look()))
+        {
+            if (!parseNumber(number))
+            {
+                return nullptr;
+            }
+            ++number;
+        }
+        if (!consume('_'))
+        {
+            return nullptr;
+        }
+        return make<UnnamedTypeName>(number + 1, NodeArray{}, /*lambda=*/false);
+    }
+
+    if (consume("Ul"))
+    {
+        size_t const params = mark();
+        {
+            Flag lambdaParams{ m_parsingLambdaParams, true };
+            if (!(consume('v') && look() == 'E'))
+            {
+                while (look() != 'E')
+                {
+                    Node * param = parseType();
+                    if (!param)
+                    {
+                        return nullptr;
+                    }
+                    push(param);
+                }
+            }
+        }
+        if (!consume('E'))
+        {
+            return nullptr;
+        }
+        NodeArray const lambdaParams = popArray(params);
+
+        size_t number = 0;
+        if (isDigit(look()))
+        {
+            if (!parseNumber(number))
+            {
+                return nullptr;
+            }
+            ++number;
+        }
+        if (!consume('_'))
+        {
+            return nullptr;
+        }
+        return make<UnnamedTypeName>(number + 1, lambdaParams, /*lambda=*/true);
+    }
+
+    return nullptr;
+}
+
+Node * ItaniumParser::parseSubstitution()
+{
+    if (!consume('S'))
+    {
+        return nullptr;
+    }
+
+    if (isLower(look()))
+    {
+        char const c = look();
+        ++m_pos;
+        SpecialSubstitution * special = nullptr;
+        switch (c)
+        {
+            case 't':
+                return makeName("std");
+            case 'a':
+                special = make<SpecialSubstitution>("std::allocator", "allocator", "std::allocator");
+                break;
+            case 'b':
+                special = make<SpecialSubstitution>("std::basic_string", "basic_string", "std::basic_string");
+                break;
+            case 's':
+                special = make<SpecialSubstitution>("std::string", "basic_string",
+                    "std::basic_string<char, std::char_traits<char>, std::allocator<char> >");
+                break;
+            case 'i':
+                special = make<SpecialSubstitution>("std::istream", "basic_istream",
+                    "std::basic_istream<char, std::char_traits<char> >");
+                break;
+            case 'o':
+                special = make<SpecialSubstitution>("std::ostream", "basic_ostream",
+                    "std::basic_ostream<char, std::char_traits<char> >");
+                break;
+            case 'd':
+                special = make<SpecialSubstitution>("std::iostream", "basic_iostream",
+                    "std::basic_iostream<char, std::char_traits<char> >");
+                break;
+            default:
+                return nullptr;
+        }
+        // Names the constructors like a source name
+        m_lastName = special->baseName();
+        return special;
+    }
+
+    size_t id{};
+    if (!parseSeqId(id) || id >= m_scratch.substitutions.size())
+    {
+        return nullptr;
+    }
+    return m_scratch.substitutions[id];
+}
+
+// T_ | T <number> _
+Node * ItaniumParser::parseTemplateParam()
+{
+    if (!consume('T'))
+    {
+        return nullptr;
+    }
+    size_t index = 0;
+    if (!consume('_'))
+    {
+        if (!parseNumber(index) || !consume('_'))
+        {
+            return nullptr;
+        }
+        ++index;
+    }
+
+    if (m_parsingLambdaParams)
+    {
+        auto * argument = make<ForwardTemplateReference>(index);
+        m_scratch.lambdaArguments.push_back(argument);
+        return make<AutoParamName>(index + 1, argument);
+    }
+
+    std::span<Node * const> const params = templateParams();
+    if (m_permitForwardReferences && index >= params.size())
+    {
+        auto * reference = make<ForwardTemplateReference>(index);
+        m_scratch.forwardReferences.push_back(reference);
+        return reference;
+    }
+    if (index >= params.size())
+    {
+        return nullptr;
+    }
+    return params[index];
+}
+
+// I <template-arg>+ E, the arguments of the name being demangled are what T_ refers to
+Node * ItaniumParser::parseTemplateArgs(bool tag)
+{
+    if (!consume('I'))
+    {
+        return nullptr;
+    }
+    if (tag)
+    {
+        m_scratch.templateParams.resize(m_paramsBegin);
+    }
+
+    // The source names of the arguments don't name the constructors
+    std::string_view const lastName = m_lastName;
+    size_t const args = mark();
+    while (!consume('E'))
+    {
+        Node * arg = parseTemplateArg();
+        if (!arg)
+        {
+            return nullptr;
+        }
+        push(arg);
+        if (tag)
+        {
+            Node * entry = arg;
+            if (arg->kind() == Node::Kind::TemplateArgumentPack)
+            {
+                entry = make<ParameterPack>(static_cast<TemplateArgumentPack *>(arg)->elements());
+            }
+            m_scratch.templateParams.push_back(entry);
+        }
+    }
+    m_lastName = lastName;
+    return make<TemplateArgs>(popArray(args));
+}
+
+Node * ItaniumParser::parseTemplateArg()
+{
+    DepthGuard depth{ *this };
+    if (depth.exceeded())
+    {
+        return nullptr;
+    }
+
+    switch (look())
+    {
+        case 'X':
+        {
+            ++m_pos;
+            Node * expression = parseExpression();
+            if (!expression || !consume('E'))
+            {
+                return nullptr;
+            }
+            return expression;
+        }
+        case 'I':  // GCC before 4.7
+        case 'J':
+        {
+            ++m_pos;
+            size_t const elements = mark();
+            while (!consume('E'))
+            {
+                Node * element = parseTemplateArg();
+                if (!element)
+                {
+                    return nullptr;
+                }
+                push(element);
+            }
+            return make<TemplateArgumentPack>(popArray(elements));
+        }
+        case 'L':
+            return parseExpressionPrimary();
+        default:
+            return parseType();
+    }
+}
+
+Node * ItaniumParser::parseType()
+{
+    DepthGuard depth{ *this };
+    if (depth.exceeded())
+    {
+        return nullptr;
+    }
+
+    Node * result = nullptr;
+    switch (look())
+    {
+        case 'r':
+        case 'V':
+        case 'K':
+            return parseQualifiedType();
+
+        case 'U':
+        {
+            ++m_pos;
+            Node * qualifier = parseSourceName();
+            if (!qualifier)
+            {
+                return nullptr;
+            }
+            Node * args = nullptr;
+            if (look() == 'I')
+            {
+                args = parseTemplateArgs(/*tag=*/false);
+                if (!args)
+                {
+                    return nullptr;
+                }
+            }
+            Node * child = parseType();
+            if (!child)
+            {
+                return nullptr;
+            }
+            result = make<VendorQualifiedType>(child, qualifier->baseName(), args);
+            break;
+        }
+
+        case 'D':
+            switch (look(1))
+            {
+                case 'o':
+                case 'O':
+                case 'w':
+                case 'x':
+                    return parseQualifiedType();
+                case 't':
+                case 'T':
+                    result = parseDecltype();
+                    break;
+                case 'p':
+                {
+                    m_pos += 2;
+                    Node * pattern = parseType();
+                    if (!pattern)
+                    {
+                        return nullptr;
+                    }
+                    result = make<PackExpansion>(pattern);
+                    break;
+                }
+                case 'v':
+                    result = parseVectorType();
+                    break;
+                default:
+                    return parseBuiltinType();
+            }
+            break;
+
+        case 'F':
+            result = parseFunctionType(FunctionTraits{});
+            break;
+
+        case 'A':
+            result = parseArrayType();
+            break;
+
+        case 'M':
+        {
+            ++m_pos;
+            Node * classType = parseType();
+            if (!classType)
+            {
+                return nullptr;
+            }
+            Node * memberType = parseType();
+            if (!memberType)
+            {
+                return nullptr;
+            }
+            result = make<PointerToMemberType>(classType, memberType);
+            break;
+        }
+
+        case 'T':
+        {
+            // The elaborated type specifiers aren't printed
+            if (look(1) == 's' || look(1) == 'u' || look(1) == 'e')
+            {
+                m_pos += 2;
+                result = parseName(nullptr);
+                break;
+            }
+            result = parseTemplateParam();
+            if (!result)
+            {
+                return nullptr;
+            }
+            // A template template parameter
+            if (m_tryTemplateArgs && look() == 'I')
+            {
+                addSubstitution(result);
+                Node * args = parseTemplateArgs(/*tag=*/false);
+                if (!args)
+                {
+                    return nullptr;
+                }
+                result = make<NameWithTemplateArgs>(result, args);
+            }
+            break;
+        }
+
+        case 'P':
+        case 'R':
+        case 'O':
+        case 'C':
+        case 'G':
+        {
+            char const kind = look();
+            ++m_pos;
+            Node * child = parseType();
+            if (!child)
+            {
+                return nullptr;
+            }
+            switch (kind)
+            {
+                case 'P':
+                    result = make<PointerType>(child);
+                    break;
+                case 'R':
+                case 'O':
+                    result = make<ReferenceType>(child, /*rvalue=*/kind == 'O');
+                    break;
+                case 'C':
+                    result = make<PostfixQualifiedType>(child, " _Complex");
+                    break;
+                default:
+                    result = make<PostfixQualifiedType>(child, " _Imaginary");
+                    break;
+            }
+            break;
+        }
+
+        case 'S':
+        {
+            char const next = look(1);
+            if (isDigit(next) || isUpper(next) || next == '_')
+            {
+                result = parseSubstitution();
+                if (!result)
+                {
+                    return nullptr;
+                }
+                // A substituted template name
+                if (look() != 'I' || !m_tryTemplateArgs)
+                {
+                    return result;
+                }
+                Node * args = parseTemplateArgs(/*tag=*/false);
+                if (!args)
+                {
+                    return nullptr;
+                }
+                result = make<NameWithTemplateArgs>(result, args);
+                break;
+            }
+            result = parseName(nullptr);
+            // A complete special substitution is not a new candidate
+            if (result && result->kind() == Node::Kind::SpecialSubstitution)
+            {
+                return result;
+            }
+            break;
+        }
+
+        case 'N':
+        case 'Z':
+            result = parseName(nullptr);
+            break;
+
+        default:
+            if (isDigit(look()))
+            {
+                result = parseName(nullptr);
+                break;
+            }
+            return parseBuiltinType();
+    }
+
+    if (result)
+    {
+        addSubstitution(result);
+    }
+    return result;
+}
+
+Node * ItaniumParser::parseBuiltinType()
+{
+    char const c = look();
+    ++m_pos;
+    switch (c)
+    {
+        case 'v': return makeName("void");
+        case 'w': return makeName("wchar_t");
+        case 'b': return makeName("bool");
+        case 'c': return makeName("char");
+        case 'a': return makeName("signed char");
+        case 'h': return makeName("unsigned char");
+        case 's': return makeName("short");
+        case 't': return makeName("unsigned short");
+        case 'i': return makeName("int");
+        case 'j': return makeName("unsigned int");
+        case 'l': return makeName("long");
+        case 'm': return makeName("unsigned long");
+        case 'x': return makeName("long long");
+        case 'y': return makeName("unsigned long long");
+        case 'n': return makeName("__int128");
+        case 'o': return makeName("unsigned __int128");
+        case 'f': return makeName("float");
+        case 'd': return makeName("double");
+        case 'e': return makeName("long double");
+        case 'g': return makeName("__float128");
+        case 'z': return makeName("...");
+        case 'u':
+        {
+            Node * vendorType = parseSourceName();
+            if (vendorType)
+            {
+                addSubstitution(vendorType);
+            }
+            return vendorType;
+        }
+        case 'D':
+        {
+            char const d = look();
+            ++m_pos;
+            switch (d)
+            {
+                case 'd': return makeName("decimal64");
+                case 'e': return makeName("decimal128");
+                case 'f': return makeName("decimal32");
+                case 'h': return makeName("half");
+                case 'i': return makeName("char32_t");
+                case 's': return makeName("char16_t");
+                case 'u': return makeName("char8_t");
+                case 'a': return makeName("auto");
+                case 'c': return makeName("decltype(auto)");
+                case 'n': return makeName("decltype(nullptr)");
+                case 'F':
+                {
+                    // _FloatN
+                    size_t const start = m_pos - 2;
+                    if (parseDigits().empty())
+                    {
+                        return nullptr;
+                    }
+                    std::string_view const bits = m_text.substr(start + 2, m_pos - start - 2);
+                    if (consume('x'))
+                    {
+                        return makeName(concat("_Float", bits, "x"));
+                    }
+                    if (!consume('_'))
+                    {
+                        return nullptr;
+                    }
+                    return makeName(concat("_Float", bits, ""));
+                }
+                default:
+                    return nullptr;
+            }
+        }
+        default:
+            return nullptr;
+    }
+}
+
+// <CV-qualifiers> <type>, the qualifiers and the exception specification of a function type
+// belong to the function itself
+Node * ItaniumParser::parseQualifiedType()
+{
+    uint8_t qualifiers = QualNone;
+    if (consume('r'))
+    {
+        qualifiers |= QualRestrict;
+    }
+    if (consume('V'))
+    {
+        qualifiers |= QualVolatile;
+    }
+    if (consume('K'))
+    {
+        qualifiers |= QualConst;
+    }
+
+    FunctionTraits traits{ .qualifiers = qualifiers };
+    if (consume("Do"))
+    {
+        traits.exceptionSpec = makeName("noexcept");
+    }
+    else if (consume("DO"))
+    {
+        Node * condition = parseExpression();
+        if (!condition || !consume('E'))
+        {
+            return nullptr;
+        }
+        traits.exceptionSpec = make<EnclosingExpression>("noexcept(", condition, ")");
+    }
+    else if (consume("Dw"))
+    {
+        size_t const types = mark();
+        while (!consume('E'))
+        {
+            Node * type = parseType();
+            if (!type)
+            {
+                return nullptr;
+            }
+            push(type);
+        }
+        traits.exceptionSpec = make<EnclosingExpression>("throw(", make<TemplateArgumentPack>(popArray(types)), ")");
+    }
+    // transaction_safe isn't printed
+    consume("Dx");
+
+    Node * result = nullptr;
+    if (look() == 'F')
+    {
+        // The unqualified function type isn't a substitution candidate
+        result = parseFunctionType(traits);
+    }
+    else if (traits.exceptionSpec)
+    {
+        return nullptr;
+    }
+    else
+    {
+        Node * child = parseType();
+        if (!child)
+        {
+            return nullptr;
+        }
+        result = qualifiers ? make<QualifiedType>(child, qualifiers) : child;
+    }
+
+    if (result)
+    {
+        addSubstitution(result);
+    }
+    return result;
+}
+
+// F [Y] <return type> <parameter types> [<ref-qualifier>] E
+Node * ItaniumParser::parseFunctionType(FunctionTraits traits)
+{
+    if (!consume('F'))
+    {
+        return nullptr;
+    }
+    consume('Y');
+
+    Node * returnType = parseType();
+    if (!returnType)
+    {
+        return nullptr;
+    }
+
+    size_t const params = mark();
+    while (true)
+    {
+        if (consume('E'))
+        {
+            break;
+        }
+        if (consume('v'))
+        {
+            continue;
+        }
+        if (consume("RE"))
+        {
+            traits.refQualifier = RefQualifier::LValue;
+            break;
+        }
+        if (consume("OE"))
+        {
+            traits.refQualifier = RefQualifier::RValue;
+            break;
+        }
+        if (atEnd())
+        {
+            return nullptr;
+        }
+        Node * param = parseType();
+        if (!param)
+        {
+            return nullptr;
+        }
+        push(param);
+    }
+
+    return make<FunctionType>(returnType, popArray(params), traits);
+}
+
+// A <number> _ <type> | A [<expression>] _ <type>
+Node * ItaniumParser::parseArrayType()
+{
+    if (!consume('A'))
+    {
+        return nullptr;
+    }
+
+    Node * dimension = nullptr;
+    if (isDigit(look()))
+    {
+        dimension = makeName(parseDigits());
+    }
+    else if (look() != '_')
+    {
+        dimension = parseExpression();
+        if (!dimension)
+        {
+            return nullptr;
+        }
+    }
+    if (!consume('_'))
+    {
+        return nullptr;
+    }
+
+    Node * element = parseType();
+    if (!element)
+    {
+        return nullptr;
+    }
+    return make<ArrayType>(element, dimension);
+}
+
+// Dv <number> _ <type> | Dv _ <expression> _ <type>
+Node * ItaniumParser::parseVectorType()
+{
+    if (!consume("Dv"))
+    {
+        return nullptr;
+    }
+
+    Node * dimension = nullptr;
+    if (isDigit(look()))
+    {
+        dimension = makeName(parseDigits());
+    }
+    else if (consume('_'))
+    {
+        dimension = parseExpression();
+        if (!dimension)
+        {
+            return nullptr;
+        }
+    }
+    if (!consume('_'))
+    {
+        return nullptr;
+    }
+
+    Node * element = parseType();
+    if (!element)
+    {
+        return nullptr;
+    }
+    return make<VectorType>(element, dimension);
+}
+
+// Dt <expression> E | DT <expression> E
+Node * ItaniumParser::parseDecltype()
+{
+    if (!consume("Dt") && !consume("DT"))
+    {
+        return nullptr;
+    }
+    Node * expression = parseExpression();
+    if (!expression || !consume('E'))
+    {
+        return nullptr;
+    }
+    return make<EnclosingExpression>("decltype (", expression, ")");
+}
+
+Node * ItaniumParser::parseExpression()
+{
+    DepthGuard depth{ *this };
+    if (depth.exceeded())
+    {
+        return nullptr;
+    }
+
+    char const first = look();
+    char const second = look(1);
+
+    if (first == 'L')
+    {
+        return parseExpressionPrimary();
+    }
+    if (first == 'T')
+    {
+        return parseTemplateParam();
+    }
+    if (first == 'f')
+    {
+        if (second == 'p' || (second == 'L' && isDigit(look(2))))
+        {
+            return parseFunctionParam();
+        }
+        return parseFoldExpression();
+    }
+    if (isDigit(first) || (first == 'o' && second == 'n') || (first == 'd' && second == 'n') ||
+        (first == 's' && second == 'r') || (first == 'g' && second == 's' && look(2) == 's' && look(3) == 'r'))
+    {
+        return parseUnresolvedName();
+    }
+
+    bool const global = first == 'g' && second == 's';
+    if (global)
+    {
+        m_pos += 2;
+    }
+
+    char const op0 = look();
+    char const op1 = look(1);
+    // <expression>* E, pushed to be popped by the caller
+    auto parseList = [this]() -> bool
+    {
+        while (!consume('E'))
+        {
+            Node * element = parseExpression();
+            if (!element)
+            {
+                return false;
+            }
+            push(element);
+        }
+        return true;
+    };
+
+    if ((op0 == 'n' && (op1 == 'w' || op1 == 'a')))
+    {
+        m_pos += 2;
+        return parseNewExpression(global, op1 == 'a');
+    }
+    if (op0 == 'd' && (op1 == 'l' || op1 == 'a'))
+    {
+        m_pos += 2;
+        Node * operand = parseExpression();
+        if (!operand)
+        {
+            return nullptr;
+        }
+        std::string_view prefix = op1 == 'a' ? (global ? "::delete[] " : "delete[] ") : (global ? "::delete " : "delete ");
+        return make<PrefixExpression>(prefix, operand);
+    }
+    if (global)
+    {
+        return nullptr;
+    }
+
+    if (op0 == 'c' && op1 == 'v')
+    {
+        m_pos += 2;
+        Node * type = nullptr;
+        {
+            Flag noTemplateArgs{ m_tryTemplateArgs, false };
+            type = parseType();
+        }
+        if (!type)
+        {
+            return nullptr;
+        }
+        size_t const args = mark();
+        if (consume('_'))
+        {
+            if (!parseList())
+            {
+                return nullptr;
+            }
+            return make<ConversionExpression>(type, popArray(args), /*list=*/true);
+        }
+        Node * operand = parseExpression();
+        if (!operand)
+        {
+            return nullptr;
+        }
+        push(operand);
+        return make<ConversionExpression>(type, popArray(args), /*list=*/false);
+    }
+
+    // sizeof, alignof, typeid, noexcept, throw and the packs
+    if (op0 == 's' || op0 == 'a' || op0 == 't' || op0 == 'n')
+    {
+        auto typeOperand = [this](std::string_view prefix) -> Node *
+        {
+            m_pos += 2;
+            Node * type = parseType();
+            return type ? make<EnclosingExpression>(prefix, type, ")") : nullptr;
+        };
+        auto expressionOperand = [this](std::string_view prefix) -> Node *
+        {
+            m_pos += 2;
+            Node * operand = parseExpression();
+            return operand ? make<PrefixExpression>(prefix, operand) : nullptr;
+        };
+
+        switch ((op0 << 8) | op1)
+        {
+            case ('s' << 8) | 't': return typeOperand("sizeof (");
+            case ('s' << 8) | 'z': return expressionOperand("sizeof ");
+            case ('a' << 8) | 't': return typeOperand("alignof (");
+            case ('a' << 8) | 'z': return expressionOperand("alignof ");
+            case ('t' << 8) | 'i': return typeOperand("typeid (");
+            case ('t' << 8) | 'e':
+            {
+                m_pos += 2;
+                Node * operand = parseExpression();
+                return operand ? make<EnclosingExpression>("typeid (", operand, ")") : nullptr;
+            }
+            case ('n' << 8) | 'x':
+            {
+                m_pos += 2;
+                Node * operand = parseExpression();
+                return operand ? make<EnclosingExpression>("noexcept (", operand, ")") : nullptr;
+            }
+            case ('t' << 8) | 'w': return expressionOperand("throw ");
+            case ('t' << 8) | 'r':
+                m_pos += 2;
+                return makeName("throw");
+            case ('s' << 8) | 'p':
+            {
+                m_pos += 2;
+                Node * pattern = parseExpression();
+                return pattern ? make<PackExpansion>(pattern) : nullptr;
+            }
+            case ('s' << 8) | 'Z':
+            {
+                m_pos += 2;
+                Node * pack = look() == 'T' ? parseTemplateParam() : parseFunctionParam();
+                return pack ? make<SizeofPackExpression>(pack) : nullptr;
+            }
+            case ('s' << 8) | 'P':
+            {
+                m_pos += 2;
+                size_t const args = mark();
+                while (!consume('E'))
+                {
+                    Node * arg = parseTemplateArg();
+                    if (!arg)
+                    {
+                        return nullptr;
+                    }
+                    push(arg);
+                }
+                return make<EnclosingExpression>("sizeof...(", make<TemplateArgumentPack>(popArray(args)), ")");
+            }
+            case ('t' << 8) | 'l':
+            {
+                m_pos += 2;
+                Node * type = parseType();
+                size_t const inits = mark();
+                if (!type || !parseList())
+                {
+                    return nullptr;
+                }
+                return make<InitListExpression>(type, popArray(inits));
+            }
+            default:
+                break;
+        }
+    }
+    if (op0 == 'i' && op1 == 'l')
+    {
+        m_pos += 2;
+        size_t const inits = mark();
+        if (!parseList())
+        {
+            return nullptr;
+        }
+        return make<InitListExpression>(nullptr, popArray(inits));
+    }
+
+    OperatorInfo const * info = findOperator(op0, op1);
+    if (!info)
+    {
+        return nullptr;
+    }
+    m_pos += 2;
+
+    switch (info->kind)
+    {
+        case OperatorKind::Binary:
+        case OperatorKind::Member:
+        case OperatorKind::Subscript:
+        {
+            Node * left = parseExpression();
+            if (!left)
+            {
+                return nullptr;
+            }
+            Node * right = parseExpression();
+            if (!right)
+            {
+                return nullptr;
+            }
+            if (info->kind == OperatorKind::Member)
+            {
+                return make<MemberExpression>(left, info->symbol, right);
+            }
+            if (info->kind == OperatorKind::Subscript)
+            {
+                return make<MemberExpression>(left, "[", right, "]");
+            }
+            return make<BinaryExpression>(left, info->symbol, right);
+        }
+        case OperatorKind::Prefix:
+        {
+            Node const * operand = parseExpression();
+            if (!operand)
+            {
+                return nullptr;
+            }
+            // "&A::f", the parameters of an unqualified member function aren't printed when its address is taken
+            if (op0 == 'a' && op1 == 'd' && operand->kind() == Node::Kind::Encoding)
+            {
+                auto const * encoding = static_cast<FunctionEncoding const *>(operand);
+                FunctionTraits const & traits = encoding->traits();
+                if (!encoding->returnType() && encoding->name()->kind() == Node::Kind::Nested &&
+                    traits.qualifiers == QualNone && traits.refQualifier == RefQualifier::None)
+                {
+                    operand = encoding->name();
+                }
+            }
+            return make<PrefixExpression>(info->symbol, operand);
+        }
+        case OperatorKind::Increment:
+        {
+            bool const prefix = consume('_');
+            Node * operand = parseExpression();
+            if (!operand)
+            {
+                return nullptr;
+            }
+            if (prefix)
+            {
+                return make<PrefixExpression>(info->symbol, operand);
+            }
+            return make<PostfixExpression>(operand, info->symbol);
+        }
+        case OperatorKind::Call:
+        {
+            Node * callee = parseExpression();
+            size_t const args = mark();
+            if (!callee || !parseList())
+            {
+                return nullptr;
+            }
+            return make<CallExpression>(callee, popArray(args));
+        }
+        case OperatorKind::Conditional:
+        {
+            Node * condition = parseExpression();
+            Node * then = condition ? parseExpression() : nullptr;
+            Node * otherwise = then ? parseExpression() : nullptr;
+            if (!otherwise)
+            {
+                return nullptr;
+            }
+            return make<ConditionalExpression>(condition, then, otherwise);
+        }
+        case OperatorKind::NamedCast:
+        {
+            Node * type = parseType();
+            Node * operand = type ? parseExpression() : nullptr;
+            if (!operand)
+            {
+                return nullptr;
+            }
+            return make<NamedCastExpression>(info->symbol, type, operand);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+// nw <expression>* _ <type> [pi <expression>* | <braced init>] E
+Node * ItaniumParser::parseNewExpression(bool global, bool array)
+{
+    size_t const placement = mark();
+    while (!consume('_'))
+    {
+        Node * expression = parseExpression();
+        if (!expression)
+        {
+            return nullptr;
+        }
+        push(expression);
+    }
+    NodeArray const placementArgs = popArray(placement);
+
+    Node * type = parseType();
+    if (!type)
+    {
+        return nullptr;
+    }
+
+    size_t const inits = mark();
+    bool hasInit = false;
+    if (consume("pi"))
+    {
+        hasInit = true;
+        while (look() != 'E')
+        {
+            Node * init = parseExpression();
+            if (!init)
+            {
+                return nullptr;
+            }
+            push(init);
+        }
+    }
+    else if (look() == 'i' && look(1) == 'l')
+    {
+        Node * init = parseExpression();
+        if (!init)
+        {
+            return nullptr;
+        }
+        push(init);
+        hasInit = true;
+    }
+    if (!consume('E'))
+    {
+        return nullptr;
+    }
+    return make<NewExpression>(global, array, placementArgs, type, popArray(inits), hasInit);
+}
+
+// fl <op> <pack> | fr <op> <pack> | fL <op> <init> <pack> | fR <op> <pack> <init>
+Node * ItaniumParser::parseFoldExpression()
+{
+    if (!consume('f'))
+    {
+        return nullptr;
+    }
+    char const kind = look();
+    if (kind != 'l' && kind != 'r' && kind != 'L' && kind != 'R')
+    {
+        return nullptr;
+    }
+    ++m_pos;
+
+    OperatorInfo const * info = findOperator(look(), look(1));
+    if (!info || info->kind != OperatorKind::Binary)
+    {
+        return nullptr;
+    }
+    m_pos += 2;
+
+    Node * first = parseExpression();
+    if (!first)
+    {
+        return nullptr;
+    }
+    switch (kind)
+    {
+        case 'l':
+            return make<FoldExpression>(first, info->symbol, nullptr, /*left=*/true);
+        case 'r':
+            return make<FoldExpression>(first, info->symbol, nullptr, /*left=*/false);
+        default:
+        {
+            Node * second = parseExpression();
+            if (!second)
+            {
+                return nullptr;
+            }
+            return kind == 'L'
+                ? make<FoldExpression>(second, info->symbol, first, /*left=*/true)
+                : make<FoldExpression>(first, info->symbol, second, /*left=*/false);
+        }
+    }
+}
+
+// fp <CV-qualifiers> [<number>] _ | fL <number> p <CV-qualifiers> [<number>] _
+Node * ItaniumParser::parseFunctionParam()
+{
+    if (consume("fL"))
+    {
+        if (parseDigits().empty() || !consume('p'))
+        {
+            return nullptr;
+        }
+    }
+    else if (!consume("fp"))
+    {
+        return nullptr;
+    }
+
+    consume('r');
+    consume('V');
+    consume('K');
+    size_t number = 0;
+    if (isDigit(look()))
+    {
+        if (!parseNumber(number))
+        {
+            return nullptr;
+        }
+        ++number;
+    }
+    if (!consume('_'))
+    {
+        return nullptr;
+    }
+    return make<FunctionParam>(number + 1);
+}
+
+// The names of the dependent expressions, printed as they are qualified
+Node * ItaniumParser::parseUnresolvedName()
+{
+    bool const global = consume("gs");
+
+    auto parseBaseName = [this]() -> Node *
+    {
+        Node * name = nullptr;
+        if (consume("on"))
+        {
+            name = parseOperatorName(nullptr);
+        }
+        else if (consume("dn"))
+        {
+            Node * type = isDigit(look()) ? parseSourceName() : parseType();
+            name = type ? make<PrefixExpression>("~", type) : nullptr;
+        }
+        else
+        {
+            name = parseSourceName();
+        }
+        if (name && look() == 'I')
+        {
+            Node * args = parseTemplateArgs(/*tag=*/false);
+            name = args ? make<NameWithTemplateArgs>(name, args) : nullptr;
+        }
+        return name;
+    };
+
+    Node * result = nullptr;
+    if (consume("sr"))
+    {
+        if (m_legacyUnresolvedNames || !isDigit(look()))
+        {
+            // sr <unresolved-type> <base-unresolved-name>, srN...E is parsed as a nested type
+            Node * scope = parseType();
+            Node * name = scope ? parseBaseName() : nullptr;
+            if (!name)
+            {
+                return nullptr;
+            }
+            result = make<NestedName>(scope, name);
+        }
+        else
+        {
+            // sr <unresolved-qualifier-level>+ E <base-unresolved-name> is ambiguous with the older
+            // sr <type> <base-unresolved-name>, whose scope was a substitution candidate.
+            // The newer form goes first, the whole name is parsed again with the older one if it fails
+            m_triedQualifierLevels = true;
+            Node * scope = nullptr;
+            while (!consume('E'))
+            {
+                Node * level = nullptr;
+                if (look() == 'I')
+                {
+                    Node * args = scope ? parseTemplateArgs(/*tag=*/false) : nullptr;
+                    level = args ? make<NameWithTemplateArgs>(scope, args) : nullptr;
+                }
+                else
+                {
+                    Node * name = parseSourceName();
+                    level = !name ? nullptr : scope ? make<NestedName>(scope, name) : name;
+                }
+                if (!level)
+                {
+                    return nullptr;
+                }
+                scope = level;
+            }
+            Node * name = parseBaseName();
+            if (!name)
+            {
+                return nullptr;
+            }
+            result = make<NestedName>(scope, name);
+        }
+    }
+    else
+    {
+        result = parseBaseName();
+    }
+
+    if (result && global)
+    {
+        result = make<PrefixExpression>("::", result);
+    }
+    return result;
+}
+
+// L <type> <value> E | L <mangled-name> E
+Node * ItaniumParser::parseExpressionPrimary()
+{
+    if (!consume('L'))
+    {
+        return nullptr;
+    }
+
+    if (look() == '_' && look(1) == 'Z')
+    {
+        m_pos += 2;
+        Node * encoding = parseEncoding();
+        if (!encoding || !consume('E'))
+        {
+            return nullptr;
+        }
+        return encoding;
+    }
+    if (look() == 'Z')
+    {
+        ++m_pos;
+        Node * encoding = parseEncoding();
+        if (!encoding || !consume('E'))
+        {
+            return nullptr;
+        }
+        return encoding;
+    }
+
+    Literal::Style style = Literal::Style::Cast;
+    std::string_view suffix;
+    switch (look())
+    {
+        case 'i': style = Literal::Style::Plain; break;
+        case 'j': style = Literal::Style::Suffixed; suffix = "u"; break;
+        case 'l': style = Literal::Style::Suffixed; suffix = "l"; break;
+        case 'm': style = Literal::Style::Suffixed; suffix = "ul"; break;
+        case 'x': style = Literal::Style::Suffixed; suffix = "ll"; break;
+        case 'y': style = Literal::Style::Suffixed; suffix = "ull"; break;
+        case 'b': style = Literal::Style::Bool; break;
+        case 'f':
+        case 'd':
+        case 'e':
+        case 'g':
+            style = Literal::Style::Float;
+            break;
+        default:
+            break;
+    }
+
+    Node * type = parseType();
+    if (!type)
+    {
+        return nullptr;
+    }
+    bool const negative = consume('n');
+    size_t const start = m_pos;
+    while (!atEnd() && look() != 'E')
+    {
+        ++m_pos;
+    }
+    std::string_view const value = m_text.substr(start, m_pos - start);
+    if (!consume('E'))
+    {
+        return nullptr;
+    }
+    return make<Literal>(type, value, negative, style, suffix);
+}
+
+// The demangler state is kept per thread, the scanner demangles from all of its workers
+static Scratch & threadScratch()
+{
+    thread_local Scratch scratch;
+    return scratch;
+}
+
+static bool demangle(std::string_view name, std::string & output, Scratch & scratch)
+{
+    output.clear();
+    if (!name.starts_with("_Z"))
+    {
+        return false;
+    }
+
+    scratch.reset();
+
+    ItaniumParser parser{ name, scratch, /*legacyUnresolvedNames=*/false };
+    Node const * root = parser.parseMangledName();
+    if (!root && parser.triedQualifierLevels())
+    {
+        scratch.reset();
+        root = ItaniumParser{ name, scratch, /*legacyUnresolvedNames=*/true }.parseMangledName();
+    }
+    if (!root)
+    {
+        return false;
+    }
+
+    Printer printer{ output };
+    root->print(printer);
+    return true;
+}
+
+bool GCCDemangler::demangleInto(std::string_view name, std::string & output) const
+{
+    return demangle(name, output, threadScratch());
+}
+
+void GCCDemangler::demangleBatch(std::span<std::string_view const> names, std::span<std::string> outputs) const
+{
+    Scratch & scratch = threadScratch();
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        demangle(names[i], outputs[i], scratch);
+    }
+}
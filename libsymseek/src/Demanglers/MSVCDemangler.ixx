@@ -0,0 +1,1412 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek:demanglers.msvc;
+
+import <array>;
+import <charconv>;
+import <cstddef>;
+import <cstdint>;
+import <initializer_list>;
+import <span>;
+import <string>;
+import <string_view>;
+import <utility>;
+import <vector>;
+
+import symseek.interfaces.demangler;
+import symseek.internal.arena;
+
+export namespace SymSeek
+{
+    // Microsoft Visual C++ decorated names, printed the way UnDecorateSymbolName does with
+    // UNDNAME_NO_MS_KEYWORDS | UNDNAME_NO_LEADING_UNDERSCORES: "public: int Foo::bar(char const *)const ".
+    // Doesn't depend on DbgHelp, so the Windows binaries are demangled on any platform.
+    class MSVCDemangler : public IDemangler
+    {
+    public:
+        bool demangleInto(std::string_view name, std::string & output) const override;
+        void demangleBatch(std::span<std::string_view const> names, std::span<std::string> outputs) const override;
+    };
+}
+
+// Implementation
+
+using namespace SymSeek;
+
+namespace
+{
+    using detail::Arena;
+
+    // A type is printed around the declared name, "int (*" name ")[3]"
+    struct Type
+    {
+        std::string_view left;
+        std::string_view right;
+
+        bool empty() const noexcept
+        {
+            return left.empty() && right.empty();
+        }
+    };
+
+    struct Signature
+    {
+        Type returnType;
+        // "(int,char)"
+        std::string_view arguments;
+        // "const " of the methods, " noexcept"
+        std::string_view qualifiers;
+    };
+
+    // The digits refer to the first ten names, or parameter types, met in the current context
+    template<typename T>
+    class BackReferences
+    {
+    public:
+        void add(T const & value) noexcept
+        {
+            if (m_size < m_values.size())
+            {
+                m_values[m_size++] = value;
+            }
+        }
+
+        T const * find(char digit) const noexcept
+        {
+            size_t const index = static_cast<size_t>(digit - '0');
+            return index < m_size ? &m_values[index] : nullptr;
+        }
+
+        bool contains(T const & value) const noexcept
+        {
+            for (size_t i = 0; i < m_size; ++i)
+            {
+                if (m_values[i] == value)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        std::array<T, 10> m_values{};
+        size_t m_size = 0;
+    };
+
+    struct Scratch
+    {
+        Arena arena;
+        // The components of the qualified names being parsed, innermost first
+        std::vector<std::string_view> scopes;
+        // The template and function arguments being parsed
+        std::vector<std::string_view> arguments;
+
+        void reset() noexcept
+        {
+            arena.reset();
+            scopes.clear();
+            arguments.clear();
+        }
+    };
+
+    enum class SpecialName: uint8_t
+    {
+        None,
+        Constructor,
+        Destructor,
+        Conversion,
+        // "`dynamic initializer for 'x''", the function follows the name of the variable
+        Initializer,
+        // "`string'", the rest of the name is the hash and the beginning of the literal
+        StringLiteral
+    };
+
+    // The names after "??" from '0' to 'Z', the constructors, the destructors and the conversions are special
+    constexpr std::string_view operatorNames[] = {
+        {}, {}, "operator new", "operator delete", "operator=", "operator>>", "operator<<", "operator!",
+        "operator==", "operator!=", "operator[]", {}, "operator->", "operator*", "operator++", "operator--",
+        "operator-", "operator+", "operator&", "operator->*", "operator/", "operator%", "operator<", "operator<=",
+        "operator>", "operator>=", "operator,", "operator()", "operator~", "operator^", "operator|", "operator&&",
+        "operator||", "operator*=", "operator+=", "operator-=",
+    };
+
+    // After "??_", from '0' to 'Z'
+    constexpr std::string_view extendedOperatorNames[] = {
+        "operator/=", "operator%=", "operator>>=", "operator<<=", "operator&=", "operator|=", "operator^=",
+        "`vftable'", "`vbtable'", "`vcall'", "`typeof'", "`local static guard'", /*C*/ {}, "`vbase destructor'",
+        "`vector deleting destructor'", "`default constructor closure'", "`scalar deleting destructor'",
+        "`vector constructor iterator'", "`vector destructor iterator'", "`vector vbase constructor iterator'",
+        "`virtual displacement map'", "`eh vector constructor iterator'", "`eh vector destructor iterator'",
+        "`eh vector vbase constructor iterator'", "`copy constructor closure'", /*P*/ {}, /*Q*/ {}, /*R*/ {},
+        "`local vftable'", "`local vftable constructor closure'", "operator new[]", "operator delete[]", /*W*/ {},
+        "`placement delete closure'", "`placement delete[] closure'", /*Z*/ {},
+    };
+
+    // After "??__", from 'A' to 'M'
+    constexpr std::string_view doubleExtendedOperatorNames[] = {
+        "`managed vector constructor iterator'", "`managed vector destructor iterator'",
+        "`eh vector copy constructor iterator'", "`eh vector vbase copy constructor iterator'",
+        "`dynamic initializer for '", "`dynamic atexit destructor for '", "`vector copy constructor iterator'",
+        "`vector vbase copy constructor iterator'", "`managed vector copy constructor iterator'",
+        "`local static thread guard'", "operator \"\" ", "operator co_await", "operator<=>",
+    };
+
+    constexpr std::string_view rttiNames[] = {
+        /*0*/ {}, "`RTTI Base Class Descriptor at (", "`RTTI Base Class Array'", "`RTTI Class Hierarchy Descriptor'",
+        "`RTTI Complete Object Locator'",
+    };
+
+    // The base types from 'C' to 'O' by their codes
+    constexpr std::string_view basicTypes[] = {
+        "signed char", "char", "unsigned char", "short", "unsigned short", "int", "unsigned int", "long",
+        "unsigned long", {}, "float", "double", "long double",
+    };
+
+    // The extended base types after '_'
+    std::string_view extendedType(char code) noexcept
+    {
+        switch (code)
+        {
+            case 'D': return "__int8";
+            case 'E': return "unsigned __int8";
+            case 'F': return "__int16";
+            case 'G': return "unsigned __int16";
+            case 'H': return "__int32";
+            case 'I': return "unsigned __int32";
+            case 'J': return "__int64";
+            case 'K': return "unsigned __int64";
+            case 'L': return "__int128";
+            case 'M': return "unsigned __int128";
+            case 'N': return "bool";
+            case 'Q': return "char8_t";
+            case 'S': return "char16_t";
+            case 'U': return "char32_t";
+            case 'W': return "wchar_t";
+            default:  return {};
+        }
+    }
+
+    bool isDigit(char c) noexcept
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    class MicrosoftParser
+    {
+    public:
+        MicrosoftParser(std::string_view mangled, Scratch & scratch) noexcept
+        : m_text   { mangled }
+        , m_scratch{ scratch }
+        {
+        }
+
+        // The whole text has to be a symbol
+        bool parseMangledName(std::string_view & result)
+        {
+            return parseSymbol(result) && atEnd();
+        }
+
+    private:
+        struct Context
+        {
+            BackReferences<std::string_view> names;
+            BackReferences<Type> types;
+        };
+
+        // The template arguments and the nested symbols have their own back references
+        class ContextScope
+        {
+        public:
+            explicit ContextScope(MicrosoftParser & parser) noexcept
+            : m_parser { parser                                  }
+            , m_context{ std::exchange(parser.m_context, Context{}) }
+            {
+            }
+
+            ~ContextScope()
+            {
+                m_parser.m_context = m_context;
+            }
+
+        private:
+            MicrosoftParser & m_parser;
+            Context m_context;
+        };
+
+        class DepthGuard
+        {
+        public:
+            explicit DepthGuard(MicrosoftParser & parser) noexcept : m_parser{ parser }
+            {
+                ++parser.m_depth;
+            }
+
+            ~DepthGuard()
+            {
+                --m_parser.m_depth;
+            }
+
+            bool exceeded() const noexcept
+            {
+                return m_parser.m_depth > MaxDepth;
+            }
+
+        private:
+            MicrosoftParser & m_parser;
+        };
+
+        static constexpr unsigned MaxDepth = 128;
+
+        bool parseSymbol(std::string_view & result);
+        bool parseOperatorName(std::string_view & name, SpecialName & special);
+        bool parseQualifiedName(std::string_view & result, bool memorizeTemplate);
+        bool parseNamePiece(std::string_view & piece, bool memorizeTemplate);
+        bool parseTemplateName(std::string_view & result);
+        bool parseSimpleName(std::string_view & result, bool memorize);
+        bool parseNumber(std::string_view & result);
+        bool parseNumber(int64_t & result);
+        bool parseData(std::string_view name, std::string_view & result);
+        bool parseMethod(std::string_view name, SpecialName special, std::string_view & result);
+        bool parseFunctionSignature(Signature & result, bool hasThis);
+        bool parseArguments(std::string_view & result, bool function);
+        bool parseType(Type & result, bool inArguments);
+        bool parseModifiedType(Type & result, char code, bool inArguments);
+        bool parseModifier(std::string_view & result);
+        bool parseExtendedType(Type & result, bool inArguments);
+        bool parseTemplateParameter(Type & result, std::string_view prefix);
+
+        bool atEnd() const noexcept
+        {
+            return m_pos >= m_text.size();
+        }
+
+        char look(size_t ahead = 0) const noexcept
+        {
+            return m_pos + ahead < m_text.size() ? m_text[m_pos + ahead] : '\0';
+        }
+
+        char next() noexcept
+        {
+            return atEnd() ? '\0' : m_text[m_pos++];
+        }
+
+        bool consume(char c) noexcept
+        {
+            if (look() != c)
+            {
+                return false;
+            }
+            ++m_pos;
+            return true;
+        }
+
+        bool consume(std::string_view prefix) noexcept
+        {
+            if (!m_text.substr(m_pos).starts_with(prefix))
+            {
+                return false;
+            }
+            m_pos += prefix.size();
+            return true;
+        }
+
+        std::string_view concat(std::initializer_list<std::string_view> parts)
+        {
+            size_t size = 0;
+            for (std::string_view part: parts)
+            {
+                size += part.size();
+            }
+            auto * data = static_cast<char *>(m_scratch.arena.allocate(size, 1));
+            size_t offset = 0;
+            for (std::string_view part: parts)
+            {
+                offset += part.copy(data + offset, part.size());
+            }
+            return { data, size };
+        }
+
+        // Joins the items pushed since the mark, in the reverse order for the scopes
+        std::string_view join(std::vector<std::string_view> & items, size_t mark, std::string_view separator,
+            bool reversed)
+        {
+            size_t size = 0;
+            for (size_t i = mark; i < items.size(); ++i)
+            {
+                size += items[i].size() + (i > mark ? separator.size() : 0);
+            }
+            auto * data = static_cast<char *>(m_scratch.arena.allocate(size, 1));
+            size_t offset = 0;
+            for (size_t i = mark; i < items.size(); ++i)
+            {
+                if (i > mark)
+                {
+                    offset += separator.copy(data + offset, separator.size());
+                }
+                std::string_view const item = reversed ? items[items.size() - 1 - (i - mark)] : items[i];
+                offset += item.copy(data + offset, item.size());
+            }
+            items.resize(mark);
+            return { data, size };
+        }
+
+        std::string_view m_text;
+        size_t m_pos = 0;
+        Scratch & m_scratch;
+        Context m_context;
+        unsigned m_depth = 0;
+    };
+
+    bool MicrosoftParser::parseSymbol(std::string_view & result)
+    {
+        DepthGuard depth{ *this };
+        if (depth.exceeded() || !consume('?'))
+        {
+            return false;
+        }
+
+        // "?$name@args@", a template instance alone
+        if (look() == '$')
+        {
+            ++m_pos;
+            return parseTemplateName(result);
+        }
+
+        size_t const mark = m_scratch.scopes.size();
+        std::string_view name;
+        SpecialName special = SpecialName::None;
+        if (look() == '?' && (look(1) != '$' || look(2) == '?'))
+        {
+            // "??$?..." is a template operator
+            ++m_pos;
+            bool const templated = consume("$?");
+            if (!parseOperatorName(name, special))
+            {
+                return false;
+            }
+            if (special == SpecialName::StringLiteral)
+            {
+                m_pos = m_text.size();
+                result = name;
+                return true;
+            }
+            if (special == SpecialName::Initializer)
+            {
+                return parseMethod(name, special, result);
+            }
+            if (templated)
+            {
+                ContextScope context{ *this };
+                std::string_view arguments;
+                if (!parseArguments(arguments, /*function=*/false))
+                {
+                    return false;
+                }
+                name = concat({ name, arguments });
+            }
+            m_scratch.scopes.push_back(name);
+        }
+        else if (std::string_view piece; parseNamePiece(piece, /*memorizeTemplate=*/false))
+        {
+            m_scratch.scopes.push_back(piece);
+        }
+        else
+        {
+            return false;
+        }
+
+        while (!consume('@'))
+        {
+            std::string_view piece;
+            if (atEnd() || !parseNamePiece(piece, /*memorizeTemplate=*/true))
+            {
+                return false;
+            }
+            m_scratch.scopes.push_back(piece);
+        }
+
+        if (special == SpecialName::Constructor || special == SpecialName::Destructor)
+        {
+            if (m_scratch.scopes.size() - mark < 2)
+            {
+                return false;
+            }
+            // The piece holds the template arguments of a constructor template, if any
+            std::string_view & piece = m_scratch.scopes[mark];
+            piece = concat({ special == SpecialName::Destructor ? "~" : "", m_scratch.scopes[mark + 1], piece });
+        }
+        name = join(m_scratch.scopes, mark, "::", /*reversed=*/true);
+
+        if (isDigit(look()))
+        {
+            return parseData(name, result);
+        }
+        return parseMethod(name, special, result);
+    }
+
+    bool MicrosoftParser::parseOperatorName(std::string_view & name, SpecialName & special)
+    {
+        char const code = next();
+        if (code == '0' || code == '1')
+        {
+            // The class name is put in place once the scope is known
+            special = code == '0' ? SpecialName::Constructor : SpecialName::Destructor;
+            name = {};
+            return true;
+        }
+        if (code == 'B')
+        {
+            special = SpecialName::Conversion;
+            name = "operator ";
+            return true;
+        }
+        if (isDigit(code) || (code >= 'A' && code <= 'Z'))
+        {
+            size_t const index = isDigit(code) ? code - '0' : code - 'A' + 10;
+            name = index < std::size(operatorNames) ? operatorNames[index] : std::string_view{};
+            return !name.empty();
+        }
+        if (code != '_')
+        {
+            return false;
+        }
+
+        char const extended = next();
+        if (extended == 'C')
+        {
+            special = SpecialName::StringLiteral;
+            name = "`string'";
+            return true;
+        }
+        if (extended == 'R')
+        {
+            char const rtti = next();
+            switch (rtti)
+            {
+                case '0':
+                {
+                    Type type;
+                    if (!parseType(type, /*inArguments=*/false))
+                    {
+                        return false;
+                    }
+                    name = concat({ type.left, type.right, " `RTTI Type Descriptor'" });
+                    return true;
+                }
+                case '1':
+                {
+                    std::string_view numbers[4];
+                    for (std::string_view & number: numbers)
+                    {
+                        if (!parseNumber(number))
+                        {
+                            return false;
+                        }
+                    }
+                    name = concat({ rttiNames[1], numbers[0], ",", numbers[1], ",", numbers[2], ",", numbers[3],
+                        ")'" });
+                    return true;
+                }
+                case '2':
+                case '3':
+                case '4':
+                    name = rttiNames[rtti - '0'];
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        if (extended == '_')
+        {
+            char const code2 = next();
+            if (code2 < 'A' || code2 > 'M')
+            {
+                return false;
+            }
+            name = doubleExtendedOperatorNames[code2 - 'A'];
+            if (code2 == 'K')
+            {
+                // The suffix of a literal operator, "operator "" _km"
+                std::string_view suffix;
+                if (!parseSimpleName(suffix, /*memorize=*/true))
+                {
+                    return false;
+                }
+                name = concat({ name, suffix });
+            }
+            else if (code2 == 'E' || code2 == 'F')
+            {
+                // "??__E" and "??__F" are the functions initializing and destroying a variable
+                std::string_view variable;
+                if (look() == '?')
+                {
+                    ContextScope context{ *this };
+                    if (!parseSymbol(variable) || !consume('@'))
+                    {
+                        return false;
+                    }
+                }
+                else if (!parseQualifiedName(variable, /*memorizeTemplate=*/true))
+                {
+                    return false;
+                }
+                special = SpecialName::Initializer;
+                name = concat({ name, variable, "''" });
+            }
+            return true;
+        }
+
+        size_t const index = isDigit(extended) ? extended - '0'
+            : extended >= 'A' && extended <= 'Z' ? extended - 'A' + 10 : std::size(extendedOperatorNames);
+        name = index < std::size(extendedOperatorNames) ? extendedOperatorNames[index] : std::string_view{};
+        return !name.empty();
+    }
+
+    // The pieces up to '@', which is consumed too
+    bool MicrosoftParser::parseQualifiedName(std::string_view & result, bool memorizeTemplate)
+    {
+        size_t const mark = m_scratch.scopes.size();
+        std::string_view piece;
+        if (!parseNamePiece(piece, memorizeTemplate))
+        {
+            return false;
+        }
+        m_scratch.scopes.push_back(piece);
+        while (!consume('@'))
+        {
+            if (atEnd() || !parseNamePiece(piece, /*memorizeTemplate=*/true))
+            {
+                return false;
+            }
+            m_scratch.scopes.push_back(piece);
+        }
+        result = join(m_scratch.scopes, mark, "::", /*reversed=*/true);
+        return true;
+    }
+
+    bool MicrosoftParser::parseNamePiece(std::string_view & piece, bool memorizeTemplate)
+    {
+        DepthGuard depth{ *this };
+        if (depth.exceeded())
+        {
+            return false;
+        }
+
+        if (isDigit(look()))
+        {
+            std::string_view const * name = m_context.names.find(next());
+            if (!name)
+            {
+                return false;
+            }
+            piece = *name;
+            return true;
+        }
+        if (look() != '?')
+        {
+            return parseSimpleName(piece, /*memorize=*/true);
+        }
+
+        ++m_pos;
+        switch (look())
+        {
+            case '$':
+                ++m_pos;
+                if (!parseTemplateName(piece))
+                {
+                    return false;
+                }
+                if (memorizeTemplate && !m_context.names.contains(piece))
+                {
+                    m_context.names.add(piece);
+                }
+                return true;
+            case '?':
+            {
+                // The function owning a local static, as a symbol of its own
+                ContextScope context{ *this };
+                std::string_view symbol;
+                if (!parseSymbol(symbol))
+                {
+                    return false;
+                }
+                piece = concat({ "`", symbol, "'" });
+                return true;
+            }
+            case 'A':
+            {
+                // "?A0x1234abcd@", the anonymous namespace with the hash of the translation unit
+                size_t const end = m_text.find('@', m_pos);
+                if (end == std::string_view::npos)
+                {
+                    return false;
+                }
+                m_pos = end + 1;
+                piece = "`anonymous namespace'";
+                m_context.names.add(piece);
+                return true;
+            }
+            default:
+            {
+                // The local scopes are numbered
+                std::string_view number;
+                if (!parseNumber(number))
+                {
+                    return false;
+                }
+                piece = concat({ "`", number, "'" });
+                return true;
+            }
+        }
+    }
+
+    // "name@args@" after "?$"
+    bool MicrosoftParser::parseTemplateName(std::string_view & result)
+    {
+        ContextScope context{ *this };
+        std::string_view name;
+        if (look() == '?')
+        {
+            // Operator templates, "?$?6..."
+            ++m_pos;
+            SpecialName special = SpecialName::None;
+            if (!parseOperatorName(name, special) || special == SpecialName::StringLiteral)
+            {
+                return false;
+            }
+        }
+        else if (!parseSimpleName(name, /*memorize=*/true))
+        {
+            return false;
+        }
+
+        std::string_view arguments;
+        if (!parseArguments(arguments, /*function=*/false))
+        {
+            return false;
+        }
+        result = concat({ name, arguments });
+        return true;
+    }
+
+    // "name@", any characters but '@' as the names of the lambdas and the anonymous types have them
+    bool MicrosoftParser::parseSimpleName(std::string_view & result, bool memorize)
+    {
+        size_t const end = m_text.find('@', m_pos);
+        if (end == std::string_view::npos || end == m_pos)
+        {
+            return false;
+        }
+        result = m_text.substr(m_pos, end - m_pos);
+        m_pos = end + 1;
+        if (memorize && !m_context.names.contains(result))
+        {
+            m_context.names.add(result);
+        }
+        return true;
+    }
+
+    bool MicrosoftParser::parseNumber(std::string_view & result)
+    {
+        int64_t number = 0;
+        if (!parseNumber(number))
+        {
+            return false;
+        }
+        char text[24];
+        auto const [end, error] = std::to_chars(std::begin(text), std::end(text), number);
+        result = concat({ std::string_view{ text, static_cast<size_t>(end - text) } });
+        return true;
+    }
+
+    // "?" for the negative ones, 0-9 for 1-10, hexadecimal digits from 'A' to 'P' ended with '@'
+    bool MicrosoftParser::parseNumber(int64_t & result)
+    {
+        bool const negative = consume('?');
+        if (isDigit(look()))
+        {
+            result = next() - '0' + 1;
+        }
+        else
+        {
+            uint64_t value = 0;
+            size_t digits = 0;
+            while (look() >= 'A' && look() <= 'P')
+            {
+                value = value * 16 + (next() - 'A');
+                ++digits;
+            }
+            if (!consume('@') || digits > 16)
+            {
+                return false;
+            }
+            result = static_cast<int64_t>(value);
+        }
+        if (negative)
+        {
+            result = -result;
+        }
+        return true;
+    }
+
+    bool MicrosoftParser::parseData(std::string_view name, std::string_view & result)
+    {
+        char const code = next();
+        std::string_view access;
+        switch (code)
+        {
+            case '0': access = "private: static "; break;
+            case '1': access = "protected: static "; break;
+            case '2': access = "public: static "; break;
+            default: break;
+        }
+
+        Type type;
+        std::string_view modifier;
+        switch (code)
+        {
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+                if (!parseType(type, /*inArguments=*/false) || !parseModifier(modifier))
+                {
+                    return false;
+                }
+                break;
+            case '6':
+            case '7':
+            {
+                // The virtual tables, "{for `Base'}" names the base of the multiple inheritance
+                if (!parseModifier(modifier))
+                {
+                    return false;
+                }
+                if (!consume('@'))
+                {
+                    std::string_view base;
+                    if (!parseQualifiedName(base, /*memorizeTemplate=*/true))
+                    {
+                        return false;
+                    }
+                    type.right = concat({ "{for `", base, "'}" });
+                    if (!consume('@'))
+                    {
+                        // More bases
+                        while (!consume('@'))
+                        {
+                            if (atEnd() || !parseQualifiedName(base, /*memorizeTemplate=*/true))
+                            {
+                                return false;
+                            }
+                            type.right = concat({ type.right, "{for `", base, "'}" });
+                        }
+                    }
+                }
+                break;
+            }
+            case '8':
+            case '9':
+                break;
+            default:
+                return false;
+        }
+
+        bool const hasLeft = !type.left.empty();
+        result = concat({ access, type.left, hasLeft && !modifier.empty() ? " " : "", modifier,
+            hasLeft || !modifier.empty() ? " " : "", name, type.right });
+        return true;
+    }
+
+    bool MicrosoftParser::parseMethod(std::string_view name, SpecialName special, std::string_view & result)
+    {
+        char const code = next();
+        std::string_view access;
+        std::string_view storage;
+        bool hasThis = false;
+
+        if (code == '$')
+        {
+            char const thunkCode = next();
+            if (thunkCode == 'B')
+            {
+                // "[thunk]: Foo::`vcall'{8,{flat}}' }'", 'A' stands for "{flat}", the calling convention follows
+                std::string_view offset;
+                if (!parseNumber(offset) || !consume('A') || atEnd())
+                {
+                    return false;
+                }
+                ++m_pos;
+                result = concat({ "[thunk]: ", name, "{", offset, ",{flat}}' }'" });
+                return true;
+            }
+
+            // The vtordisp thunks, "`vtordispex{...}'" has two more displacements
+            bool const extended = thunkCode == 'R';
+            char const accessCode = extended ? next() : thunkCode;
+            if (accessCode < '0' || accessCode > '5')
+            {
+                return false;
+            }
+            static constexpr std::string_view thunkAccess[] = {
+                "[thunk]:private: ", "[thunk]:protected: ", "[thunk]:public: ",
+            };
+            access = thunkAccess[(accessCode - '0') / 2];
+            storage = "virtual ";
+            hasThis = true;
+
+            std::string_view numbers[4];
+            size_t const count = extended ? 4 : 2;
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!parseNumber(numbers[i]))
+                {
+                    return false;
+                }
+            }
+            name = extended
+                ? concat({ name, "`vtordispex{", numbers[0], ",", numbers[1], ",", numbers[2], ",", numbers[3], "}' " })
+                : concat({ name, "`vtordisp{", numbers[0], ",", numbers[1], "}' " });
+        }
+        else if (code >= 'A' && code <= 'X')
+        {
+            // Three access levels of four kinds, near and far alike
+            size_t const index = code - 'A';
+            static constexpr std::string_view accesses[] = { "private: ", "protected: ", "public: " };
+            access = accesses[index / 8];
+            switch (index % 8 / 2)
+            {
+                case 0:
+                    hasThis = true;
+                    break;
+                case 1:
+                    storage = "static ";
+                    break;
+                case 2:
+                    storage = "virtual ";
+                    hasThis = true;
+                    break;
+                case 3:
+                {
+                    // Adjusts the this pointer before calling the method
+                    std::string_view offset;
+                    if (!parseNumber(offset))
+                    {
+                        return false;
+                    }
+                    access = concat({ "[thunk]:", access });
+                    storage = "virtual ";
+                    hasThis = true;
+                    name = concat({ name, "`adjustor{", offset, "}' " });
+                    break;
+                }
+            }
+        }
+        else if (code != 'Y' && code != 'Z')
+        {
+            return false;
+        }
+
+        Signature signature;
+        if (!parseFunctionSignature(signature, hasThis))
+        {
+            return false;
+        }
+
+        if (special == SpecialName::Conversion)
+        {
+            // The type of a conversion operator is its name
+            name = concat({ name, signature.returnType.left, signature.returnType.right });
+            signature.returnType = {};
+        }
+
+        Type const & returnType = signature.returnType;
+        bool const spaced = !returnType.left.empty() && returnType.right.empty();
+        result = concat({ access, storage, returnType.left, spaced ? " " : "", name, signature.arguments,
+            signature.qualifiers, returnType.right });
+        return true;
+    }
+
+    // Everything after the access of a method, or after "6" of a function pointer
+    bool MicrosoftParser::parseFunctionSignature(Signature & result, bool hasThis)
+    {
+        if (hasThis)
+        {
+            // "const " and the alike before the trailing space, the const methods are "(int)const "
+            std::string_view modifier;
+            if (!parseModifier(modifier))
+            {
+                return false;
+            }
+            if (!modifier.empty())
+            {
+                result.qualifiers = concat({ modifier, " " });
+            }
+        }
+
+        // The calling convention, hidden
+        char const convention = next();
+        if (!(convention >= 'A' && convention <= 'Q') && convention != 'S' && convention != 'W')
+        {
+            return false;
+        }
+
+        // No return type for the constructors and the destructors
+        if (!consume('@') && !parseType(result.returnType, /*inArguments=*/false))
+        {
+            return false;
+        }
+
+        // The exception specification follows the arguments, 'Z' or "_E" for noexcept
+        if (!parseArguments(result.arguments, /*function=*/true))
+        {
+            return false;
+        }
+        if (consume("_E"))
+        {
+            result.qualifiers = concat({ result.qualifiers, " noexcept" });
+            return true;
+        }
+        return consume('Z');
+    }
+
+    // "(int,char)" and "<int,char>", the lists end with '@' unless ended by "void" or "..."
+    bool MicrosoftParser::parseArguments(std::string_view & result, bool function)
+    {
+        size_t const mark = m_scratch.arguments.size();
+        while (true)
+        {
+            if (consume('@'))
+            {
+                break;
+            }
+            if (atEnd())
+            {
+                return false;
+            }
+
+            size_t const begin = m_pos;
+            Type type;
+            if (!parseType(type, /*inArguments=*/true))
+            {
+                return false;
+            }
+            if (function && m_pos - begin > 1)
+            {
+                // Only the types longer than their references are remembered
+                m_context.types.add(type);
+            }
+            if (function && type.left == "void" && type.right.empty())
+            {
+                break;
+            }
+            if (!type.empty())
+            {
+                m_scratch.arguments.push_back(concat({ type.left, type.right }));
+            }
+            if (type.left == "...")
+            {
+                break;
+            }
+        }
+
+        std::string_view const list = join(m_scratch.arguments, mark, ",", /*reversed=*/false);
+        if (function)
+        {
+            result = concat({ "(", list.empty() ? "void" : list, ")" });
+        }
+        else
+        {
+            result = concat({ "<", list, list.ends_with('>') ? " >" : ">" });
+        }
+        return true;
+    }
+
+    bool MicrosoftParser::parseType(Type & result, bool inArguments)
+    {
+        DepthGuard depth{ *this };
+        if (depth.exceeded())
+        {
+            return false;
+        }
+
+        result = {};
+        char const code = next();
+        switch (code)
+        {
+            case 'C': case 'D': case 'E': case 'F': case 'G': case 'H': case 'I': case 'J':
+            case 'K': case 'M': case 'N': case 'O':
+                result.left = basicTypes[code - 'C'];
+                return true;
+            case 'X':
+                result.left = "void";
+                return true;
+            case 'Z':
+                result.left = "...";
+                return true;
+            case '_':
+                result.left = extendedType(next());
+                return !result.left.empty();
+            case 'T':
+            case 'U':
+            case 'V':
+            case 'Y':
+            {
+                std::string_view name;
+                if (!parseQualifiedName(name, /*memorizeTemplate=*/true))
+                {
+                    return false;
+                }
+                std::string_view const keyword = code == 'T' ? "union " : code == 'U' ? "struct "
+                    : code == 'V' ? "class " : "cointerface ";
+                result.left = concat({ keyword, name });
+                return true;
+            }
+            case 'W':
+            {
+                if (!isDigit(next()))
+                {
+                    return false;
+                }
+                std::string_view name;
+                if (!parseQualifiedName(name, /*memorizeTemplate=*/true))
+                {
+                    return false;
+                }
+                result.left = concat({ "enum ", name });
+                return true;
+            }
+            case '?':
+                if (inArguments)
+                {
+                    return parseTemplateParameter(result, "`template-parameter-");
+                }
+                return parseModifiedType(result, code, inArguments);
+            case 'A':
+            case 'B':
+            case 'P':
+                return parseModifiedType(result, code, inArguments);
+            case 'Q':
+            case 'R':
+            case 'S':
+                return parseModifiedType(result, inArguments ? code : 'P', inArguments);
+            case '$':
+                return parseExtendedType(result, inArguments);
+            default:
+                if (isDigit(code))
+                {
+                    Type const * type = m_context.types.find(code);
+                    if (!type)
+                    {
+                        return false;
+                    }
+                    result = *type;
+                    return true;
+                }
+                return false;
+        }
+    }
+
+    // After '$' in the type position
+    bool MicrosoftParser::parseExtendedType(Type & result, bool inArguments)
+    {
+        char const code = next();
+        switch (code)
+        {
+            case '0':
+            {
+                std::string_view number;
+                if (!parseNumber(number))
+                {
+                    return false;
+                }
+                result.left = number;
+                return true;
+            }
+            case '1':
+            case 'E':
+            {
+                // The address of, or the reference to, a symbol
+                if (consume('@'))
+                {
+                    result.left = "NULL";
+                    return true;
+                }
+                ContextScope context{ *this };
+                std::string_view symbol;
+                if (!parseSymbol(symbol))
+                {
+                    return false;
+                }
+                result.left = code == '1' ? concat({ "&", symbol }) : symbol;
+                return true;
+            }
+            case 'D':
+                return parseTemplateParameter(result, "`template-parameter");
+            case 'Q':
+                return parseTemplateParameter(result, "`non-type-template-parameter");
+            case 'F':
+            case 'G':
+            {
+                std::string_view numbers[3];
+                size_t const count = code == 'F' ? 2 : 3;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (!parseNumber(numbers[i]))
+                    {
+                        return false;
+                    }
+                }
+                result.left = count == 2 ? concat({ "{", numbers[0], ",", numbers[1], "}" })
+                    : concat({ "{", numbers[0], ",", numbers[1], ",", numbers[2], "}" });
+                return true;
+            }
+            case '$':
+                break;
+            default:
+                return false;
+        }
+
+        char const extended = next();
+        switch (extended)
+        {
+            case 'A':
+            {
+                // A function type in the template arguments, "std::function<void (int)>"
+                if (!consume('6'))
+                {
+                    return false;
+                }
+                Signature signature;
+                if (!parseFunctionSignature(signature, /*hasThis=*/false))
+                {
+                    return false;
+                }
+                result.left = concat({ signature.returnType.left, signature.returnType.right, " " });
+                result.right = concat({ signature.arguments, signature.qualifiers });
+                return true;
+            }
+            case 'B':
+            {
+                // The array type itself, or a plain type
+                if (look() == 'Y')
+                {
+                    return parseModifiedType(result, '?', inArguments);
+                }
+                return parseType(result, inArguments);
+            }
+            case 'C':
+            {
+                std::string_view modifier;
+                if (!parseModifier(modifier) || !parseType(result, inArguments))
+                {
+                    return false;
+                }
+                if (!modifier.empty())
+                {
+                    result.left = concat({ result.left, " ", modifier });
+                }
+                return true;
+            }
+            case 'Q':
+            case 'R':
+                return parseModifiedType(result, extended == 'Q' ? 'q' : 'r', inArguments);
+            case 'T':
+                result.left = "std::nullptr_t";
+                return true;
+            case 'V':
+            case 'Z':
+                // The empty parameter packs
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool MicrosoftParser::parseTemplateParameter(Type & result, std::string_view prefix)
+    {
+        std::string_view number;
+        if (!parseNumber(number))
+        {
+            return false;
+        }
+        result.left = concat({ prefix, number, "'" });
+        return true;
+    }
+
+    // "const", "volatile", "const volatile" or nothing
+    bool MicrosoftParser::parseModifier(std::string_view & result)
+    {
+        while (look() == 'E' || look() == 'F' || look() == 'I')
+        {
+            ++m_pos;
+        }
+        switch (next())
+        {
+            case 'A': case 'M': result = {}; return true;
+            case 'B': case 'N': result = "const"; return true;
+            case 'C': case 'O': result = "volatile"; return true;
+            case 'D': case 'P': result = "const volatile"; return true;
+            default: return false;
+        }
+    }
+
+    // Pointers, references and the types of the variables, 'q' and 'r' stand for the rvalue references
+    bool MicrosoftParser::parseModifiedType(Type & result, char code, bool inArguments)
+    {
+        std::string_view pointer;
+        switch (code)
+        {
+            case 'A': pointer = " &"; break;
+            case 'B': pointer = " & volatile"; break;
+            case 'P': pointer = " *"; break;
+            case 'Q': pointer = " * const"; break;
+            case 'R': pointer = " * volatile"; break;
+            case 'S': pointer = " * const volatile"; break;
+            case 'q': pointer = " &&"; break;
+            case 'r': pointer = " && volatile"; break;
+            case '?': pointer = ""; break;
+            default: return false;
+        }
+
+        while (look() == 'E' || look() == 'F' || look() == 'I')
+        {
+            ++m_pos;
+        }
+
+        if (code != '?' && (look() == '6' || look() == '8'))
+        {
+            // The pointers to the functions and to the member functions
+            bool const member = next() == '8';
+            std::string_view className;
+            if (member && !parseQualifiedName(className, /*memorizeTemplate=*/true))
+            {
+                return false;
+            }
+            Signature signature;
+            if (!parseFunctionSignature(signature, /*hasThis=*/member))
+            {
+                return false;
+            }
+            result.left = concat({ signature.returnType.left, signature.returnType.right, " (", className,
+                member ? "::" : "", pointer.substr(1) });
+            result.right = concat({ ")", signature.arguments, signature.qualifiers });
+            return true;
+        }
+
+        std::string_view modifier;
+        std::string_view memberClass;
+        char const modifierCode = look();
+        if (modifierCode >= 'Q' && modifierCode <= 'T')
+        {
+            // The pointers to the data members, "int Foo::*"
+            ++m_pos;
+            static constexpr std::string_view modifiers[] = { "", "const", "volatile", "const volatile" };
+            modifier = modifiers[modifierCode - 'Q'];
+            if (!parseQualifiedName(memberClass, /*memorizeTemplate=*/true))
+            {
+                return false;
+            }
+        }
+        else if (!parseModifier(modifier))
+        {
+            return false;
+        }
+
+        // The arrays, "int (*)[2][3]"
+        std::string_view sizes;
+        if (consume('Y'))
+        {
+            int64_t dimensions = 0;
+            if (!parseNumber(dimensions) || dimensions <= 0 || dimensions > 64)
+            {
+                return false;
+            }
+            for (int64_t i = 0; i < dimensions; ++i)
+            {
+                std::string_view size;
+                if (!parseNumber(size))
+                {
+                    return false;
+                }
+                sizes = concat({ sizes, "[", size, "]" });
+            }
+        }
+
+        Type pointee;
+        if (!parseType(pointee, /*inArguments=*/false))
+        {
+            return false;
+        }
+
+        std::string_view const separator = !modifier.empty() ? " " : "";
+        std::string_view const scope = memberClass.empty() ? std::string_view{}
+            : concat({ " ", memberClass, "::" });
+        std::string_view ptr = pointer;
+        if (!sizes.empty())
+        {
+            result.left = code == '?' ? concat({ pointee.left, separator, modifier })
+                : concat({ pointee.left, separator, modifier, " (", scope.empty() ? ptr.substr(1) : scope.substr(1),
+                    scope.empty() ? "" : ptr.substr(1) });
+            result.right = concat({ code == '?' ? "" : ")", sizes, pointee.right });
+            return true;
+        }
+
+        if (!memberClass.empty() && !ptr.empty())
+        {
+            ptr.remove_prefix(1);
+        }
+        // "int **" is printed without the space within a declaration, unlike the arguments
+        else if (!inArguments && ptr.size() > 1 && ptr[1] == '*' && pointee.left.ends_with('*'))
+        {
+            ptr.remove_prefix(1);
+        }
+        result.left = concat({ pointee.left, separator, modifier, scope, ptr });
+        result.right = pointee.right;
+        return true;
+    }
+}
+
+static Scratch & threadScratch()
+{
+    thread_local Scratch scratch;
+    return scratch;
+}
+
+static bool demangle(std::string_view name, std::string & output, Scratch & scratch)
+{
+    output.clear();
+    if (!name.starts_with('?'))
+    {
+        return false;
+    }
+
+    scratch.reset();
+
+    std::string_view result;
+    if (!MicrosoftParser{ name, scratch }.parseMangledName(result))
+    {
+        return false;
+    }
+    output.assign(result);
+    return true;
+}
+
+bool MSVCDemangler::demangleInto(std::string_view name, std::string & output) const
+{
+    return demangle(name, output, threadScratch());
+}
+
+void MSVCDemangler::demangleBatch(std::span<std::string_view const> names, std::span<std::string> outputs) const
+{
+    Scratch & scratch = threadScratch();
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        demangle(names[i], outputs[i], scratch);
+    }
+}
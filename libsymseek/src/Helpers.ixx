@@ -8,8 +8,17 @@ module;
 
 export module symseek.internal.helpers;
 
+import <bit>;
+import <concepts>;
+import <cstdint>;
+import <cstring>;
+import <filesystem>;
+import <fstream>;
+import <initializer_list>;
 import <memory>;
+import <span>;
 import <string>;
+import <string_view>;
 import <type_traits>;
 
 import symseek.definitions;
@@ -19,6 +28,8 @@ import symseek.internal.interfaces.mappedfile;
 export import symseek.internal.helpers.win;
 
 import symseek.internal.mappedfile.win;
+#elif SYMSEEK_OS_LIN()
+import symseek.internal.mappedfile.linux;
 #endif
 
 export namespace SymSeek::detail
@@ -36,6 +47,110 @@ export namespace SymSeek::detail
         return std::make_unique<MappedFile>(std::move(file));
     }
 
+    // Not a cryptographic one, just a fast 64-bit mix for cache keys and change detection
+    [[nodiscard]] inline uint64_t hashBytes(void const * data, size_t length, uint64_t seed = 0) noexcept
+    {
+        constexpr uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+        auto const * bytes = static_cast<uint8_t const *>(data);
+        uint64_t hash = seed ^ (length * multiplier);
+
+        auto mix = [&hash](uint64_t word)
+        {
+            hash ^= word * multiplier;
+            hash = (hash << 29) | (hash >> 35);
+            hash *= 0xBF58476D1CE4E5B9ull;
+        };
+
+        for (; length >= 8; bytes += 8, length -= 8)
+        {
+            uint64_t word{};
+            std::memcpy(&word, bytes, 8);
+            mix(word);
+        }
+        if (length)
+        {
+            uint64_t word{};
+            std::memcpy(&word, bytes, length);
+            mix(word);
+        }
+
+        hash ^= hash >> 31;
+        hash *= 0x94D049BB133111EBull;
+        return hash ^ (hash >> 29);
+    }
+
+    // Written aside, then renamed, so a crash never leaves a truncated file behind
+    [[nodiscard]] inline bool replaceFile(String const & filePath, std::span<std::string_view const> parts)
+    {
+        std::filesystem::path const target{ filePath };
+        std::filesystem::path temporary = target;
+        temporary += ".tmp";
+        {
+            std::error_code error;
+            std::filesystem::create_directories(target.parent_path(), error);
+
+            std::ofstream output{ temporary, std::ios::binary | std::ios::trunc };
+            for (std::string_view part: parts)
+            {
+                output.write(part.data(), static_cast<std::streamsize>(part.size()));
+            }
+            if (!output.flush())
+            {
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, target, error);
+        return !error;
+    }
+
+    [[nodiscard]] inline bool replaceFile(String const & filePath, std::initializer_list<std::string_view> parts)
+    {
+        return replaceFile(filePath, std::span{ parts.begin(), parts.size() });
+    }
+
+    template<std::unsigned_integral T>
+    [[nodiscard]] constexpr T byteSwap(T value) noexcept
+    {
+        T result{};
+        for (size_t i = 0; i < sizeof(T); ++i, value >>= 8)
+        {
+            result = static_cast<T>((result << 8) | (value & 0xFF));
+        }
+        return result;
+    }
+
+    // The image formats fix their byte order regardless of the host one
+    template<std::unsigned_integral T>
+    [[nodiscard]] constexpr T fromBigEndian(T value) noexcept
+    {
+        return std::endian::native == std::endian::big ? value : byteSwap(value);
+    }
+
+    template<std::unsigned_integral T>
+    [[nodiscard]] constexpr T fromLittleEndian(T value) noexcept
+    {
+        return std::endian::native == std::endian::little ? value : byteSwap(value);
+    }
+
+    // From the unaligned bytes of a mapped image
+    template<std::unsigned_integral T>
+    [[nodiscard]] T loadBigEndian(void const * bytes) noexcept
+    {
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return fromBigEndian(value);
+    }
+
+    template<std::unsigned_integral T>
+    [[nodiscard]] T loadLittleEndian(void const * bytes) noexcept
+    {
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return fromLittleEndian(value);
+    }
+
     template <class T>
     concept Fundamental = std::is_fundamental_v<T>;
 
@@ -0,0 +1,143 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek.internal.imageformat;
+
+import <cstdint>;
+import <cstring>;
+import <memory>;
+
+import symseek.definitions;
+import symseek.internal.interfaces.mappedfile;
+import symseek.internal.byteview;
+import symseek.internal.helpers;
+import symseek.internal.machoformat;
+import symseek.internal.peformat;
+
+export namespace SymSeek::detail
+{
+    // Told apart by the magic of the first bytes, the parser of the format validates the rest
+    enum class ImageFormat: uint8_t
+    {
+        Unknown,
+        Archive,      // "!<arch>\n", both the MS libraries and the System V / GNU / BSD ones
+        PE,           // "MZ" of the DOS stub
+        COFF,         // Object files start with the machine right away
+        ShortImport,  // Members of the MS import libraries, naming a single import
+        ELF,
+        MachO,
+        Universal     // Fat Mach-O, an image per architecture
+    };
+
+    // Every magic fits, so a single read classifies a file
+    constexpr size_t ImageHeaderSize = sizeof(pe::DosHeader);
+
+    ImageFormat detectImageFormat(ByteView header) noexcept;
+
+    struct Image
+    {
+        std::unique_ptr<IMappedFile> file;
+        ImageFormat format = ImageFormat::Unknown;
+    };
+
+    // Opens the file and reads its header once, nothing is mapped yet.
+    // Null file when it cannot be opened, Unknown format when it's no image at all.
+    Image openImage(String const & imagePath);
+}
+
+// Implementation
+
+using namespace SymSeek::detail;
+
+namespace
+{
+    constexpr char ArchiveMagic[] = "!<arch>\n";
+    constexpr char ELFMagic[] = "\x7F" "ELF";
+
+    // Java classes share the fat magic, their version follows it and starts at 45.0,
+    // while no universal binary has that many architectures
+    constexpr uint32_t MaxFatArchsCount = 43;
+
+    constexpr uint16_t ImportSignature = 0xFFFF;
+
+    bool startsWith(ByteView header, char const * magic, size_t length) noexcept
+    {
+        return header.contains(0, length) && !std::memcmp(header.data(), magic, length);
+    }
+}
+
+namespace SymSeek::detail
+{
+    ImageFormat detectImageFormat(ByteView header) noexcept
+    {
+        if (startsWith(header, ArchiveMagic, sizeof(ArchiveMagic) - 1))
+        {
+            return ImageFormat::Archive;
+        }
+        if (startsWith(header, ELFMagic, sizeof(ELFMagic) - 1))
+        {
+            return ImageFormat::ELF;
+        }
+
+        if (auto magic = header.at<uint32_t>(0))
+        {
+            // Mach-O is stored in the byte order of its CPU, the fat header is always Big Endian
+            uint32_t const bigEndian = loadBigEndian<uint32_t>(magic);
+            uint32_t const littleEndian = loadLittleEndian<uint32_t>(magic);
+            for (uint32_t const machO: { macho::Magic32, macho::Magic64 })
+            {
+                if (bigEndian == machO || littleEndian == machO)
+                {
+                    return ImageFormat::MachO;
+                }
+            }
+
+            if (bigEndian == macho::FatMagic32 || bigEndian == macho::FatMagic64)
+            {
+                auto archsCount = header.at<uint32_t>(sizeof(uint32_t));
+                return archsCount && loadBigEndian<uint32_t>(archsCount) < MaxFatArchsCount
+                    ? ImageFormat::Universal
+                    : ImageFormat::Unknown;
+            }
+        }
+
+        auto machine = header.at<uint16_t>(0);
+        if (!machine)
+        {
+            return ImageFormat::Unknown;
+        }
+
+        uint16_t const first = loadLittleEndian<uint16_t>(machine);
+        if (first == pe::DosSignature)
+        {
+            return ImageFormat::PE;
+        }
+        if (first == pe::MachineAmd64 || first == pe::MachineI386)
+        {
+            return ImageFormat::COFF;
+        }
+        // The objects built with /GL start the same, their version tells them apart later
+        auto second = header.at<uint16_t>(sizeof(uint16_t));
+        if (!first && second && loadLittleEndian<uint16_t>(second) == ImportSignature)
+        {
+            return ImageFormat::ShortImport;
+        }
+        return ImageFormat::Unknown;
+    }
+
+    Image openImage(String const & imagePath)
+    {
+        Image image{ createMappedFile(imagePath) };
+        if (!image.file)
+        {
+            return {};
+        }
+
+        // The only read of the files which aren't images, e.g. the sources matched by "*"
+        uint8_t header[ImageHeaderSize]{};
+        size_t const headerSize = image.file->readAt(/*offset=*/0, header, sizeof(header));
+        image.format = detectImageFormat({ header, headerSize });
+        return image;
+    }
+}
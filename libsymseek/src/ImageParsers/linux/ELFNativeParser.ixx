@@ -0,0 +1,359 @@
+module;
+
+#include <symseek/Definitions.h>
+
+#if !SYMSEEK_OS_LIN()
+#   error Unsupported platform
+#endif
+
+#include <elf.h>
+
+#include <cstring>
+
+#include <Debug.h>
+
+export module symseek:parsers.elf;
+
+import <algorithm>;
+import <bit>;
+import <memory>;
+import <optional>;
+import <span>;
+import <string>;
+
+import symseek.definitions;
+import symseek.interfaces.parser;
+
+import symseek.internal.interfaces.mappedfile;
+import symseek.internal.byteview;
+import symseek.internal.helpers;
+import symseek.internal.imageformat;
+
+export namespace SymSeek
+{
+    class ELFNativeParser : public IImageParser
+    {
+    public:
+        ISymbolReader::UPtr reader(String const& imagePath) const override;
+        ISymbolReader::UPtr reader(std::span<uint8_t const> imageBytes) const override;
+        // Of the file open already, see detail::openImage()
+        ISymbolReader::UPtr reader(std::unique_ptr<detail::IMappedFile> imageFile) const;
+    };
+}
+
+// Implementation
+
+using namespace SymSeek;
+
+template<unsigned char Class>
+struct ELFTypes;
+
+template<>
+struct ELFTypes<ELFCLASS32>
+{
+    using Header        = Elf32_Ehdr;
+    using SectionHeader = Elf32_Shdr;
+    using Sym           = Elf32_Sym;
+};
+
+template<>
+struct ELFTypes<ELFCLASS64>
+{
+    using Header        = Elf64_Ehdr;
+    using SectionHeader = Elf64_Shdr;
+    using Sym           = Elf64_Sym;
+};
+
+using FileUPtr = std::unique_ptr<detail::IMappedFile>;
+
+namespace SymSeek::detail
+{
+    template<unsigned char Class>
+    class ELFNativeSymbolReader: public ISymbolReader
+    {
+        using Header        = typename ELFTypes<Class>::Header;
+        using SectionHeader = typename ELFTypes<Class>::SectionHeader;
+        using Sym           = typename ELFTypes<Class>::Sym;
+
+        // The image may have been produced for a target of the opposite byte order
+        template<typename T>
+        T fix(T value) const
+        {
+            if (!m_swapBytes)
+            {
+                return value;
+            }
+            if constexpr (sizeof(T) == 2)
+            {
+                return static_cast<T>(__builtin_bswap16(static_cast<uint16_t>(value)));
+            }
+            else if constexpr (sizeof(T) == 4)
+            {
+                return static_cast<T>(__builtin_bswap32(static_cast<uint32_t>(value)));
+            }
+            else if constexpr (sizeof(T) == 8)
+            {
+                return static_cast<T>(__builtin_bswap64(static_cast<uint64_t>(value)));
+            }
+            else
+            {
+                return value;
+            }
+        }
+
+        // Only the symbols visible outside of the image matter, the same way COFF reader does
+        bool isVisible(Sym const & symbol) const
+        {
+            unsigned char const binding = ELF64_ST_BIND(symbol.st_info);
+            unsigned char const type = ELF64_ST_TYPE(symbol.st_info);
+            if (binding != STB_GLOBAL && binding != STB_WEAK && binding != STB_GNU_UNIQUE)
+            {
+                return false;
+            }
+            if (type == STT_SECTION || type == STT_FILE)
+            {
+                return false;
+            }
+            return fix(symbol.st_name) != 0 && fix(symbol.st_name) < m_stringTable.size();
+        }
+
+    public:
+        // The file is null for the objects within archives
+        ELFNativeSymbolReader(FileUPtr imageFile, detail::ByteView image, bool swapBytes)
+        : m_imageFile { std::move(imageFile) }
+        , m_swapBytes { swapBytes            }
+        {
+            // The objects within archives are only aligned on even offsets, so the structures are copied out
+            std::optional<Header> const header = image.load<Header>(0);
+            if (!header)
+            {
+                return;
+            }
+
+            // No section table at all, nothing to read yet nothing broken
+            size_t const sectionsOffset = fix(header->e_shoff);
+            size_t const entrySize = fix(header->e_shentsize);
+            if (!sectionsOffset)
+            {
+                m_valid = true;
+                return;
+            }
+            if (entrySize < sizeof(SectionHeader) || !image.contains(sectionsOffset, entrySize))
+            {
+                return;
+            }
+
+            detail::ByteView const sections = image.tail(sectionsOffset);
+            size_t sectionsCount = fix(header->e_shnum);
+            if (!sectionsCount)
+            {
+                // Extended numbering, the real count lives in the initial entry,
+                // see https://refspecs.linuxfoundation.org/elf/gabi4+/ch4.sheader.html
+                sectionsCount = static_cast<size_t>(fix(sections.load<SectionHeader>(0)->sh_size));
+            }
+            if (sections.size() / entrySize < sectionsCount)
+            {
+                return;
+            }
+
+            auto section = [&](size_t index)
+            {
+                return *sections.load<SectionHeader>(index * entrySize);
+            };
+
+            // .symtab is a superset of .dynsym, the latter is used for stripped images
+            std::optional<SectionHeader> symbolsSection;
+            for (size_t i = 0; i < sectionsCount; ++i)
+            {
+                SectionHeader const current = section(i);
+                uint32_t const type = fix(current.sh_type);
+                if (type == SHT_SYMTAB)
+                {
+                    symbolsSection = current;
+                    break;
+                }
+                if (type == SHT_DYNSYM && !symbolsSection)
+                {
+                    symbolsSection = current;
+                }
+            }
+
+            if (!symbolsSection)
+            {
+                m_valid = true;
+                return;
+            }
+            if (fix(symbolsSection->sh_link) >= sectionsCount)
+            {
+                return;
+            }
+            SectionHeader const stringsSection = section(fix(symbolsSection->sh_link));
+
+            uint64_t const symbolsOffset = fix(symbolsSection->sh_offset);
+            uint64_t const symbolsSize   = fix(symbolsSection->sh_size);
+            uint64_t const stringsOffset = fix(stringsSection.sh_offset);
+            uint64_t const stringsSize   = fix(stringsSection.sh_size);
+            detail::ByteView const symbols = image.sub(symbolsOffset, symbolsSize);
+            detail::ByteView const strings = image.sub(stringsOffset, stringsSize);
+            if (symbols.size() != symbolsSize || strings.size() != stringsSize)
+            {
+                return;
+            }
+
+            m_symbols = symbols;
+            m_entriesCount = symbolsSize / sizeof(Sym);
+            m_stringTable = strings;
+            m_valid = true;
+
+            // Code and data are never touched, so only the symbols are worth reading ahead
+            if (m_imageFile)
+            {
+                m_imageFile->advise(image.data(), image.size(), detail::AccessHint::Random);
+                m_imageFile->advise(symbols.data(), symbols.size(), detail::AccessHint::Sequential);
+                m_imageFile->advise(symbols.data(), symbols.size(), detail::AccessHint::WillNeed);
+                m_imageFile->advise(strings.data(), strings.size(), detail::AccessHint::WillNeed);
+            }
+
+            // The entries are fixed-size, so one pass over them is cheap and gives the exact count
+            for (size_t i = 0; i < m_entriesCount; ++i)
+            {
+                m_symbolsCount += isVisible(symbol(i));
+            }
+        }
+
+        // False for the images whose section table or symbols lie outside of them
+        bool valid() const
+        {
+            return m_valid;
+        }
+
+        size_t symbolsCount() const override
+        {
+            return m_symbolsCount;
+        }
+
+        SymbolRefsGen readSymbolRefs() const override
+        {
+            return readRange(0, m_entriesCount);
+        }
+
+        size_t chunksCount() const override
+        {
+            return std::max<size_t>(1, (m_entriesCount + EntriesPerChunk - 1) / EntriesPerChunk);
+        }
+
+        SymbolRefsGen readChunkRefs(size_t chunk) const override
+        {
+            size_t const begin = std::min(chunk * EntriesPerChunk, m_entriesCount);
+            size_t const end = std::min(begin + EntriesPerChunk, m_entriesCount);
+            return readRange(begin, end);
+        }
+
+    private:
+        // Fixed-size entries make the table trivially splittable
+        static constexpr size_t EntriesPerChunk = 1 << 15;
+
+        // Within the table, checked by the constructor
+        Sym symbol(size_t index) const
+        {
+            return *m_symbols.load<Sym>(index * sizeof(Sym));
+        }
+
+        SymbolRefsGen readRange(size_t begin, size_t end) const
+        {
+            for (size_t i = begin; i != end; ++i)
+            {
+                Sym const symbol = this->symbol(i);
+                if (!isVisible(symbol))
+                {
+                    continue;
+                }
+
+                // The names cut off by the end of the table are skipped
+                std::string_view const name = m_stringTable.string(fix(symbol.st_name));
+                if (name.empty())
+                {
+                    continue;
+                }
+                bool const undefined = fix(symbol.st_shndx) == SHN_UNDEF;
+
+                // Named, as GCC destroys the aggregate temporaries of co_yield twice
+                RawSymbolRef symbolRef{.name = name, .implements = !undefined};
+                co_yield symbolRef;
+            }
+        }
+
+        FileUPtr m_imageFile;  // Whilst this ptr lives, memory mapping is valid
+        bool m_swapBytes{};
+        bool m_valid{};
+        detail::ByteView m_symbols;
+        size_t m_entriesCount{};
+        detail::ByteView m_stringTable;
+        size_t m_symbolsCount{};
+    };
+}
+
+namespace
+{
+    template<unsigned char Class>
+    ISymbolReader::UPtr validReader(FileUPtr imageFile, detail::ByteView image, bool swapBytes)
+    {
+        auto reader = std::make_unique<detail::ELFNativeSymbolReader<Class>>(std::move(imageFile), image, swapBytes);
+        return reader->valid() ? std::move(reader) : nullptr;
+    }
+
+    // See https://refspecs.linuxfoundation.org/elf/gabi4+/ch4.eheader.html
+    ISymbolReader::UPtr createELFReader(FileUPtr imageFile, detail::ByteView image)
+    {
+        uint8_t const * ident = image.at<uint8_t>(0, EI_NIDENT);
+        if (!ident || std::memcmp(ident, ELFMAG, SELFMAG))
+        {
+            return {};
+        }
+
+        bool const littleEndian = ident[EI_DATA] == ELFDATA2LSB;
+        if (!littleEndian && ident[EI_DATA] != ELFDATA2MSB)
+        {
+            return {};
+        }
+        bool const swapBytes = littleEndian != (std::endian::native == std::endian::little);
+
+        if (ident[EI_CLASS] == ELFCLASS32)
+        {
+            return validReader<ELFCLASS32>(std::move(imageFile), image, swapBytes);
+        }
+        else if (ident[EI_CLASS] == ELFCLASS64)
+        {
+            return validReader<ELFCLASS64>(std::move(imageFile), image, swapBytes);
+        }
+
+        return {};
+    }
+}
+
+ISymbolReader::UPtr ELFNativeParser::reader(String const & imagePath) const
+{
+    // Not to map the files which aren't ELF at all
+    detail::Image image = detail::openImage(imagePath);
+    if (image.format != detail::ImageFormat::ELF)
+    {
+        return {};
+    }
+    return reader(std::move(image.file));
+}
+
+ISymbolReader::UPtr ELFNativeParser::reader(FileUPtr imageFile) const
+{
+    size_t const imageSize = imageFile->size();
+    uint8_t const * imageBytes = imageFile->map(/*offset=*/0, imageSize);
+    if (!GUARD(imageBytes))
+    {
+        return {};
+    }
+    return createELFReader(std::move(imageFile), { imageBytes, imageSize });
+}
+
+ISymbolReader::UPtr ELFNativeParser::reader(std::span<uint8_t const> imageBytes) const
+{
+    return createELFReader(/*imageFile=*/nullptr, imageBytes);
+}
@@ -0,0 +1,201 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek.internal.machoformat;
+
+import <cstdint>;
+
+// The structures of the Mach-O images and the universal binaries made of them, laid out byte for byte
+// as in the Apple headers, so the macOS and iOS binaries are read on any platform.
+// See https://github.com/apple-oss-distributions/xnu/blob/main/EXTERNAL_HEADERS/mach-o/loader.h
+// and https://github.com/apple-oss-distributions/xnu/blob/main/EXTERNAL_HEADERS/mach-o/fat.h
+
+// Unlike PE, an image is stored in the byte order of its CPU, so the fields are copied out and fixed
+// rather than read in place. All of them are unsigned here, even the ones of signed types in the headers.
+
+export namespace SymSeek::detail::macho
+{
+    constexpr uint32_t Magic32 = 0xFEEDFACE;
+    constexpr uint32_t Magic64 = 0xFEEDFACF;
+
+    // The fat headers are always Big Endian
+    constexpr uint32_t FatMagic32 = 0xCAFEBABE;
+    constexpr uint32_t FatMagic64 = 0xCAFEBABF;
+
+    constexpr uint32_t LoadCommandRequiredByDyld = 0x80000000;
+
+    enum LoadCommandType: uint32_t
+    {
+        SymtabCommand          = 0x02,
+        DysymtabCommand        = 0x0B,
+        DyldInfoCommand        = 0x22,
+        DyldInfoOnlyCommand    = 0x22 | LoadCommandRequiredByDyld,
+        DyldExportsTrieCommand = 0x33 | LoadCommandRequiredByDyld
+    };
+
+    // See https://github.com/apple-oss-distributions/xnu/blob/main/EXTERNAL_HEADERS/mach-o/nlist.h
+    constexpr uint8_t SymbolStabMask = 0xE0;  // Debugging entries
+    constexpr uint8_t SymbolTypeMask = 0x0E;
+    constexpr uint8_t SymbolExternal = 0x01;
+
+    constexpr uint8_t SymbolUndefined         = 0x00;
+    constexpr uint8_t SymbolPreboundUndefined = 0x0C;
+
+    // See https://github.com/apple-oss-distributions/xnu/blob/main/osfmk/mach/machine.h
+    constexpr uint32_t CPUArchABI64   = 0x01000000;
+    constexpr uint32_t CPUArchABI6432 = 0x02000000;
+    constexpr uint32_t CPUSubtypeMask = 0xFF000000;
+
+    enum CPUType: uint32_t
+    {
+        CPUTypeX86       = 7,
+        CPUTypeX86_64    = CPUTypeX86 | CPUArchABI64,
+        CPUTypeARM       = 12,
+        CPUTypeARM64     = CPUTypeARM | CPUArchABI64,
+        CPUTypeARM64_32  = CPUTypeARM | CPUArchABI6432,
+        CPUTypePowerPC   = 18,
+        CPUTypePowerPC64 = CPUTypePowerPC | CPUArchABI64
+    };
+
+    // Only the ones the tools name on their own
+    enum CPUSubtype: uint32_t
+    {
+        CPUSubtypeARM64E  = 2,
+        CPUSubtypeARMV6   = 6,
+        CPUSubtypeX86_64H = 8,
+        CPUSubtypeARMV7   = 9,
+        CPUSubtypeARMV7S  = 11,
+        CPUSubtypeARMV7K  = 12
+    };
+
+#pragma pack(push, 1)
+    struct MachHeader32
+    {
+        uint32_t magic;
+        uint32_t cpuType;
+        uint32_t cpuSubtype;
+        uint32_t fileType;
+        uint32_t numberOfCommands;
+        uint32_t sizeOfCommands;
+        uint32_t flags;
+    };
+    static_assert(sizeof(MachHeader32) == 28);
+
+    struct MachHeader64
+    {
+        uint32_t magic;
+        uint32_t cpuType;
+        uint32_t cpuSubtype;
+        uint32_t fileType;
+        uint32_t numberOfCommands;
+        uint32_t sizeOfCommands;
+        uint32_t flags;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(MachHeader64) == 32);
+
+    struct LoadCommand
+    {
+        uint32_t command;
+        uint32_t commandSize;
+    };
+    static_assert(sizeof(LoadCommand) == 8);
+
+    struct Symtab
+    {
+        uint32_t command;
+        uint32_t commandSize;
+        uint32_t symbolsOffset;
+        uint32_t symbolsCount;
+        uint32_t stringsOffset;
+        uint32_t stringsSize;
+    };
+    static_assert(sizeof(Symtab) == 24);
+
+    // The symbol table is sorted into the local, the defined external and the undefined symbols.
+    // Only the fields the parsers need are named, the rest are kept for the layout.
+    struct Dysymtab
+    {
+        uint32_t command;
+        uint32_t commandSize;
+        uint32_t firstLocalSymbol;
+        uint32_t localSymbolsCount;
+        uint32_t firstDefinedSymbol;
+        uint32_t definedSymbolsCount;
+        uint32_t firstUndefinedSymbol;
+        uint32_t undefinedSymbolsCount;
+        uint32_t unused[12];
+    };
+    static_assert(sizeof(Dysymtab) == 80);
+
+    struct DyldInfo
+    {
+        uint32_t command;
+        uint32_t commandSize;
+        uint32_t unused[8];  // Rebase and binding opcodes
+        uint32_t exportOffset;
+        uint32_t exportSize;
+    };
+    static_assert(sizeof(DyldInfo) == 48);
+
+    // The exports trie of the images with chained fixups, among others
+    struct LinkEditData
+    {
+        uint32_t command;
+        uint32_t commandSize;
+        uint32_t dataOffset;
+        uint32_t dataSize;
+    };
+    static_assert(sizeof(LinkEditData) == 16);
+
+    struct NList32
+    {
+        uint32_t stringIndex;
+        uint8_t  type;
+        uint8_t  section;
+        uint16_t description;
+        uint32_t value;
+    };
+    static_assert(sizeof(NList32) == 12);
+
+    struct NList64
+    {
+        uint32_t stringIndex;
+        uint8_t  type;
+        uint8_t  section;
+        uint16_t description;
+        uint64_t value;
+    };
+    static_assert(sizeof(NList64) == 16);
+
+    struct FatHeader
+    {
+        uint32_t magic;
+        uint32_t archsCount;
+    };
+    static_assert(sizeof(FatHeader) == 8);
+
+    struct FatArch32
+    {
+        uint32_t cpuType;
+        uint32_t cpuSubtype;
+        uint32_t offset;
+        uint32_t size;
+        uint32_t align;
+    };
+    static_assert(sizeof(FatArch32) == 20);
+
+    // For the slices beyond 4 GiB
+    struct FatArch64
+    {
+        uint32_t cpuType;
+        uint32_t cpuSubtype;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t align;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(FatArch64) == 32);
+#pragma pack(pop)
+}
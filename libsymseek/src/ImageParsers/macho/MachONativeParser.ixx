@@ -0,0 +1,460 @@
+module;
+
+#include <symseek/Definitions.h>
+
+#include <Debug.h>
+
+export module symseek:parsers.macho;
+
+import <algorithm>;
+import <bit>;
+import <concepts>;
+import <memory>;
+import <optional>;
+import <span>;
+import <string>;
+import <string_view>;
+import <unordered_set>;
+import <vector>;
+
+import symseek.definitions;
+import symseek.interfaces.parser;
+
+import symseek.internal.interfaces.mappedfile;
+import symseek.internal.byteview;
+import symseek.internal.helpers;
+import symseek.internal.imageformat;
+import symseek.internal.machoformat;
+
+export namespace SymSeek
+{
+    class MachONativeParser : public IImageParser
+    {
+    public:
+        ISymbolReader::UPtr reader(String const& imagePath) const override;
+        ISymbolReader::UPtr reader(std::span<uint8_t const> imageBytes) const override;
+        // Of the file open already, see detail::openImage()
+        ISymbolReader::UPtr reader(std::unique_ptr<detail::IMappedFile> imageFile) const;
+    };
+}
+
+// Implementation
+
+using namespace SymSeek;
+
+template<uint32_t Magic>
+struct MachOTypes;
+
+template<>
+struct MachOTypes<detail::macho::Magic32>
+{
+    using Header = detail::macho::MachHeader32;
+    using NList  = detail::macho::NList32;
+};
+
+template<>
+struct MachOTypes<detail::macho::Magic64>
+{
+    using Header = detail::macho::MachHeader64;
+    using NList  = detail::macho::NList64;
+};
+
+using FileUPtr = std::unique_ptr<detail::IMappedFile>;
+
+namespace
+{
+    // Null when the number runs past the bytes or doesn't fit in 64 bits
+    std::optional<uint64_t> readULEB128(detail::ByteView bytes, uint64_t & offset)
+    {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            std::optional<uint8_t> const byte = bytes.load<uint8_t>(offset++);
+            if (!byte)
+            {
+                return std::nullopt;
+            }
+            value |= uint64_t{ *byte & 0x7Fu } << shift;
+            if (!(*byte & 0x80))
+            {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+}
+
+namespace SymSeek::detail
+{
+    template<uint32_t Magic>
+    class MachONativeSymbolReader: public ISymbolReader
+    {
+        using Header = typename MachOTypes<Magic>::Header;
+        using NList  = typename MachOTypes<Magic>::NList;
+
+        // The image may have been produced for a CPU of the opposite byte order
+        template<std::unsigned_integral T>
+        T fix(T value) const
+        {
+            return m_swapBytes ? detail::byteSwap(value) : value;
+        }
+
+        // Only the symbols visible outside of the image matter, the same way the other readers do
+        bool isVisible(NList const & symbol) const
+        {
+            if ((symbol.type & macho::SymbolStabMask) || !(symbol.type & macho::SymbolExternal))
+            {
+                return false;
+            }
+            uint32_t const name = fix(symbol.stringIndex);
+            return name != 0 && name < m_stringTable.size();
+        }
+
+        // The common symbols are undefined ones with a size, the image allocates them
+        static bool isUndefined(NList const & symbol)
+        {
+            uint8_t const type = symbol.type & macho::SymbolTypeMask;
+            return (type == macho::SymbolUndefined && !symbol.value) || type == macho::SymbolPreboundUndefined;
+        }
+
+    public:
+        // The file is null for the images within archives and universal binaries
+        MachONativeSymbolReader(FileUPtr imageFile, detail::ByteView image, bool swapBytes)
+        : m_imageFile { std::move(imageFile) }
+        , m_swapBytes { swapBytes            }
+        {
+            // The objects within archives are only aligned on even offsets, so the structures are copied out
+            std::optional<Header> const header = image.load<Header>(0);
+            if (!header)
+            {
+                return;
+            }
+
+            uint32_t const commandsSize = fix(header->sizeOfCommands);
+            detail::ByteView const commands = image.sub(sizeof(Header), commandsSize);
+            if (commands.size() != commandsSize)
+            {
+                return;
+            }
+
+            macho::Symtab symtab{};
+            std::optional<macho::Dysymtab> dysymtab;
+            uint32_t trieOffset{};
+            uint32_t trieSize{};
+            uint64_t commandOffset = 0;
+            for (uint32_t i = 0, commandsCount = fix(header->numberOfCommands); i < commandsCount; ++i)
+            {
+                std::optional<macho::LoadCommand> const command = commands.load<macho::LoadCommand>(commandOffset);
+                uint32_t const commandSize = command ? fix(command->commandSize) : 0;
+                detail::ByteView const commandBytes = commands.sub(commandOffset, commandSize);
+                if (commandSize < sizeof(macho::LoadCommand) || commandBytes.size() != commandSize)
+                {
+                    return;
+                }
+                commandOffset += commandSize;
+
+                // The shorter ones than their structure are malformed, yet harmless, and skipped
+                switch (fix(command->command))
+                {
+                    case macho::SymtabCommand:
+                        symtab = commandBytes.load<macho::Symtab>(0).value_or(symtab);
+                        break;
+                    case macho::DysymtabCommand:
+                        dysymtab = commandBytes.load<macho::Dysymtab>(0);
+                        break;
+                    case macho::DyldInfoCommand:
+                    case macho::DyldInfoOnlyCommand:
+                        if (std::optional<macho::DyldInfo> const dyldInfo = commandBytes.load<macho::DyldInfo>(0))
+                        {
+                            trieOffset = fix(dyldInfo->exportOffset);
+                            trieSize = fix(dyldInfo->exportSize);
+                        }
+                        break;
+                    case macho::DyldExportsTrieCommand:
+                        if (std::optional<macho::LinkEditData> const trie = commandBytes.load<macho::LinkEditData>(0))
+                        {
+                            trieOffset = fix(trie->dataOffset);
+                            trieSize = fix(trie->dataSize);
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            uint64_t const symbolsSize = sizeof(NList) * uint64_t{ fix(symtab.symbolsCount) };
+            uint32_t const stringsSize = fix(symtab.stringsSize);
+            m_symbols = image.sub(fix(symtab.symbolsOffset), symbolsSize);
+            m_stringTable = image.sub(fix(symtab.stringsOffset), stringsSize);
+            m_exportsTrie = image.sub(trieOffset, trieSize);
+            if (m_symbols.size() != symbolsSize || m_stringTable.size() != stringsSize ||
+                m_exportsTrie.size() != trieSize)
+            {
+                return;
+            }
+            m_end = fix(symtab.symbolsCount);
+
+            // The local symbols come first and are skipped at once, the defined ones are followed by the undefined
+            if (dysymtab)
+            {
+                uint64_t const definedBegin = fix(dysymtab->firstDefinedSymbol);
+                uint64_t const definedEnd = definedBegin + fix(dysymtab->definedSymbolsCount);
+                uint64_t const undefinedBegin = fix(dysymtab->firstUndefinedSymbol);
+                uint64_t const undefinedEnd = undefinedBegin + fix(dysymtab->undefinedSymbolsCount);
+                if (definedEnd > m_end || undefinedEnd > m_end)
+                {
+                    return;
+                }
+                // So every linker lays them out, the whole table is walked otherwise
+                if (definedEnd == undefinedBegin)
+                {
+                    m_begin = static_cast<size_t>(definedBegin);
+                    m_end = static_cast<size_t>(undefinedEnd);
+                }
+            }
+            m_valid = true;
+
+            // Code and data are never touched, so only the symbols are worth reading ahead
+            if (m_imageFile)
+            {
+                m_imageFile->advise(image.data(), image.size(), detail::AccessHint::Random);
+                m_imageFile->advise(m_symbols.data(), m_symbols.size(), detail::AccessHint::Sequential);
+                m_imageFile->advise(m_symbols.data(), m_symbols.size(), detail::AccessHint::WillNeed);
+                m_imageFile->advise(m_stringTable.data(), m_stringTable.size(), detail::AccessHint::WillNeed);
+            }
+
+            // The entries are fixed-size, so one pass over them is cheap and gives the exact count
+            for (size_t i = m_begin; i < m_end; ++i)
+            {
+                NList const entry = symbol(i);
+                if (!isVisible(entry))
+                {
+                    continue;
+                }
+                ++m_symbolsCount;
+                if (!m_exportsTrie.empty() && !isUndefined(entry))
+                {
+                    m_definedNames.insert(m_stringTable.string(fix(entry.stringIndex)));
+                }
+            }
+            for ([[maybe_unused]] RawSymbolRef const & symbolRef: readExportsTrie())
+            {
+                ++m_symbolsCount;
+            }
+        }
+
+        // False for the images whose load commands or the tables they point to lie outside of them
+        bool valid() const
+        {
+            return m_valid;
+        }
+
+        size_t symbolsCount() const override
+        {
+            return m_symbolsCount;
+        }
+
+        SymbolRefsGen readSymbolRefs() const override
+        {
+            return readRange(m_begin, m_end, /*withExportsTrie=*/true);
+        }
+
+        // The exports trie, if any, is the last chunk
+        size_t chunksCount() const override
+        {
+            return std::max<size_t>(1, symbolChunksCount() + !m_exportsTrie.empty());
+        }
+
+        SymbolRefsGen readChunkRefs(size_t chunk) const override
+        {
+            if (chunk >= symbolChunksCount())
+            {
+                return m_exportsTrie.empty() ? readRange(m_end, m_end) : readExportsTrie();
+            }
+            size_t const begin = m_begin + chunk * EntriesPerChunk;
+            return readRange(begin, std::min(begin + EntriesPerChunk, m_end));
+        }
+
+    private:
+        // Fixed-size entries make the table trivially splittable
+        static constexpr size_t EntriesPerChunk = 1 << 15;
+
+        size_t symbolChunksCount() const
+        {
+            return (m_end - m_begin + EntriesPerChunk - 1) / EntriesPerChunk;
+        }
+
+        // Within the table, checked by the constructor
+        NList symbol(size_t index) const
+        {
+            return *m_symbols.load<NList>(index * sizeof(NList));
+        }
+
+        SymbolRefsGen readRange(size_t begin, size_t end, bool withExportsTrie = false) const
+        {
+            for (size_t i = begin; i != end; ++i)
+            {
+                NList const symbol = this->symbol(i);
+                if (!isVisible(symbol))
+                {
+                    continue;
+                }
+
+                // The names cut off by the end of the table are skipped
+                std::string_view const name = m_stringTable.string(fix(symbol.stringIndex));
+                if (name.empty())
+                {
+                    continue;
+                }
+
+                // Named, as GCC destroys the aggregate temporaries of co_yield twice
+                RawSymbolRef symbolRef{.name = name, .implements = !isUndefined(symbol)};
+                co_yield symbolRef;
+            }
+
+            if (withExportsTrie && !m_exportsTrie.empty())
+            {
+                for (RawSymbolRef const & symbolRef: readExportsTrie())
+                {
+                    co_yield symbolRef;
+                }
+            }
+        }
+
+        // Only the exports the symbol table lacks: the re-exported ones and all of them in the stripped images.
+        // The names are put together from the edges, so they are the only ones not borrowed from the image,
+        // each lives until the next one.
+        // See https://github.com/apple-oss-distributions/dyld/blob/main/common/MachOTrie.hpp
+        SymbolRefsGen readExportsTrie() const
+        {
+            struct Edge
+            {
+                uint64_t node;
+                size_t prefixLength;  // Of the parent name, the name buffer keeps it as the walk is depth-first
+                std::string_view label;
+            };
+
+            std::vector<Edge> pending{ Edge{} };
+            // A node reached twice makes no tree, so a malformed trie cannot loop
+            std::vector<bool> visited(m_exportsTrie.size());
+            std::string name;
+            while (!pending.empty())
+            {
+                Edge const edge = pending.back();
+                pending.pop_back();
+                if (edge.node >= visited.size() || visited[edge.node])
+                {
+                    continue;
+                }
+                visited[edge.node] = true;
+                name.resize(edge.prefixLength);
+                name.append(edge.label);
+
+                // The flags and the address of the export follow, only its presence matters
+                uint64_t offset = edge.node;
+                std::optional<uint64_t> const terminalSize = readULEB128(m_exportsTrie, offset);
+                if (!terminalSize || !m_exportsTrie.contains(offset, *terminalSize))
+                {
+                    continue;
+                }
+                if (*terminalSize && !name.empty() && !m_definedNames.contains(name))
+                {
+                    RawSymbolRef symbolRef{.name = name};
+                    co_yield symbolRef;
+                }
+
+                offset += *terminalSize;
+                std::optional<uint8_t> const childrenCount = m_exportsTrie.load<uint8_t>(offset++);
+                for (uint8_t child = 0; child < childrenCount.value_or(0); ++child)
+                {
+                    std::string_view const label = m_exportsTrie.string(offset);
+                    offset += label.size() + 1;
+                    std::optional<uint64_t> const node = readULEB128(m_exportsTrie, offset);
+                    if (label.empty() || !node)
+                    {
+                        break;
+                    }
+                    pending.push_back({ .node = *node, .prefixLength = name.size(), .label = label });
+                }
+            }
+        }
+
+        FileUPtr m_imageFile;  // Whilst this ptr lives, memory mapping is valid
+        bool m_swapBytes{};
+        bool m_valid{};
+        detail::ByteView m_symbols;
+        detail::ByteView m_stringTable;
+        // The visible symbols are among these entries
+        size_t m_begin{};
+        size_t m_end{};
+        detail::ByteView m_exportsTrie;
+        // Defined by the symbol table, only kept for the images with an exports trie
+        std::unordered_set<std::string_view> m_definedNames;
+        size_t m_symbolsCount{};
+    };
+}
+
+namespace
+{
+    template<uint32_t Magic>
+    ISymbolReader::UPtr validReader(FileUPtr imageFile, detail::ByteView image, bool swapBytes)
+    {
+        auto reader = std::make_unique<detail::MachONativeSymbolReader<Magic>>(std::move(imageFile), image, swapBytes);
+        return reader->valid() ? std::move(reader) : nullptr;
+    }
+
+    // See https://github.com/apple-oss-distributions/xnu/blob/main/EXTERNAL_HEADERS/mach-o/loader.h
+    ISymbolReader::UPtr createMachOReader(FileUPtr imageFile, detail::ByteView image)
+    {
+        std::optional<uint32_t> magic = image.loadLittleEndian<uint32_t>(0);
+        if (!magic)
+        {
+            return {};
+        }
+
+        bool const littleEndian = *magic == detail::macho::Magic32 || *magic == detail::macho::Magic64;
+        if (!littleEndian)
+        {
+            magic = detail::byteSwap(*magic);
+        }
+        bool const swapBytes = littleEndian != (std::endian::native == std::endian::little);
+
+        if (*magic == detail::macho::Magic32)
+        {
+            return validReader<detail::macho::Magic32>(std::move(imageFile), image, swapBytes);
+        }
+        else if (*magic == detail::macho::Magic64)
+        {
+            return validReader<detail::macho::Magic64>(std::move(imageFile), image, swapBytes);
+        }
+
+        return {};
+    }
+}
+
+ISymbolReader::UPtr MachONativeParser::reader(String const & imagePath) const
+{
+    // Not to map the files which aren't Mach-O at all
+    detail::Image image = detail::openImage(imagePath);
+    if (image.format != detail::ImageFormat::MachO)
+    {
+        return {};
+    }
+    return reader(std::move(image.file));
+}
+
+ISymbolReader::UPtr MachONativeParser::reader(FileUPtr imageFile) const
+{
+    size_t const imageSize = imageFile->size();
+    uint8_t const * imageBytes = imageFile->map(/*offset=*/0, imageSize);
+    if (!GUARD(imageBytes))
+    {
+        return {};
+    }
+    return createMachOReader(std::move(imageFile), { imageBytes, imageSize });
+}
+
+ISymbolReader::UPtr MachONativeParser::reader(std::span<uint8_t const> imageBytes) const
+{
+    return createMachOReader(/*imageFile=*/nullptr, imageBytes);
+}
@@ -0,0 +1,303 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek:parsers.universal;
+
+import <memory>;
+import <mutex>;
+import <optional>;
+import <span>;
+import <string>;
+import <string_view>;
+import <vector>;
+
+import symseek.definitions;
+import symseek.interfaces.parser;
+
+import symseek.internal.interfaces.mappedfile;
+import symseek.internal.byteview;
+import symseek.internal.helpers;
+import symseek.internal.imageformat;
+import symseek.internal.machoformat;
+
+import :parsers.lib;
+import :parsers.macho;
+
+export namespace SymSeek
+{
+    class UniversalNativeParser : public IImageParser
+    {
+    public:
+        ISymbolReader::UPtr reader(String const& imagePath) const override;
+        ISymbolReader::UPtr reader(std::span<uint8_t const> imageBytes) const override;
+        // Of the file open already, see detail::openImage()
+        ISymbolReader::UPtr reader(std::unique_ptr<detail::IMappedFile> imageFile) const;
+    };
+
+    // The fat binaries of macOS and iOS hold a Mach-O image or a static library per architecture.
+    // The slices are the members, named after their architectures as lipo does, e.g. "libz.dylib(arm64)",
+    // and so are the members of the static libraries, e.g. "libz.a(arm64:inflate.o)".
+    class UniversalNativeSymbolReader : public ISymbolReader
+    {
+    public:
+        UniversalNativeSymbolReader(std::unique_ptr<detail::IMappedFile> imageFile, detail::ByteView image);
+
+        // False for the binaries whose slices don't fit in the file
+        bool valid() const;
+
+        // Unless the members are read, the first slice stands for the whole binary,
+        // the slices are mostly built from the same sources
+        size_t symbolsCount() const override;
+        SymbolRefsGen readSymbolRefs() const override;
+        size_t chunksCount() const override;
+        SymbolRefsGen readChunkRefs(size_t chunk) const override;
+
+        size_t membersCount() const override;
+        std::string_view memberName(size_t member) const override;
+        ISymbolReader::UPtr memberReader(size_t member) const override;
+
+    private:
+        struct Slice
+        {
+            std::string arch;
+            detail::ByteView bytes;
+            ISymbolReader::UPtr archive;  // Of the static libraries
+        };
+
+        struct Member
+        {
+            std::string name;
+            size_t slice;
+            size_t archiveMember{};  // Of the static library slices
+        };
+
+        void listMembers() const;
+
+        std::unique_ptr<detail::IMappedFile> m_imageFile;
+        std::vector<Slice> m_slices;
+        ISymbolReader::UPtr m_firstSlice;
+        bool m_valid{};
+
+        mutable std::once_flag m_membersListed;
+        mutable std::vector<Member> m_members;
+    };
+}
+
+// Implementation
+
+using namespace SymSeek;
+
+namespace
+{
+    // The 32-bit entries are widened, the fields are Big Endian either way
+    std::optional<detail::macho::FatArch64> loadArch(detail::ByteView image, uint64_t offset, bool is64)
+    {
+        using detail::fromBigEndian;
+
+        if (is64)
+        {
+            std::optional<detail::macho::FatArch64> arch = image.load<detail::macho::FatArch64>(offset);
+            if (arch)
+            {
+                arch->cpuType = fromBigEndian(arch->cpuType);
+                arch->cpuSubtype = fromBigEndian(arch->cpuSubtype);
+                arch->offset = fromBigEndian(arch->offset);
+                arch->size = fromBigEndian(arch->size);
+                arch->align = fromBigEndian(arch->align);
+            }
+            return arch;
+        }
+
+        std::optional<detail::macho::FatArch32> const arch = image.load<detail::macho::FatArch32>(offset);
+        if (!arch)
+        {
+            return std::nullopt;
+        }
+        return detail::macho::FatArch64{ .cpuType = fromBigEndian(arch->cpuType),
+            .cpuSubtype = fromBigEndian(arch->cpuSubtype), .offset = fromBigEndian(arch->offset),
+            .size = fromBigEndian(arch->size), .align = fromBigEndian(arch->align), .reserved = 0 };
+    }
+
+    std::string archName(uint32_t cpuType, uint32_t cpuSubtype)
+    {
+        using namespace detail::macho;
+
+        uint32_t const subtype = cpuSubtype & ~CPUSubtypeMask;
+        switch (cpuType)
+        {
+            case CPUTypeX86:
+                return "i386";
+            case CPUTypeX86_64:
+                return subtype == CPUSubtypeX86_64H ? "x86_64h" : "x86_64";
+            case CPUTypeARM:
+                switch (subtype)
+                {
+                    case CPUSubtypeARMV6:
+                        return "armv6";
+                    case CPUSubtypeARMV7:
+                        return "armv7";
+                    case CPUSubtypeARMV7S:
+                        return "armv7s";
+                    case CPUSubtypeARMV7K:
+                        return "armv7k";
+                    default:
+                        return "arm";
+                }
+            case CPUTypeARM64:
+                return subtype == CPUSubtypeARM64E ? "arm64e" : "arm64";
+            case CPUTypeARM64_32:
+                return "arm64_32";
+            case CPUTypePowerPC:
+                return "ppc";
+            case CPUTypePowerPC64:
+                return "ppc64";
+            default:
+                break;
+        }
+        return "cputype" + detail::toString<std::string>(cpuType) + "_" + detail::toString<std::string>(subtype);
+    }
+
+    ISymbolReader::SymbolRefsGen noSymbols()
+    {
+        co_return;
+    }
+}
+
+ISymbolReader::UPtr UniversalNativeParser::reader(String const & imagePath) const
+{
+    // Not to map the files which aren't universal binaries at all
+    detail::Image image = detail::openImage(imagePath);
+    if (image.format != detail::ImageFormat::Universal)
+    {
+        return {};
+    }
+    return reader(std::move(image.file));
+}
+
+ISymbolReader::UPtr UniversalNativeParser::reader(std::unique_ptr<detail::IMappedFile> imageFile) const
+{
+    // Only the pages of the slices being read are touched
+    detail::ByteView const image{ imageFile->map(), imageFile->size() };
+    auto reader = std::make_unique<UniversalNativeSymbolReader>(std::move(imageFile), image);
+    return reader->valid() ? std::move(reader) : nullptr;
+}
+
+ISymbolReader::UPtr UniversalNativeParser::reader(std::span<uint8_t const> imageBytes) const
+{
+    auto reader = std::make_unique<UniversalNativeSymbolReader>(/*imageFile=*/nullptr, imageBytes);
+    return reader->valid() ? std::move(reader) : nullptr;
+}
+
+// See https://github.com/apple-oss-distributions/xnu/blob/main/EXTERNAL_HEADERS/mach-o/fat.h
+UniversalNativeSymbolReader::UniversalNativeSymbolReader(std::unique_ptr<detail::IMappedFile> imageFile,
+    detail::ByteView image)
+: m_imageFile{ std::move(imageFile) }
+{
+    std::optional<detail::macho::FatHeader> const header = image.load<detail::macho::FatHeader>(0);
+    if (!header)
+    {
+        return;
+    }
+
+    bool const is64 = detail::fromBigEndian(header->magic) == detail::macho::FatMagic64;
+    uint32_t const archsCount = detail::fromBigEndian(header->archsCount);
+    uint64_t const archSize = is64 ? sizeof(detail::macho::FatArch64) : sizeof(detail::macho::FatArch32);
+    if (!image.contains(sizeof(detail::macho::FatHeader), archSize * archsCount))
+    {
+        return;
+    }
+
+    m_slices.reserve(archsCount);
+    for (uint32_t i = 0; i < archsCount; ++i)
+    {
+        std::optional<detail::macho::FatArch64> const arch =
+            loadArch(image, sizeof(detail::macho::FatHeader) + archSize * i, is64);
+        detail::ByteView const bytes = image.sub(arch->offset, arch->size);
+        if (bytes.size() != arch->size)
+        {
+            return;
+        }
+        ISymbolReader::UPtr archive = detail::detectImageFormat(bytes) == detail::ImageFormat::Archive
+            ? LIBNativeParser{}.reader(bytes.bytes())
+            : nullptr;
+        m_slices.push_back({ .arch = archName(arch->cpuType, arch->cpuSubtype), .bytes = bytes,
+            .archive = std::move(archive) });
+    }
+    m_valid = true;
+
+    if (!m_slices.empty())
+    {
+        Slice const & first = m_slices.front();
+        m_firstSlice = first.archive ? LIBNativeParser{}.reader(first.bytes.bytes())
+                                     : MachONativeParser{}.reader(first.bytes.bytes());
+    }
+}
+
+bool UniversalNativeSymbolReader::valid() const
+{
+    return m_valid;
+}
+
+size_t UniversalNativeSymbolReader::symbolsCount() const
+{
+    return m_firstSlice ? m_firstSlice->symbolsCount() : 0;
+}
+
+UniversalNativeSymbolReader::SymbolRefsGen UniversalNativeSymbolReader::readSymbolRefs() const
+{
+    return m_firstSlice ? m_firstSlice->readSymbolRefs() : noSymbols();
+}
+
+size_t UniversalNativeSymbolReader::chunksCount() const
+{
+    return m_firstSlice ? m_firstSlice->chunksCount() : 1;
+}
+
+UniversalNativeSymbolReader::SymbolRefsGen UniversalNativeSymbolReader::readChunkRefs(size_t chunk) const
+{
+    return m_firstSlice ? m_firstSlice->readChunkRefs(chunk) : noSymbols();
+}
+
+size_t UniversalNativeSymbolReader::membersCount() const
+{
+    std::call_once(m_membersListed, [this] { listMembers(); });
+    return m_members.size();
+}
+
+std::string_view UniversalNativeSymbolReader::memberName(size_t member) const
+{
+    return m_members[member].name;
+}
+
+ISymbolReader::UPtr UniversalNativeSymbolReader::memberReader(size_t member) const
+{
+    Member const & current = m_members[member];
+    Slice const & slice = m_slices[current.slice];
+    if (slice.archive)
+    {
+        return slice.archive->memberReader(current.archiveMember);
+    }
+    return MachONativeParser{}.reader(slice.bytes.bytes());
+}
+
+void UniversalNativeSymbolReader::listMembers() const
+{
+    for (size_t i = 0; i < m_slices.size(); ++i)
+    {
+        Slice const & slice = m_slices[i];
+        if (!slice.archive)
+        {
+            m_members.push_back({ .name = slice.arch, .slice = i });
+            continue;
+        }
+
+        // The archives are expanded in place, the scanner doesn't descend into the members
+        for (size_t member = 0, count = slice.archive->membersCount(); member < count; ++member)
+        {
+            std::string_view const memberName = slice.archive->memberName(member);
+            m_members.push_back({ .name = slice.arch + ':' + std::string{ memberName }, .slice = i,
+                .archiveMember = member });
+        }
+    }
+}
@@ -0,0 +1,213 @@
+module;
+
+#include <symseek/Definitions.h>
+
+#include <Debug.h>
+
+export module symseek:parsers.coff;
+
+import <algorithm>;
+import <cstring>;
+import <memory>;
+import <optional>;
+import <span>;
+import <string_view>;
+
+import symseek.definitions;
+import symseek.interfaces.parser;
+
+import symseek.internal.interfaces.mappedfile;
+import symseek.internal.byteview;
+import symseek.internal.helpers;
+import symseek.internal.imageformat;
+import symseek.internal.peformat;
+
+export namespace SymSeek
+{
+    class COFFNativeParser : public IImageParser
+    {
+    public:
+        ISymbolReader::UPtr reader(String const& imagePath) const override;
+        ISymbolReader::UPtr reader(std::span<uint8_t const> imageBytes) const override;
+        // Of the file open already, see detail::openImage()
+        ISymbolReader::UPtr reader(std::unique_ptr<detail::IMappedFile> imageFile) const;
+    };
+}
+
+// Implementation
+
+using namespace SymSeek;
+using SymSeek::detail::IMappedFile;
+
+namespace
+{
+    class COFFNativeSymbolReader : public ISymbolReader
+    {
+    public:
+        // The file is null for the objects within archives
+        COFFNativeSymbolReader(std::unique_ptr<IMappedFile> objectFile, detail::ByteView object)
+        : m_objectFile{ std::move(objectFile) }
+        {
+            // See https://docs.microsoft.com/en-us/windows/desktop/debug/pe-format#coff-file-header-object-and-image
+            auto fileHeader = object.at<detail::pe::FileHeader>(0);
+            m_entries = object.at<SymTableEntry>(fileHeader->pointerToSymbolTable, fileHeader->numberOfSymbols);
+            if (!m_entries)
+            {
+                return;
+            }
+            m_entriesCount = fileHeader->numberOfSymbols;
+
+            // See https://docs.microsoft.com/en-us/windows/desktop/debug/pe-format#coff-string-table,
+            // its size includes the size field itself. The objects without long names may omit it.
+            detail::ByteView const afterEntries = object.tail(fileHeader->pointerToSymbolTable +
+                uint64_t{ m_entriesCount } * sizeof(SymTableEntry));
+            if (std::optional<uint32_t> const stringTableSize = afterEntries.loadLittleEndian<uint32_t>(0))
+            {
+                m_stringTable = afterEntries.sub(0, *stringTableSize);
+                if (m_stringTable.size() != *stringTableSize)
+                {
+                    return;
+                }
+            }
+
+            // The string table follows the symbols, both are walked from the beginning
+            if (m_objectFile)
+            {
+                m_objectFile->advise(reinterpret_cast<uint8_t const *>(m_entries),
+                    m_entriesCount * sizeof(SymTableEntry), detail::AccessHint::Sequential);
+            }
+
+            // The entries are fixed-size, so one pass over them is cheap and gives the exact count
+            for (uint32_t index = 0; index < m_entriesCount; index = next(index))
+            {
+                m_symbolsCount += m_entries[index].storageClass == detail::pe::SymbolClassExternal;
+            }
+            m_valid = true;
+        }
+
+        // False for the objects whose tables don't fit in the file
+        bool valid() const
+        {
+            return m_valid;
+        }
+
+        size_t symbolsCount() const override
+        {
+            return m_symbolsCount;
+        }
+
+        SymbolRefsGen readSymbolRefs() const override
+        {
+            for (uint32_t index = 0; index < m_entriesCount; index = next(index))
+            {
+                SymTableEntry const * currentEntry = m_entries + index;
+
+                // Only this class of symbols matters,
+                // see https://docs.microsoft.com/en-us/windows/desktop/debug/pe-format#storage-class
+                if (currentEntry->storageClass != detail::pe::SymbolClassExternal)
+                {
+                    continue;
+                }
+                std::string_view rawSymbolName;
+                if(!currentEntry->name.zeroes)
+                {
+                    // The symbol name is longer than 8 bytes and put into the string table.
+                    rawSymbolName = m_stringTable.string(currentEntry->name.offset);
+                }
+                else
+                {
+                    // Padded with zeroes, but not terminated when it takes all 8 bytes
+                    auto const & shortName = currentEntry->name.shortName;
+                    rawSymbolName = { shortName, strnlen(shortName, sizeof(shortName)) };
+                }
+                if (rawSymbolName.empty())
+                {
+                    continue;
+                }
+                // See https://docs.microsoft.com/en-us/windows/desktop/debug/pe-format#section-number-values
+                bool const undefined = currentEntry->sectionNumber == detail::pe::SymbolUndefined;
+                if (undefined && rawSymbolName.starts_with("__imp_"))
+                {
+                    rawSymbolName.remove_prefix(6);
+                }
+
+                co_yield RawSymbolRef{.name = rawSymbolName, .implements = !undefined};
+            }
+        }
+
+    private:
+        // See https://docs.microsoft.com/en-us/windows/desktop/debug/pe-format#coff-symbol-table
+        using SymTableEntry = detail::pe::SymbolTableEntry;
+
+        // The auxiliary records follow their symbol and aren't symbols themselves
+        uint32_t next(uint32_t index) const
+        {
+            return index + 1 + std::min<uint32_t>(m_entries[index].numberOfAuxSymbols, m_entriesCount - index - 1);
+        }
+
+        std::unique_ptr<IMappedFile> m_objectFile;  // Whilst this ptr lives, memory mapping is valid
+        SymTableEntry const * m_entries{};
+        uint32_t m_entriesCount{};
+        uint32_t m_symbolsCount{};
+        detail::ByteView m_stringTable;
+        bool m_valid{};
+    };
+}
+
+namespace
+{
+    // See https://docs.microsoft.com/en-us/windows/desktop/debug/pe-format#coff-file-header-object-and-image
+    bool isObject(detail::ByteView object)
+    {
+        auto fileHeader = object.at<detail::pe::FileHeader>(0);
+        if (!fileHeader)
+        {
+            return false;
+        }
+
+        // The objects compiled with Whole Program Optimization (/GL), the fuel for Link-Time Code Generation,
+        // start with 0x0000 0xFFFF instead. They don't match the COFF specification :(
+        // Maybe this will be reverse-engineered later.
+        uint16_t const machine = fileHeader->machine;
+        return machine == detail::pe::MachineAmd64 || machine == detail::pe::MachineI386;
+    }
+
+    ISymbolReader::UPtr validReader(std::unique_ptr<COFFNativeSymbolReader> reader)
+    {
+        return reader->valid() ? std::move(reader) : nullptr;
+    }
+}
+
+ISymbolReader::UPtr COFFNativeParser::reader(String const & imagePath) const
+{
+    detail::Image image = detail::openImage(imagePath);
+    if (image.format != detail::ImageFormat::COFF)
+    {
+        return {};
+    }
+    return reader(std::move(image.file));
+}
+
+ISymbolReader::UPtr COFFNativeParser::reader(std::unique_ptr<IMappedFile> objectFile) const
+{
+    uint8_t const * mapped = objectFile->map(/*offset=*/0);
+    if (!GUARD(mapped))
+    {
+        return {};
+    }
+    detail::ByteView const object{ mapped, objectFile->size() };
+    if (!isObject(object))
+    {
+        return {};
+    }
+    return validReader(std::make_unique<COFFNativeSymbolReader>(std::move(objectFile), object));
+}
+
+ISymbolReader::UPtr COFFNativeParser::reader(std::span<uint8_t const> imageBytes) const
+{
+    if (!isObject(imageBytes))
+    {
+        return {};
+    }
+    return validReader(std::make_unique<COFFNativeSymbolReader>(/*objectFile=*/nullptr, imageBytes));
+}
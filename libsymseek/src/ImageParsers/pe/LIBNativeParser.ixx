@@ -0,0 +1,643 @@
+module;
+
+#include <symseek/Definitions.h>
+
+#include <Debug.h>
+
+export module symseek:parsers.lib;
+
+import <algorithm>;
+import <cstdlib>;
+import <cstring>;
+import <memory>;
+import <mutex>;
+import <optional>;
+import <span>;
+import <string_view>;
+import <vector>;
+
+import symseek.definitions;
+import symseek.interfaces.parser;
+
+import symseek.internal.interfaces.mappedfile;
+import symseek.internal.byteview;
+import symseek.internal.helpers;
+import symseek.internal.imageformat;
+
+import :parsers.coff;
+import :parsers.macho;
+#if SYMSEEK_OS_LIN()
+    import :parsers.elf;
+#endif
+
+export namespace SymSeek
+{
+    class LIBNativeParser : public IImageParser
+    {
+    public:
+        ISymbolReader::UPtr reader(String const& imagePath) const override;
+        ISymbolReader::UPtr reader(std::span<uint8_t const> archiveBytes) const override;
+        // Of the file open already, see detail::openImage()
+        ISymbolReader::UPtr reader(std::unique_ptr<detail::IMappedFile> archiveFile) const;
+    };
+
+    // Reads the MS import and static libraries as well as the System V / GNU / BSD archives.
+    // The linker member lists the names of the whole archive, the members are parsed on demand.
+    class LIBNativeSymbolReader : public ISymbolReader
+    {
+    public:
+        // The file is null for the archives within universal binaries
+        LIBNativeSymbolReader(std::unique_ptr<detail::IMappedFile> archiveFile, detail::ByteView archive);
+
+        // False for the archives whose linker member doesn't fit in the file
+        bool valid() const;
+
+        size_t symbolsCount() const override;
+
+        SymbolRefsGen readSymbolRefs() const override;
+
+        size_t chunksCount() const override;
+        SymbolRefsGen readChunkRefs(size_t chunk) const override;
+
+        size_t membersCount() const override;
+        std::string_view memberName(size_t member) const override;
+        ISymbolReader::UPtr memberReader(size_t member) const override;
+
+        // A binary search in the linker members, the other members aren't touched
+        std::string_view definingMember(std::string_view rawName) const override;
+
+    private:
+        struct Member
+        {
+            std::string_view name;
+            detail::ByteView bytes;
+        };
+
+        // The name relative to m_sortedNames and the header of its member
+        struct IndexEntry
+        {
+            uint32_t name;
+            uint32_t memberOffset;
+        };
+
+        bool readLinkerMember();
+        void splitSymbolTable();
+        void listMembers() const;
+        void indexSymbols() const;
+        bool indexSecondLinkerMember() const;
+        bool indexBSDSymbolTable() const;
+        std::string_view memberNameAt(size_t memberOffset) const;
+
+        SymbolRefsGen readRange(uint32_t begin, uint32_t end) const;
+
+    private:
+        // Import libraries of big SDKs contain hundreds of thousands of names
+        static constexpr uint32_t SymbolsPerChunk = 1 << 14;
+
+        std::unique_ptr<detail::IMappedFile> m_archiveFile;  // Whilst this ptr lives, memory mapping is valid
+        detail::ByteView m_archive;
+        bool m_valid{};
+        uint32_t m_symbolsCount{};
+        uint8_t const * m_memberOffsets{};
+        char const * m_symTable{};
+        char const * m_symTableEnd{};
+        // Names are of variable length, so the beginnings of the chunks are found once
+        std::vector<char const *> m_chunks;
+
+        mutable std::once_flag m_membersListed;
+        mutable std::vector<Member> m_members;
+
+        // Built on the first lookup, sorted by name
+        mutable std::once_flag m_symbolsIndexed;
+        mutable std::vector<IndexEntry> m_index;
+        mutable char const * m_sortedNames{};
+        mutable std::string_view m_longNames;
+    };
+}
+
+// Implementation
+
+using namespace SymSeek;
+
+namespace
+{
+    // See https://docs.microsoft.com/en-us/windows/desktop/debug/pe-format#archive-member-headers,
+    // all the fields are ASCII padded with spaces
+    struct MemberHeader
+    {
+        char name[16];
+        char date[12];
+        char userId[6];
+        char groupId[6];
+        char mode[8];
+        char size[10];
+        char endOfHeader[2];
+    };
+    static_assert(sizeof(MemberHeader) == 60);
+
+    constexpr size_t SignatureSize = 8;
+
+    size_t parseDecimal(char const * field, size_t length)
+    {
+        size_t value = 0;
+        for (char const * end = field + length; field != end && *field >= '0' && *field <= '9'; ++field)
+        {
+            value = value * 10 + static_cast<size_t>(*field - '0');
+        }
+        return value;
+    }
+
+    std::string_view trimRight(std::string_view text)
+    {
+        size_t const end = text.find_last_not_of(' ');
+        return text.substr(0, end == std::string_view::npos ? 0 : end + 1);
+    }
+
+    struct RawMember
+    {
+        std::string_view name;  // As it is in the header
+        detail::ByteView bytes;
+        size_t nextOffset;
+    };
+
+    std::optional<RawMember> readMemberAt(detail::ByteView archive, size_t offset)
+    {
+        auto header = archive.at<MemberHeader>(offset);
+        if (!header || std::memcmp(header->endOfHeader, "`\n", 2))
+        {
+            return std::nullopt;
+        }
+        size_t const dataOffset = offset + sizeof(MemberHeader);
+        size_t const size = parseDecimal(header->size, sizeof(header->size));
+        if (!archive.contains(dataOffset, size))
+        {
+            return std::nullopt;
+        }
+        // The data are aligned on even offsets
+        return RawMember{ .name = trimRight({ header->name, sizeof(header->name) }),
+            .bytes = archive.sub(dataOffset, size), .nextOffset = dataOffset + size + (size & 1) };
+    }
+
+    // Empty for the linker members and the names table, the data of BSD members lose the name in front
+    std::string_view resolveMemberName(RawMember & member, std::string_view longNames)
+    {
+        std::string_view name = member.name;
+        if (name.starts_with("#1/"))
+        {
+            // BSD puts the long names in front of the data
+            size_t const nameLength = parseDecimal(name.data() + 3, name.size() - 3);
+            if (nameLength > member.bytes.size())
+            {
+                return {};
+            }
+            auto nameBytes = reinterpret_cast<char const *>(member.bytes.data());
+            name = { nameBytes, ::strnlen(nameBytes, nameLength) };
+            member.bytes = member.bytes.tail(nameLength);
+        }
+        else if (name.size() > 1 && name[0] == '/' && name[1] >= '0' && name[1] <= '9')
+        {
+            // GNU and MSVC keep the names longer than 15 characters in the "//" member
+            size_t const nameOffset = parseDecimal(name.data() + 1, name.size() - 1);
+            if (nameOffset >= longNames.size())
+            {
+                return {};
+            }
+            name = longNames.substr(nameOffset);
+            name = name.substr(0, std::min(name.find("/\n"), name.find('\0')));
+        }
+        else if (name.starts_with('/'))
+        {
+            // The linker members "/", "/SYM64/", the names table "//" and the like
+            return {};
+        }
+        else if (name.ends_with('/'))
+        {
+            name.remove_suffix(1);
+        }
+        return name.starts_with("__.SYMDEF") ? std::string_view{} : name;
+    }
+
+    // See https://docs.microsoft.com/en-us/windows/win32/debug/pe-format#import-header
+    struct ImportHeader
+    {
+        uint16_t signature1;  // IMAGE_FILE_MACHINE_UNKNOWN
+        uint16_t signature2;  // 0xFFFF
+        uint16_t version;
+        uint16_t machine;
+        uint32_t timeDateStamp;
+        uint32_t sizeOfData;
+        uint16_t ordinalOrHint;
+        uint16_t type;
+    };
+    static_assert(sizeof(ImportHeader) == 20);
+
+    // The members of the import libraries made by MSVC are no objects, they only name the import
+    class ShortImportReader : public ISymbolReader
+    {
+    public:
+        ShortImportReader(std::string_view symbolName)
+        : m_symbolName{ symbolName }
+        {
+        }
+
+        size_t symbolsCount() const override
+        {
+            return 1;
+        }
+
+        SymbolRefsGen readSymbolRefs() const override
+        {
+            RawSymbolRef symbolRef{.name = m_symbolName};
+            co_yield symbolRef;
+        }
+
+    private:
+        std::string_view m_symbolName;
+    };
+
+    ISymbolReader::UPtr createShortImportReader(detail::ByteView bytes)
+    {
+        ImportHeader header{};
+        if (bytes.size() < sizeof(header))
+        {
+            return {};
+        }
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (header.signature1 != 0 || header.signature2 != 0xFFFF || header.version != 0)
+        {
+            return {};
+        }
+
+        // The symbol name and then the DLL name, both null-terminated
+        std::string_view const symbolName = bytes.sub(sizeof(header), header.sizeOfData).string(0);
+        if (symbolName.empty())
+        {
+            return {};
+        }
+        return std::make_unique<ShortImportReader>(symbolName);
+    }
+}
+
+ISymbolReader::UPtr LIBNativeParser::reader(String const & imagePath) const
+{
+    // See https://docs.microsoft.com/en-us/windows/desktop/debug/pe-format#archive-library-file-format
+    detail::Image image = detail::openImage(imagePath);
+    if (image.format != detail::ImageFormat::Archive)
+    {
+        return {};
+    }
+    return reader(std::move(image.file));
+}
+
+ISymbolReader::UPtr LIBNativeParser::reader(std::unique_ptr<detail::IMappedFile> archiveFile) const
+{
+    // The file has a single mapping, shared by the linker member and the members listed later.
+    // Only the pages being touched are read.
+    detail::ByteView const archive{ archiveFile->map(/*offset=*/0, /*length=*/0, detail::MapMode::Lazy),
+        archiveFile->size() };
+    auto reader = std::make_unique<LIBNativeSymbolReader>(std::move(archiveFile), archive);
+    return reader->valid() ? std::move(reader) : nullptr;
+}
+
+ISymbolReader::UPtr LIBNativeParser::reader(std::span<uint8_t const> archiveBytes) const
+{
+    auto reader = std::make_unique<LIBNativeSymbolReader>(/*archiveFile=*/nullptr, archiveBytes);
+    return reader->valid() ? std::move(reader) : nullptr;
+}
+
+LIBNativeSymbolReader::LIBNativeSymbolReader(std::unique_ptr<detail::IMappedFile> archiveFile,
+    detail::ByteView archive)
+: m_archiveFile{ std::move(archiveFile) }
+, m_archive    { archive                }
+{
+    m_valid = readLinkerMember();
+    splitSymbolTable();
+}
+
+bool LIBNativeSymbolReader::valid() const
+{
+    return m_valid;
+}
+
+size_t LIBNativeSymbolReader::symbolsCount() const
+{
+    return m_symbolsCount;
+}
+
+LIBNativeSymbolReader::SymbolRefsGen LIBNativeSymbolReader::readSymbolRefs() const
+{
+    return readRange(0, m_symbolsCount);
+}
+
+size_t LIBNativeSymbolReader::chunksCount() const
+{
+    return std::max<size_t>(1, m_chunks.size());
+}
+
+LIBNativeSymbolReader::SymbolRefsGen LIBNativeSymbolReader::readChunkRefs(size_t chunk) const
+{
+    uint32_t const begin = static_cast<uint32_t>(chunk) * SymbolsPerChunk;
+    return readRange(begin, std::min(begin + SymbolsPerChunk, m_symbolsCount));
+}
+
+size_t LIBNativeSymbolReader::membersCount() const
+{
+    std::call_once(m_membersListed, [this] { listMembers(); });
+    return m_members.size();
+}
+
+std::string_view LIBNativeSymbolReader::memberName(size_t member) const
+{
+    return m_members[member].name;
+}
+
+ISymbolReader::UPtr LIBNativeSymbolReader::memberReader(size_t member) const
+{
+    detail::ByteView const bytes = m_members[member].bytes;
+    switch (detail::detectImageFormat(bytes))
+    {
+        case detail::ImageFormat::ShortImport:
+            return createShortImportReader(bytes);
+        case detail::ImageFormat::COFF:
+            return COFFNativeParser{}.reader(bytes.bytes());
+        case detail::ImageFormat::MachO:
+            return MachONativeParser{}.reader(bytes.bytes());
+#if SYMSEEK_OS_LIN()
+        case detail::ImageFormat::ELF:
+            return ELFNativeParser{}.reader(bytes.bytes());
+#endif
+        default:
+            return {};
+    }
+}
+
+void LIBNativeSymbolReader::listMembers() const
+{
+    detail::ByteView const archive = m_archive;
+    std::string_view longNames;
+    std::optional<RawMember> member;
+    for (size_t offset = SignatureSize; (member = readMemberAt(archive, offset)); offset = member->nextOffset)
+    {
+        if (member->name == "//")
+        {
+            longNames = { reinterpret_cast<char const *>(member->bytes.data()), member->bytes.size() };
+            continue;
+        }
+        if (std::string_view const name = resolveMemberName(*member, longNames); !name.empty())
+        {
+            m_members.push_back({ .name = name, .bytes = member->bytes });
+        }
+    }
+}
+
+std::string_view LIBNativeSymbolReader::definingMember(std::string_view rawName) const
+{
+    std::call_once(m_symbolsIndexed, [this] { indexSymbols(); });
+
+    auto const nameOf = [this](IndexEntry const & entry) { return std::string_view{ m_sortedNames + entry.name }; };
+    auto const found = std::lower_bound(m_index.begin(), m_index.end(), rawName,
+        [&](IndexEntry const & entry, std::string_view name) { return nameOf(entry) < name; });
+    if (found == m_index.end() || nameOf(*found) != rawName)
+    {
+        return {};
+    }
+    return memberNameAt(found->memberOffset);
+}
+
+void LIBNativeSymbolReader::indexSymbols() const
+{
+    // The linker members and the names table go first, before any other member
+    detail::ByteView const archive = m_archive;
+    std::optional<RawMember> member;
+    for (size_t offset = SignatureSize; (member = readMemberAt(archive, offset)); offset = member->nextOffset)
+    {
+        if (member->name == "//")
+        {
+            m_longNames = { reinterpret_cast<char const *>(member->bytes.data()), member->bytes.size() };
+        }
+        bool const longName = member->name.size() > 1 && member->name[1] >= '0' && member->name[1] <= '9';
+        if (!member->name.starts_with('/') || longName)
+        {
+            break;
+        }
+    }
+
+    if (indexSecondLinkerMember() || indexBSDSymbolTable() || !m_symTable)
+    {
+        return;
+    }
+
+    // GNU archives have the first linker member only, its names follow the order of the members.
+    // See https://docs.microsoft.com/en-us/windows/desktop/debug/pe-format#first-linker-member
+    m_sortedNames = m_symTable;
+    m_index.reserve(m_symbolsCount);
+    char const * name = m_symTable;
+    for (uint32_t i = 0; i < m_symbolsCount && name < m_symTableEnd; ++i)
+    {
+        auto terminator = static_cast<char const *>(std::memchr(name, 0, m_symTableEnd - name));
+        if (!terminator)
+        {
+            break;
+        }
+        m_index.push_back({ .name = static_cast<uint32_t>(name - m_symTable),
+            .memberOffset = detail::loadBigEndian<uint32_t>(m_memberOffsets + sizeof(uint32_t) * i) });
+        name = terminator + 1;
+    }
+
+    // Stable, so the first member defining a name wins, as for the linkers
+    std::stable_sort(m_index.begin(), m_index.end(), [this](IndexEntry const & left, IndexEntry const & right)
+    {
+        return std::string_view{ m_symTable + left.name } < std::string_view{ m_symTable + right.name };
+    });
+}
+
+// See https://docs.microsoft.com/en-us/windows/desktop/debug/pe-format#second-linker-member
+bool LIBNativeSymbolReader::indexSecondLinkerMember() const
+{
+    std::optional<RawMember> first = readMemberAt(m_archive, SignatureSize);
+    std::optional<RawMember> second = first ? readMemberAt(m_archive, first->nextOffset) : std::nullopt;
+    if (!second || second->name != "/" || first->name != "/")
+    {
+        return false;
+    }
+
+    // Little-endian unlike the first one: the members count, their offsets,
+    // the symbols count, the 1-based indices into the offsets and the names sorted lexically
+    detail::ByteView const bytes = second->bytes;
+    uint32_t const membersCount = bytes.loadLittleEndian<uint32_t>(0).value_or(0);
+    uint64_t const symbolsCountOffset = sizeof(uint32_t) + sizeof(uint32_t) * uint64_t{ membersCount };
+    std::optional<uint32_t> const symbolsCount = bytes.loadLittleEndian<uint32_t>(symbolsCountOffset);
+    uint64_t const indicesOffset = symbolsCountOffset + sizeof(uint32_t);
+    if (!symbolsCount || !bytes.contains(indicesOffset, sizeof(uint16_t) * uint64_t{ *symbolsCount }))
+    {
+        return false;
+    }
+    uint8_t const * memberOffsets = bytes.data() + sizeof(uint32_t);
+    uint8_t const * indices = bytes.data() + indicesOffset;
+    detail::ByteView const names = bytes.tail(indicesOffset + sizeof(uint16_t) * *symbolsCount);
+
+    m_sortedNames = reinterpret_cast<char const *>(names.data());
+    m_index.reserve(*symbolsCount);
+    for (size_t i = 0, nameOffset = 0; i < *symbolsCount; ++i)
+    {
+        std::string_view const name = names.string(nameOffset);
+        uint16_t const member = detail::loadLittleEndian<uint16_t>(indices + sizeof(uint16_t) * i);
+        if (!names.contains(nameOffset, name.size() + 1) || !member || member > membersCount)
+        {
+            break;
+        }
+        m_index.push_back({ .name = static_cast<uint32_t>(nameOffset),
+            .memberOffset = detail::loadLittleEndian<uint32_t>(memberOffsets + sizeof(uint32_t) * (member - 1)) });
+        nameOffset += name.size() + /*terminator \0*/1;
+    }
+    return true;
+}
+
+// The ranlib structures of BSD and Darwin, in the byte order of the target
+bool LIBNativeSymbolReader::indexBSDSymbolTable() const
+{
+    std::optional<RawMember> first = readMemberAt(m_archive, SignatureSize);
+    if (!first || !first->name.starts_with("#1/"))
+    {
+        return false;
+    }
+    size_t const nameLength = parseDecimal(first->name.data() + 3, first->name.size() - 3);
+    if (nameLength > first->bytes.size())
+    {
+        return false;
+    }
+    auto nameBytes = reinterpret_cast<char const *>(first->bytes.data());
+    std::string_view const name{ nameBytes, ::strnlen(nameBytes, nameLength) };
+    if (name != "__.SYMDEF" && name != "__.SYMDEF SORTED")
+    {
+        return false;
+    }
+
+    // The size of the ranlib entries, the entries of the name offsets and the member offsets,
+    // the size of the names and the names
+    detail::ByteView const bytes = first->bytes.tail(nameLength);
+    uint32_t const entriesSize = bytes.loadLittleEndian<uint32_t>(0).value_or(0);
+    std::optional<uint32_t> const namesSize = bytes.loadLittleEndian<uint32_t>(sizeof(uint32_t) + uint64_t{ entriesSize });
+    if (!namesSize)
+    {
+        return false;
+    }
+    uint8_t const * entries = bytes.data() + sizeof(uint32_t);
+    // A names table cut short keeps the names which fit
+    detail::ByteView const namesView = bytes.tail(sizeof(uint32_t) * 2 + uint64_t{ entriesSize });
+    detail::ByteView const namesTable = namesView.sub(0, std::min<size_t>(*namesSize, namesView.size()));
+    auto const names = reinterpret_cast<char const *>(namesTable.data());
+
+    m_sortedNames = names;
+    m_index.reserve(entriesSize / 8);
+    for (size_t entry = 0; entry + 8 <= entriesSize; entry += 8)
+    {
+        uint32_t const nameOffset = detail::loadLittleEndian<uint32_t>(entries + entry);
+        std::string_view const name = namesTable.string(nameOffset);
+        if (name.empty())
+        {
+            continue;
+        }
+        m_index.push_back({ .name = nameOffset,
+            .memberOffset = detail::loadLittleEndian<uint32_t>(entries + entry + 4) });
+    }
+
+    std::stable_sort(m_index.begin(), m_index.end(), [names](IndexEntry const & left, IndexEntry const & right)
+    {
+        return std::string_view{ names + left.name } < std::string_view{ names + right.name };
+    });
+    return true;
+}
+
+std::string_view LIBNativeSymbolReader::memberNameAt(size_t memberOffset) const
+{
+    std::optional<RawMember> member = readMemberAt(m_archive, memberOffset);
+    return member ? resolveMemberName(*member, m_longNames) : std::string_view{};
+}
+
+LIBNativeSymbolReader::SymbolRefsGen LIBNativeSymbolReader::readRange(uint32_t begin, uint32_t end) const
+{
+    if (!m_symTable || begin >= end)
+    {
+        co_return;
+    }
+
+    char const * symTable = m_chunks.empty() ? m_symTable : m_chunks[begin / SymbolsPerChunk];
+    for (uint32_t i = begin; i < end && symTable < m_symTableEnd; ++i)
+    {
+        // The last name may be cut off
+        auto terminator = static_cast<char const *>(std::memchr(symTable, 0, m_symTableEnd - symTable));
+        if (!terminator)
+        {
+            break;
+        }
+        RawSymbolRef symbolRef{.name = std::string_view{ symTable, terminator }};
+        symTable = terminator + 1;
+        co_yield symbolRef;
+    }
+}
+
+// See https://docs.microsoft.com/en-us/windows/desktop/debug/pe-format#first-linker-member
+bool LIBNativeSymbolReader::readLinkerMember()
+{
+    if (detail::detectImageFormat(m_archive) != detail::ImageFormat::Archive)
+    {
+        return false;
+    }
+    if (m_archive.size() == SignatureSize)
+    {
+        return true;
+    }
+
+    std::optional<RawMember> first = readMemberAt(m_archive, SignatureSize);
+    if (!first)
+    {
+        return false;
+    }
+    // The archives without the linker member, e.g. BSD ones, only have their members read
+    if (first->name != "/")
+    {
+        return true;
+    }
+
+    // The number of symbols and their offsets are in Big Endian, the names follow
+    detail::ByteView const bytes = first->bytes;
+    std::optional<uint32_t> const symbolsCount = bytes.loadBigEndian<uint32_t>(0);
+    uint64_t const namesOffset = sizeof(uint32_t) + sizeof(uint32_t) * uint64_t{ symbolsCount.value_or(0) };
+    if (!symbolsCount || !bytes.contains(namesOffset, 0))
+    {
+        return false;
+    }
+    m_symbolsCount = *symbolsCount;
+    m_memberOffsets = bytes.data() + sizeof(uint32_t);
+
+    detail::ByteView const names = bytes.tail(namesOffset);
+    m_symTable = reinterpret_cast<char const *>(names.data());
+    m_symTableEnd = m_symTable + names.size();
+
+    // Every name is going to be touched
+    if (m_archiveFile)
+    {
+        m_archiveFile->advise(names.data(), names.size(), detail::AccessHint::WillNeed);
+    }
+    return true;
+}
+
+void LIBNativeSymbolReader::splitSymbolTable()
+{
+    if (m_symbolsCount <= SymbolsPerChunk)
+    {
+        return;
+    }
+
+    char const * symTable = m_symTable;
+    for (uint32_t i = 0; i < m_symbolsCount && symTable < m_symTableEnd; ++i)
+    {
+        if (!(i % SymbolsPerChunk))
+        {
+            m_chunks.push_back(symTable);
+        }
+        auto terminator = static_cast<char const *>(std::memchr(symTable, 0, m_symTableEnd - symTable));
+        symTable = terminator ? terminator + 1 : m_symTableEnd;
+    }
+}
@@ -0,0 +1,172 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek.internal.peformat;
+
+import <bit>;
+import <cstdint>;
+
+// The structures of the PE/COFF images and the archives of them, laid out byte for byte
+// as in the specification, so the Windows binaries are read on any platform without Windows.h.
+// See https://docs.microsoft.com/en-us/windows/win32/debug/pe-format
+
+// The images are little-endian and the headers are read in place
+static_assert(std::endian::native == std::endian::little, "Unsupported byte order");
+
+export namespace SymSeek::detail::pe
+{
+    constexpr uint16_t DosSignature = 0x5A4D;      // "MZ"
+    constexpr uint32_t NtSignature  = 0x00004550;  // "PE\0\0"
+
+    constexpr uint16_t MachineI386  = 0x014C;
+    constexpr uint16_t MachineAmd64 = 0x8664;
+
+    constexpr uint16_t OptionalHeader32Magic = 0x010B;
+    constexpr uint16_t OptionalHeader64Magic = 0x020B;
+
+    enum DirectoryEntry: uint32_t
+    {
+        ExportDirectoryEntry        = 0,
+        ImportDirectoryEntry        = 1,
+        ComDescriptorDirectoryEntry = 14,
+        DirectoryEntriesCount       = 16
+    };
+
+    constexpr uint32_t OrdinalFlag32 = 0x80000000u;
+    constexpr uint64_t OrdinalFlag64 = 0x8000000000000000ull;
+
+    // See https://docs.microsoft.com/en-us/windows/win32/debug/pe-format#section-number-values
+    constexpr int16_t SymbolUndefined = 0;
+    // See https://docs.microsoft.com/en-us/windows/win32/debug/pe-format#storage-class
+    constexpr uint8_t SymbolClassExternal = 2;
+
+#pragma pack(push, 1)
+    struct DosHeader
+    {
+        uint16_t magic;
+        uint8_t  unused[58];
+        int32_t  newHeaderOffset;  // e_lfanew
+    };
+    static_assert(sizeof(DosHeader) == 64);
+
+    struct FileHeader
+    {
+        uint16_t machine;
+        uint16_t numberOfSections;
+        uint32_t timeDateStamp;
+        uint32_t pointerToSymbolTable;
+        uint32_t numberOfSymbols;
+        uint16_t sizeOfOptionalHeader;
+        uint16_t characteristics;
+    };
+    static_assert(sizeof(FileHeader) == 20);
+
+    struct DataDirectory
+    {
+        uint32_t virtualAddress;
+        uint32_t size;
+    };
+
+    // Only the fields the parsers need are named, the rest are kept for the layout
+    struct OptionalHeader32
+    {
+        uint16_t magic;
+        uint8_t  unused[90];
+        uint32_t numberOfRvaAndSizes;
+        DataDirectory dataDirectory[DirectoryEntriesCount];
+    };
+    static_assert(sizeof(OptionalHeader32) == 224);
+
+    struct OptionalHeader64
+    {
+        uint16_t magic;
+        uint8_t  unused[106];
+        uint32_t numberOfRvaAndSizes;
+        DataDirectory dataDirectory[DirectoryEntriesCount];
+    };
+    static_assert(sizeof(OptionalHeader64) == 240);
+
+    template<typename OptionalHeader>
+    struct NtHeaders
+    {
+        uint32_t signature;
+        FileHeader fileHeader;
+        OptionalHeader optionalHeader;
+    };
+    using NtHeaders32 = NtHeaders<OptionalHeader32>;
+    using NtHeaders64 = NtHeaders<OptionalHeader64>;
+    static_assert(sizeof(NtHeaders32) == 248);
+    static_assert(sizeof(NtHeaders64) == 264);
+
+    struct SectionHeader
+    {
+        char     name[8];
+        uint32_t virtualSize;
+        uint32_t virtualAddress;
+        uint32_t sizeOfRawData;
+        uint32_t pointerToRawData;
+        uint32_t pointerToRelocations;
+        uint32_t pointerToLinenumbers;
+        uint16_t numberOfRelocations;
+        uint16_t numberOfLinenumbers;
+        uint32_t characteristics;
+    };
+    static_assert(sizeof(SectionHeader) == 40);
+
+    struct ExportDirectory
+    {
+        uint32_t characteristics;
+        uint32_t timeDateStamp;
+        uint16_t majorVersion;
+        uint16_t minorVersion;
+        uint32_t name;
+        uint32_t base;
+        uint32_t numberOfFunctions;
+        uint32_t numberOfNames;
+        uint32_t addressOfFunctions;
+        uint32_t addressOfNames;
+        uint32_t addressOfNameOrdinals;
+    };
+    static_assert(sizeof(ExportDirectory) == 40);
+
+    struct ImportDescriptor
+    {
+        uint32_t originalFirstThunk;
+        uint32_t timeDateStamp;
+        uint32_t forwarderChain;
+        uint32_t name;
+        uint32_t firstThunk;
+    };
+    static_assert(sizeof(ImportDescriptor) == 20);
+
+    struct ImportByName
+    {
+        uint16_t hint;
+        char     name[1];
+    };
+
+    // The entries of the import lookup tables, either an ordinal or the RVA of an ImportByName
+    using ThunkData32 = uint32_t;
+    using ThunkData64 = uint64_t;
+
+    struct SymbolTableEntry
+    {
+        union
+        {
+            char         shortName[8];
+            struct
+            {
+                uint32_t zeroes;
+                uint32_t offset;
+            };
+        } name;
+        uint32_t value;
+        int16_t  sectionNumber;
+        uint16_t type;
+        uint8_t  storageClass;
+        uint8_t  numberOfAuxSymbols;
+    };
+    static_assert(sizeof(SymbolTableEntry) == 18);
+#pragma pack(pop)
+}
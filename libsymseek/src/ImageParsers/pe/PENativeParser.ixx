@@ -0,0 +1,381 @@
+module;
+
+#include <Debug.h>
+
+#include <symseek/Definitions.h>
+
+export module symseek:parsers.pe;
+
+import <algorithm>;
+import <concepts>;
+import <cstddef>;
+import <cstring>;
+import <iterator>;
+import <memory>;
+import <optional>;
+import <span>;
+import <string>;
+import <string_view>;
+import <type_traits>;
+import <vector>;
+
+import symseek.definitions;
+import symseek.interfaces.parser;
+import symseek.internal.interfaces.mappedfile;
+import symseek.internal.byteview;
+import symseek.internal.helpers;
+import symseek.internal.imageformat;
+import symseek.internal.peformat;
+
+export namespace SymSeek
+{
+    class PENativeParser : public IImageParser
+    {
+    public:
+        ISymbolReader::UPtr reader(String const& imagePath) const override;
+        ISymbolReader::UPtr reader(std::span<uint8_t const> imageBytes) const override;
+        // Of the file open already, see detail::openImage()
+        ISymbolReader::UPtr reader(std::unique_ptr<detail::IMappedFile> imageFile) const;
+    };
+}
+
+// Implementation
+
+using namespace SymSeek;
+
+template<uint16_t Machine>
+struct PETypes;
+
+template<>
+struct PETypes<detail::pe::MachineI386>
+{
+    using NTHeaders = detail::pe::NtHeaders32;
+    using ThunkData = detail::pe::ThunkData32;
+
+    static constexpr auto ImageOrdinalFlag = detail::pe::OrdinalFlag32;
+};
+
+template<>
+struct PETypes<detail::pe::MachineAmd64>
+{
+    using NTHeaders = detail::pe::NtHeaders64;
+    using ThunkData = detail::pe::ThunkData64;
+
+    static constexpr auto ImageOrdinalFlag = detail::pe::OrdinalFlag64;
+};
+
+using FileUPtr = std::unique_ptr<detail::IMappedFile>;
+
+namespace SymSeek::detail
+{
+    template<uint16_t Machine>
+    class PENativeSymbolReader: public ISymbolReader
+    {
+        // Unfortunately cannot inherit from PETypes<Machine> to pull these types into the context :(
+        // MinGW doesn't allow this, Visual Studio does.
+        using NTHeaders = typename PETypes<Machine>::NTHeaders;
+        using ThunkData = typename PETypes<Machine>::ThunkData;
+
+        static constexpr auto ImageOrdinalFlag = PETypes<Machine>::ImageOrdinalFlag;
+
+        // The RVAs of a section which are backed by the file
+        struct Section
+        {
+            uint32_t beginRVA;
+            uint32_t endRVA;
+            uint32_t rawOffset;
+            uint32_t rawSize;
+
+            bool contains(uint64_t virtualAddress) const
+            {
+                return beginRVA <= virtualAddress && virtualAddress < endRVA;
+            }
+        };
+
+        // The index of the section found by the previous lookup. The names and the thunks of a table
+        // are mostly in one section, so the search is rarely needed.
+        using SectionHint = size_t;
+
+        // False when no section has the address
+        bool findSection(uint64_t virtualAddress, SectionHint & hint) const
+        {
+            auto const next = std::upper_bound(m_sections.begin(), m_sections.end(), virtualAddress,
+                [](uint64_t address, Section const & section) { return address < section.beginRVA; });
+            if (next == m_sections.begin() || !std::prev(next)->contains(virtualAddress))
+            {
+                return false;
+            }
+            hint = static_cast<SectionHint>(std::prev(next) - m_sections.begin());
+            return true;
+        }
+
+        // Null unless all the bytes are in the file
+        uint8_t const * mapRange(uint64_t virtualAddress, uint64_t size, SectionHint & hint) const
+        {
+            if ((hint >= m_sections.size() || !m_sections[hint].contains(virtualAddress)) &&
+                !findSection(virtualAddress, hint))
+            {
+                return nullptr;
+            }
+
+            Section const & section = m_sections[hint];
+            uint64_t const delta = virtualAddress - section.beginRVA;
+            if (delta >= section.rawSize || size > section.rawSize - delta)
+            {
+                return nullptr;
+            }
+            return m_module.contains(section.rawOffset + delta, size) ? m_module.data() + section.rawOffset + delta
+                                                                      : nullptr;
+        }
+
+        template<typename T>
+        T const * map(uint64_t virtualAddress, SectionHint & hint, uint64_t count = 1) const
+        {
+            return reinterpret_cast<T const *>(mapRange(virtualAddress, sizeof(T) * count, hint));
+        }
+
+        // The tables of the linkers other than MSVC's aren't always aligned
+        template<std::unsigned_integral T>
+        std::optional<T> load(uint64_t virtualAddress, SectionHint & hint) const
+        {
+            uint8_t const * bytes = mapRange(virtualAddress, sizeof(T), hint);
+            return bytes ? std::optional<T>{ detail::loadLittleEndian<T>(bytes) } : std::nullopt;
+        }
+
+        // Empty unless the string is terminated within the file
+        std::string_view mapString(uint64_t virtualAddress, SectionHint & hint) const
+        {
+            uint8_t const * string = mapRange(virtualAddress, 1, hint);
+            return string ? m_module.string(static_cast<size_t>(string - m_module.data())) : std::string_view{};
+        }
+
+    public:
+        // The headers are checked by PENativeParser
+        PENativeSymbolReader(FileUPtr moduleFile, detail::ByteView module, NTHeaders const * ntHeader)
+        : m_moduleFile{ std::move(moduleFile) }
+        , m_module    { module                }
+        , m_ntHeader  { ntHeader              }
+        {
+            // The section table follows the optional header, whatever its size
+            uint16_t const sectionsCount = m_ntHeader->fileHeader.numberOfSections;
+            size_t const sectionsOffset = static_cast<size_t>(reinterpret_cast<uint8_t const *>(m_ntHeader) -
+                m_module.data()) + offsetof(NTHeaders, optionalHeader) + m_ntHeader->fileHeader.sizeOfOptionalHeader;
+            auto sectionHeaders = m_module.at<pe::SectionHeader>(sectionsOffset, sectionsCount);
+            if (!sectionHeaders)
+            {
+                return;
+            }
+
+            m_sections.reserve(sectionsCount);
+            for (pe::SectionHeader const & header: std::span{ sectionHeaders, sectionsCount })
+            {
+                // The loader zero-fills the tail of the sections which is beyond their raw data
+                uint32_t const rawSize = header.sizeOfRawData;
+                uint32_t const virtualSize = header.virtualSize ? header.virtualSize : rawSize;
+                uint64_t const endRVA = uint64_t{ header.virtualAddress } + virtualSize;
+                if (!virtualSize || endRVA > UINT32_MAX)
+                {
+                    continue;
+                }
+                m_sections.push_back({ .beginRVA = header.virtualAddress, .endRVA = static_cast<uint32_t>(endRVA),
+                    .rawOffset = header.pointerToRawData, .rawSize = std::min(rawSize, virtualSize) });
+            }
+            std::sort(m_sections.begin(), m_sections.end(),
+                [](Section const & left, Section const & right) { return left.beginRVA < right.beginRVA; });
+
+            auto const & directories = m_ntHeader->optionalHeader.dataDirectory;
+            uint32_t const directoriesCount = m_ntHeader->optionalHeader.numberOfRvaAndSizes;
+            SectionHint hint{};
+
+            if (uint32_t exportAddressOffset = directories[pe::ExportDirectoryEntry].virtualAddress;
+                exportAddressOffset && directoriesCount > pe::ExportDirectoryEntry)
+            {
+                m_exportDirectory = map<pe::ExportDirectory>(exportAddressOffset, hint);
+            }
+            if (uint32_t importAddressOffset = directories[pe::ImportDirectoryEntry].virtualAddress;
+                importAddressOffset && directoriesCount > pe::ImportDirectoryEntry)
+            {
+                m_importsRVA = importAddressOffset;
+            }
+
+            if (m_exportDirectory && mapRange(m_exportDirectory->addressOfNames,
+                sizeof(uint32_t) * uint64_t{ m_exportDirectory->numberOfNames }, hint))
+            {
+                m_symbolsCount += m_exportDirectory->numberOfNames;
+            }
+
+            m_valid = true;
+
+            // The lookup tables are walked once more while reading, they are small and already in the cache then
+            for (size_t i = 0; pe::ImportDescriptor const * imp = importDescriptor(i, hint); ++i)
+            {
+                SectionHint thunkHint{};
+                uint64_t thunkRVA = imp->originalFirstThunk;
+                for (std::optional<ThunkData> thunk; (thunk = load<ThunkData>(thunkRVA, thunkHint)) && *thunk;
+                    thunkRVA += sizeof(ThunkData))
+                {
+                    ++m_symbolsCount;
+                }
+            }
+        }
+
+        // False for the images whose section table doesn't fit in the file
+        bool valid() const
+        {
+            return m_valid;
+        }
+
+        size_t symbolsCount() const override
+        {
+            return m_symbolsCount;
+        }
+
+        SymbolRefsGen readSymbolRefs() const override
+        {
+            SectionHint hint{};
+            pe::ExportDirectory const * dir = m_exportDirectory;
+            uint8_t const * names = dir ? mapRange(dir->addressOfNames, sizeof(uint32_t) * uint64_t{ dir->numberOfNames },
+                hint) : nullptr;
+            if (names)  // Has exports
+            {
+                for (uint32_t i = 0; i < dir->numberOfNames; ++i)
+                {
+                    uint32_t const nameRVA = detail::loadLittleEndian<uint32_t>(names + sizeof(uint32_t) * i);
+                    std::string_view const mangledName = mapString(nameRVA, hint);
+                    if (mangledName.empty())
+                    {
+                        continue;
+                    }
+                    co_yield RawSymbolRef{.name = mangledName};
+                }
+            }
+
+            for (size_t i = 0; pe::ImportDescriptor const * imp = importDescriptor(i, hint); ++i)
+            {
+                std::string_view const importedModuleName = mapString(imp->name, hint);
+
+                SectionHint thunkHint{};
+                uint64_t thunkRVA = imp->originalFirstThunk;
+                for (std::optional<ThunkData> thunk; (thunk = load<ThunkData>(thunkRVA, thunkHint)) && *thunk;
+                    thunkRVA += sizeof(ThunkData))
+                {
+                    if (*thunk & ImageOrdinalFlag)
+                    {
+                        // The only name not borrowed from the image, it lives until the next one
+                        std::string name = std::string{ importedModuleName } + "/#" +
+                            detail::toString<std::string>(*thunk ^ ImageOrdinalFlag);
+                        co_yield RawSymbolRef{.name = name, .implements = false};
+                    }
+                    else
+                    {
+                        // Past the hint, see https://docs.microsoft.com/en-us/windows/win32/debug/pe-format#hintname-table
+                        std::string_view const importedName =
+                            mapString(*thunk + offsetof(pe::ImportByName, name), hint);
+                        if (importedName.empty())
+                        {
+                            continue;
+                        }
+                        co_yield RawSymbolRef{.name = importedName, .implements = false};
+                    }
+                }
+            }
+        }
+
+    private:
+        // Null past the null descriptor or the end of the section
+        pe::ImportDescriptor const * importDescriptor(size_t index, SectionHint & hint) const
+        {
+            if (!m_importsRVA)
+            {
+                return nullptr;
+            }
+            auto imp = map<pe::ImportDescriptor>(m_importsRVA + uint64_t{ index } * sizeof(pe::ImportDescriptor), hint);
+            return imp && imp->originalFirstThunk ? imp : nullptr;
+        }
+
+        FileUPtr m_moduleFile;  // Whilst this ptr lives, memory mapping is valid
+        detail::ByteView m_module;
+        NTHeaders const * m_ntHeader{};
+        std::vector<Section> m_sections;  // Sorted by RVA
+        pe::ExportDirectory const * m_exportDirectory{};
+        uint32_t m_importsRVA{};
+        size_t m_symbolsCount{};
+        bool m_valid{};
+    };
+}
+
+namespace
+{
+    template<uint16_t Machine>
+    ISymbolReader::UPtr createPEReader(FileUPtr moduleFile, detail::ByteView module, size_t headersOffset)
+    {
+        auto ntHeader = module.at<typename PETypes<Machine>::NTHeaders>(headersOffset);
+        if (!ntHeader)
+        {
+            return {};
+        }
+
+        // Ignoring CLR/.NET assemblies
+        auto const & optionalHeader = ntHeader->optionalHeader;
+        if (optionalHeader.numberOfRvaAndSizes > detail::pe::ComDescriptorDirectoryEntry &&
+            optionalHeader.dataDirectory[detail::pe::ComDescriptorDirectoryEntry].virtualAddress)
+        {
+            return {};
+        }
+
+        auto reader = std::make_unique<detail::PENativeSymbolReader<Machine>>(std::move(moduleFile), module, ntHeader);
+        return reader->valid() ? std::move(reader) : nullptr;
+    }
+
+    // See https://docs.microsoft.com/en-us/windows/desktop/debug/pe-format
+    ISymbolReader::UPtr createModuleReader(FileUPtr moduleFile, detail::ByteView module)
+    {
+        auto dosHeader = module.at<detail::pe::DosHeader>(0);
+        if (!dosHeader || dosHeader->magic != detail::pe::DosSignature)
+        {
+            return {};
+        }
+        size_t const headersOffset = static_cast<uint32_t>(dosHeader->newHeaderOffset);
+
+        // The signature and the file header are common for both of the bitnesses
+        auto ntHeader = module.at<detail::pe::NtHeaders32>(headersOffset);
+        if (!ntHeader || ntHeader->signature != detail::pe::NtSignature)
+        {
+            return {};
+        }
+
+        uint16_t const machine = ntHeader->fileHeader.machine;
+        if (machine == detail::pe::MachineI386 && ntHeader->optionalHeader.magic == detail::pe::OptionalHeader32Magic)
+        {
+            return createPEReader<detail::pe::MachineI386>(std::move(moduleFile), module, headersOffset);
+        }
+        else if (machine == detail::pe::MachineAmd64 && ntHeader->optionalHeader.magic == detail::pe::OptionalHeader64Magic)
+        {
+            return createPEReader<detail::pe::MachineAmd64>(std::move(moduleFile), module, headersOffset);
+        }
+
+        return {};
+    }
+}
+
+ISymbolReader::UPtr PENativeParser::reader(String const & imagePath) const
+{
+    // Not to map the files which aren't PE at all
+    detail::Image image = detail::openImage(imagePath);
+    if (image.format != detail::ImageFormat::PE)
+    {
+        return {};
+    }
+    return reader(std::move(image.file));
+}
+
+ISymbolReader::UPtr PENativeParser::reader(FileUPtr moduleFile) const
+{
+    detail::ByteView const module{ moduleFile->map(), moduleFile->size() };
+    return createModuleReader(std::move(moduleFile), module);
+}
+
+ISymbolReader::UPtr PENativeParser::reader(std::span<uint8_t const> imageBytes) const
+{
+    return createModuleReader(/*moduleFile=*/nullptr, imageBytes);
+}
@@ -4,10 +4,31 @@ module;
 
 export module symseek.internal.interfaces.mappedfile;
 
+import <cstdint>;
+
 import symseek.definitions;
 
 export namespace SymSeek::detail
 {
+    // Mirrors POSIX madvise(2), the platforms lacking some hints just ignore them
+    enum class AccessHint: uint8_t
+    {
+        Normal,
+        Sequential,
+        Random,
+        WillNeed,
+        DontNeed
+    };
+
+    enum class MapMode: uint8_t
+    {
+        // Pages are faulted in on the first touch
+        Lazy,
+
+        // Pages are read ahead while mapping, handy when the whole range is going to be walked
+        Populate
+    };
+
     class IMappedFile
     {
     public:
@@ -15,11 +36,17 @@ export namespace SymSeek::detail
         virtual bool isOpen() const noexcept = 0;
         virtual size_t size() const noexcept = 0;
         virtual size_t read(void * buffer, size_t length) noexcept = 0;
+        // Doesn't move the current position
+        virtual size_t readAt(size_t offset, void * buffer, size_t length) noexcept = 0;
 
         virtual size_t position() const noexcept = 0;
         virtual void seek(size_t position) noexcept = 0;
 
-        virtual uint8_t const * map(size_t offset = 0, size_t length = 0) noexcept = 0;
+        // Zero length maps up to the end of file, the offset needs no alignment
+        virtual uint8_t const * map(size_t offset = 0, size_t length = 0,
+            MapMode mode = MapMode::Lazy) noexcept = 0;
+        // The range must belong to the current mapping
+        virtual void advise(uint8_t const * address, size_t length, AccessHint hint) noexcept = 0;
         virtual void unmap() noexcept = 0;
         virtual void close() noexcept = 0;
 
@@ -0,0 +1,278 @@
+module;
+
+#include <symseek/Definitions.h>
+
+#if !SYMSEEK_OS_LIN()
+#    error Improper platform
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+export module symseek.internal.mappedfile.linux;
+
+import <cstdint>;
+import <memory>;
+
+import symseek.definitions;
+import symseek.internal.interfaces.mappedfile;
+
+export namespace SymSeek::detail
+{
+    class MappedFile : public IMappedFile
+    {
+    public:
+        MappedFile() = default;
+
+        MappedFile(MappedFile const& other) = delete;
+        MappedFile& operator=(MappedFile const& other) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        void swap(MappedFile& other) noexcept;
+
+        bool open(String const& filePath) noexcept override;
+        bool isOpen() const noexcept override;
+        size_t size() const noexcept override;
+        size_t read(void* buffer, size_t length) noexcept override;
+        size_t readAt(size_t offset, void* buffer, size_t length) noexcept override;
+
+        size_t position() const noexcept override;
+        void seek(size_t distance) noexcept override;
+
+        uint8_t const* map(size_t offset, size_t length, MapMode mode) noexcept override;
+        void advise(uint8_t const* address, size_t length, AccessHint hint) noexcept override;
+        void unmap() noexcept override;
+        void close() noexcept override;
+
+        ~MappedFile() override;
+
+    private:
+        int m_fileDescriptor = -1;
+        size_t m_fileSize{};
+        size_t m_position{};
+        void * m_mappingPtr = MAP_FAILED;
+        size_t m_mappingLength{};
+    };
+}
+
+// Implementation
+
+using namespace SymSeek::detail;
+
+MappedFile::MappedFile(MappedFile && other) noexcept
+{
+    swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile && other) noexcept
+{
+    swap(other);
+    return *this;
+}
+
+void MappedFile::swap(MappedFile & other) noexcept
+{
+    std::swap(m_fileDescriptor, other.m_fileDescriptor);
+    std::swap(m_fileSize, other.m_fileSize);
+    std::swap(m_position, other.m_position);
+    std::swap(m_mappingPtr, other.m_mappingPtr);
+    std::swap(m_mappingLength, other.m_mappingLength);
+}
+
+bool MappedFile::open(String const & filePath) noexcept
+{
+    if (isOpen())
+    {
+        close();
+    }
+
+    m_fileDescriptor = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (!isOpen())
+    {
+        return false;
+    }
+
+    // Directories, pipes and devices cannot be mapped
+    struct stat fileStat{};
+    if (::fstat(m_fileDescriptor, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+    {
+        close();
+        return false;
+    }
+    m_fileSize = static_cast<size_t>(fileStat.st_size);
+    m_position = 0;
+    return true;
+}
+
+bool MappedFile::isOpen() const noexcept
+{
+    return m_fileDescriptor != -1;
+}
+
+size_t MappedFile::size() const noexcept
+{
+    return isOpen() ? m_fileSize : 0;
+}
+
+size_t MappedFile::read(void * buffer, size_t length) noexcept
+{
+    size_t const bytesRead = readAt(m_position, buffer, length);
+    m_position += bytesRead;
+    return bytesRead;
+}
+
+size_t MappedFile::readAt(size_t offset, void * buffer, size_t length) noexcept
+{
+    if (!isOpen())
+    {
+        return {};
+    }
+
+    // pread doesn't need the file offset to be kept in the kernel, so no lseek round trips
+    ssize_t const bytesRead = ::pread(m_fileDescriptor, buffer, length, static_cast<off_t>(offset));
+    if (bytesRead < 0)
+    {
+        return {};
+    }
+
+    return static_cast<size_t>(bytesRead);
+}
+
+size_t MappedFile::position() const noexcept
+{
+    return isOpen() ? m_position : 0;
+}
+
+void MappedFile::seek(size_t distance) noexcept
+{
+    if (!isOpen())
+    {
+        return;
+    }
+
+    m_position = distance;
+}
+
+uint8_t const * MappedFile::map(size_t offset, size_t length, MapMode mode) noexcept
+{
+    if (!isOpen())
+    {
+        return nullptr;
+    }
+
+    if (m_mappingPtr != MAP_FAILED)
+    {
+        unmap();
+    }
+
+    // An empty file cannot be mapped, as well as the range beyond its end
+    if (offset >= m_fileSize)
+    {
+        return nullptr;
+    }
+
+    if (!length || length > m_fileSize - offset)
+    {
+        length = m_fileSize - offset;
+    }
+
+    static size_t const pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+
+    // Aligning offset to the page size
+    size_t const fileMapStart = (offset / pageSize) * pageSize;
+    size_t const viewDelta = offset - fileMapStart;
+
+    int flags = MAP_PRIVATE;
+    if (mode == MapMode::Populate)
+    {
+        flags |= MAP_POPULATE;
+    }
+
+    m_mappingLength = length + viewDelta;
+    m_mappingPtr = ::mmap(/*addr=*/nullptr, m_mappingLength, PROT_READ, flags,
+        m_fileDescriptor, static_cast<off_t>(fileMapStart));
+
+    if (m_mappingPtr == MAP_FAILED)
+    {
+        m_mappingLength = 0;
+        return nullptr;
+    }
+
+    return static_cast<uint8_t const *>(m_mappingPtr) + viewDelta;
+}
+
+void MappedFile::advise(uint8_t const * address, size_t length, AccessHint hint) noexcept
+{
+    if (m_mappingPtr == MAP_FAILED || !address || !length)
+    {
+        return;
+    }
+
+    auto const mappingBegin = reinterpret_cast<uintptr_t>(m_mappingPtr);
+    auto const mappingEnd = mappingBegin + m_mappingLength;
+    auto begin = reinterpret_cast<uintptr_t>(address);
+    if (begin < mappingBegin || begin >= mappingEnd)
+    {
+        return;
+    }
+    uintptr_t const end = length > mappingEnd - begin ? mappingEnd : begin + length;
+
+    // madvise wants a page aligned address, the mapping itself is aligned
+    static uintptr_t const pageSize = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+    begin = mappingBegin + ((begin - mappingBegin) / pageSize) * pageSize;
+
+    int advice = MADV_NORMAL;
+    switch (hint)
+    {
+        case AccessHint::Normal:
+            advice = MADV_NORMAL;
+            break;
+        case AccessHint::Sequential:
+            advice = MADV_SEQUENTIAL;
+            break;
+        case AccessHint::Random:
+            advice = MADV_RANDOM;
+            break;
+        case AccessHint::WillNeed:
+            advice = MADV_WILLNEED;
+            break;
+        case AccessHint::DontNeed:
+            advice = MADV_DONTNEED;
+            break;
+    }
+
+    // Just a hint, nothing to do if the kernel disagrees
+    ::madvise(reinterpret_cast<void *>(begin), end - begin, advice);
+}
+
+void MappedFile::unmap() noexcept
+{
+    if (m_mappingPtr != MAP_FAILED)
+    {
+        ::munmap(m_mappingPtr, m_mappingLength);
+        m_mappingPtr = MAP_FAILED;
+        m_mappingLength = 0;
+    }
+}
+
+void MappedFile::close() noexcept
+{
+    if (m_fileDescriptor != -1)
+    {
+        unmap();
+
+        ::close(m_fileDescriptor);
+        m_fileDescriptor = -1;
+        m_fileSize = 0;
+        m_position = 0;
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
@@ -10,6 +10,7 @@ module;
 
 export module symseek.internal.mappedfile.win;
 
+import <algorithm>;
 import <cstdint>;
 import <memory>;
 
@@ -35,11 +36,13 @@ export namespace SymSeek::detail
         bool isOpen() const noexcept override;
         size_t size() const noexcept override;
         size_t read(void* buffer, size_t length) noexcept override;
+        size_t readAt(size_t offset, void* buffer, size_t length) noexcept override;
 
         size_t position() const noexcept override;
         void seek(size_t distance) noexcept override;
 
-        uint8_t const* map(size_t offset, size_t length) noexcept override;
+        uint8_t const* map(size_t offset, size_t length, MapMode mode) noexcept override;
+        void advise(uint8_t const* address, size_t length, AccessHint hint) noexcept override;
         void unmap() noexcept override;
         void close() noexcept override;
 
@@ -49,6 +52,7 @@ export namespace SymSeek::detail
         HANDLE m_fileHandle = INVALID_HANDLE_VALUE;
         HANDLE m_mappingHandle = INVALID_HANDLE_VALUE;
         LPCVOID m_mappingPtr = nullptr;
+        size_t m_mappingLength{};
     };
 }
 
@@ -72,6 +76,7 @@ void MappedFile::swap(MappedFile & other) noexcept
     std::swap(m_fileHandle, other.m_fileHandle);
     std::swap(m_mappingHandle, other.m_mappingHandle);
     std::swap(m_mappingPtr, other.m_mappingPtr);
+    std::swap(m_mappingLength, other.m_mappingLength);
 }
 
 bool MappedFile::open(String const & filePath) noexcept
@@ -125,6 +130,31 @@ size_t MappedFile::read(void * buffer, size_t length) noexcept
     return bytesRead;
 }
 
+size_t MappedFile::readAt(size_t offset, void * buffer, size_t length) noexcept
+{
+    if (!isOpen())
+    {
+        return {};
+    }
+
+    // Synchronous handle, the read still moves the file pointer, so restoring it
+    size_t const currentPosition = position();
+
+    ULARGE_INTEGER uniOffset{};
+    uniOffset.QuadPart = offset;
+
+    OVERLAPPED overlapped{};
+    overlapped.Offset = uniOffset.LowPart;
+    overlapped.OffsetHigh = uniOffset.HighPart;
+
+    DWORD bytesRead{};
+    BOOL const succeeded = ::ReadFile(m_fileHandle, buffer, static_cast<DWORD>(length), &bytesRead,
+        &overlapped);
+    seek(currentPosition);
+
+    return succeeded ? bytesRead : 0;
+}
+
 size_t MappedFile::position() const noexcept
 {
     if (!isOpen())
@@ -156,7 +186,7 @@ void MappedFile::seek(size_t distance) noexcept
     ::SetFilePointer(m_fileHandle, uniDistance.LowPart, &uniDistance.HighPart, FILE_BEGIN);
 }
 
-uint8_t const * MappedFile::map(size_t offset, size_t length) noexcept
+uint8_t const * MappedFile::map(size_t offset, size_t length, MapMode mode) noexcept
 {
     if (!isOpen())
     {
@@ -186,6 +216,17 @@ uint8_t const * MappedFile::map(size_t offset, size_t length) noexcept
         return sysInfo.dwAllocationGranularity;
     }();
 
+    size_t const fileSize = size();
+    if (offset >= fileSize)
+    {
+        return nullptr;
+    }
+
+    if (!length || length > fileSize - offset)
+    {
+        length = fileSize - offset;
+    }
+
     // Aligning offset to the allocation granularity
     size_t const fileMapStart = (offset / granularity) * granularity;
     size_t const viewDelta = offset - fileMapStart;
@@ -193,15 +234,51 @@ uint8_t const * MappedFile::map(size_t offset, size_t length) noexcept
     ULARGE_INTEGER uniOffset{};
     uniOffset.QuadPart = fileMapStart;
 
+    // The view starts at the aligned offset, so it must be longer by the delta
+    m_mappingLength = length + viewDelta;
     m_mappingPtr = ::MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 
-        uniOffset.HighPart, uniOffset.LowPart, length);
+        uniOffset.HighPart, uniOffset.LowPart, m_mappingLength);
 
     if (!m_mappingPtr)
     {
+        m_mappingLength = 0;
         return nullptr;
     }
 
-    return static_cast<uint8_t const *>(m_mappingPtr) + viewDelta;
+    uint8_t const * result = static_cast<uint8_t const *>(m_mappingPtr) + viewDelta;
+    if (mode == MapMode::Populate)
+    {
+        advise(result, length, AccessHint::WillNeed);
+    }
+
+    return result;
+}
+
+void MappedFile::advise(uint8_t const * address, size_t length, AccessHint hint) noexcept
+{
+    if (!m_mappingPtr || !address || !length)
+    {
+        return;
+    }
+
+    auto const mappingBegin = static_cast<uint8_t const *>(m_mappingPtr);
+    auto const mappingEnd = mappingBegin + m_mappingLength;
+    if (address < mappingBegin || address >= mappingEnd)
+    {
+        return;
+    }
+    length = std::min<size_t>(length, mappingEnd - address);
+
+    // Only the prefetching has a counterpart in WinAPI
+#if _WIN32_WINNT >= 0x0602
+    if (hint == AccessHint::WillNeed)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range{};
+        range.VirtualAddress = const_cast<uint8_t *>(address);
+        range.NumberOfBytes = length;
+        ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+    }
+#endif
 }
 
 void MappedFile::unmap() noexcept
@@ -213,6 +290,7 @@ void MappedFile::unmap() noexcept
         {
             ::UnmapViewOfFile(m_mappingPtr);
             m_mappingPtr = nullptr;
+            m_mappingLength = 0;
         }
 
         ::CloseHandle(m_mappingHandle);
@@ -0,0 +1,408 @@
+module;
+
+#include <symseek/Definitions.h>
+
+#if SYMSEEK_ARCH_X86()
+#   include <immintrin.h>
+#   if defined(_MSC_VER)
+#       include <intrin.h>
+#   endif
+#endif
+
+#include <Debug.h>
+
+module symseek.matcher;
+
+import <algorithm>;
+import <bit>;
+import <cstring>;
+import <limits>;
+import <queue>;
+
+using namespace SymSeek;
+
+namespace
+{
+    constexpr uint32_t NoOutput = std::numeric_limits<uint32_t>::max();
+
+    // More patterns share the buckets too much, the automaton is faster then
+    constexpr size_t MaxTeddyPatterns = 32;
+
+    constexpr size_t MaxFingerprintLength = 3;
+    using NibbleMasks = std::array<std::array<uint8_t, 16>, MaxFingerprintLength>;
+
+#if SYMSEEK_ARCH_X86()
+    // The candidate starts of a block are the bytes having any bucket bit set
+    // after AND-ing the nibble lookups of the fingerprint bytes following them.
+    // The block is loaded at every fingerprint offset, no byte shuffling across the blocks is needed.
+    template<typename Verify>
+    SYMSEEK_TARGET("sse4.2")
+    std::optional<size_t> teddyBlockSSE42(char const * block, size_t position, size_t fingerprintLength,
+        __m128i const * low, __m128i const * high, Verify const & verify) noexcept
+    {
+        __m128i const nibble = _mm_set1_epi8(0x0F);
+        __m128i candidates = _mm_set1_epi8(-1);
+        for (size_t k = 0; k < fingerprintLength; ++k)
+        {
+            __m128i const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const *>(block + k));
+            __m128i const lowNibbles = _mm_and_si128(bytes, nibble);
+            __m128i const highNibbles = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble);
+            candidates = _mm_and_si128(candidates, _mm_and_si128(
+                _mm_shuffle_epi8(low[k], lowNibbles), _mm_shuffle_epi8(high[k], highNibbles)));
+        }
+
+        uint32_t positions = ~static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(candidates, _mm_setzero_si128()))) & 0xFFFF;
+        if (!positions)
+        {
+            return std::nullopt;
+        }
+
+        alignas(16) uint8_t buckets[16];
+        _mm_store_si128(reinterpret_cast<__m128i *>(buckets), candidates);
+        for (; positions; positions &= positions - 1)
+        {
+            size_t const offset = static_cast<size_t>(std::countr_zero(positions));
+            if (auto found = verify(position + offset, buckets[offset]))
+            {
+                return found;
+            }
+        }
+        return std::nullopt;
+    }
+
+    template<typename Verify>
+    SYMSEEK_TARGET("sse4.2")
+    std::optional<size_t> teddySSE42(std::string_view text, size_t fingerprintLength,
+        NibbleMasks const & lowMasks, NibbleMasks const & highMasks, Verify const & verify) noexcept
+    {
+        constexpr size_t BlockSize = 16;
+
+        __m128i low[MaxFingerprintLength];
+        __m128i high[MaxFingerprintLength];
+        for (size_t k = 0; k < fingerprintLength; ++k)
+        {
+            low[k] = _mm_loadu_si128(reinterpret_cast<__m128i const *>(lowMasks[k].data()));
+            high[k] = _mm_loadu_si128(reinterpret_cast<__m128i const *>(highMasks[k].data()));
+        }
+
+        size_t position = 0;
+        for (; position + BlockSize + fingerprintLength - 1 <= text.size(); position += BlockSize)
+        {
+            if (auto found = teddyBlockSSE42(text.data() + position, position, fingerprintLength, low, high, verify))
+            {
+                return found;
+            }
+        }
+
+        // The rest is shorter than a block and its fingerprint tail, it is padded with zeroes.
+        // Whatever the padding matches is rejected by the verification against the text.
+        if (position < text.size())
+        {
+            char tail[BlockSize + MaxFingerprintLength - 1]{};
+            std::memcpy(tail, text.data() + position, text.size() - position);
+            return teddyBlockSSE42(tail, position, fingerprintLength, low, high, verify);
+        }
+        return std::nullopt;
+    }
+
+    template<typename Verify>
+    SYMSEEK_TARGET("avx2")
+    std::optional<size_t> teddyBlockAVX2(char const * block, size_t position, size_t fingerprintLength,
+        __m256i const * low, __m256i const * high, Verify const & verify) noexcept
+    {
+        __m256i const nibble = _mm256_set1_epi8(0x0F);
+        __m256i candidates = _mm256_set1_epi8(-1);
+        for (size_t k = 0; k < fingerprintLength; ++k)
+        {
+            __m256i const bytes = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(block + k));
+            __m256i const lowNibbles = _mm256_and_si256(bytes, nibble);
+            __m256i const highNibbles = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble);
+            candidates = _mm256_and_si256(candidates, _mm256_and_si256(
+                _mm256_shuffle_epi8(low[k], lowNibbles), _mm256_shuffle_epi8(high[k], highNibbles)));
+        }
+
+        uint32_t positions = ~static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(candidates, _mm256_setzero_si256())));
+        if (!positions)
+        {
+            return std::nullopt;
+        }
+
+        alignas(32) uint8_t buckets[32];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(buckets), candidates);
+        for (; positions; positions &= positions - 1)
+        {
+            size_t const offset = static_cast<size_t>(std::countr_zero(positions));
+            if (auto found = verify(position + offset, buckets[offset]))
+            {
+                return found;
+            }
+        }
+        return std::nullopt;
+    }
+
+    template<typename Verify>
+    SYMSEEK_TARGET("avx2")
+    std::optional<size_t> teddyAVX2(std::string_view text, size_t fingerprintLength,
+        NibbleMasks const & lowMasks, NibbleMasks const & highMasks, Verify const & verify) noexcept
+    {
+        constexpr size_t BlockSize = 32;
+
+        // VPSHUFB looks up within each 128-bit lane, so both lanes get the same table
+        __m256i low[MaxFingerprintLength];
+        __m256i high[MaxFingerprintLength];
+        for (size_t k = 0; k < fingerprintLength; ++k)
+        {
+            low[k] = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<__m128i const *>(lowMasks[k].data())));
+            high[k] = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<__m128i const *>(highMasks[k].data())));
+        }
+
+        size_t position = 0;
+        for (; position + BlockSize + fingerprintLength - 1 <= text.size(); position += BlockSize)
+        {
+            if (auto found = teddyBlockAVX2(text.data() + position, position, fingerprintLength, low, high, verify))
+            {
+                return found;
+            }
+        }
+
+        if (position < text.size())
+        {
+            char tail[BlockSize + MaxFingerprintLength - 1]{};
+            std::memcpy(tail, text.data() + position, text.size() - position);
+            return teddyBlockAVX2(tail, position, fingerprintLength, low, high, verify);
+        }
+        return std::nullopt;
+    }
+#endif
+}
+
+namespace SymSeek
+{
+    InstructionSet detectInstructionSet()
+    {
+#if SYMSEEK_ARCH_X86()
+#   if defined(_MSC_VER)
+        int info[4]{};
+        __cpuid(info, 0);
+        int const maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        bool const sse42 = info[2] & (1 << 20);
+        bool const osSavesAVX = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) &&
+            (_xgetbv(0) & 0b110) == 0b110;
+        bool avx2 = false;
+        if (osSavesAVX && maxLeaf >= 7)
+        {
+            __cpuidex(info, 7, 0);
+            avx2 = info[1] & (1 << 5);
+        }
+#   else
+        __builtin_cpu_init();
+        bool const sse42 = __builtin_cpu_supports("sse4.2");
+        bool const avx2 = __builtin_cpu_supports("avx2");
+#   endif
+        if (avx2)
+        {
+            return InstructionSet::AVX2;
+        }
+        if (sse42)
+        {
+            return InstructionSet::SSE42;
+        }
+#endif
+        return InstructionSet::Scalar;
+    }
+}
+
+SubstringMatcher::SubstringMatcher(std::vector<std::string> patterns, InstructionSet limit)
+: m_patterns{ std::move(patterns) }
+{
+    static InstructionSet const supported = detectInstructionSet();
+    m_instructionSet = std::min(supported, limit);
+
+    if (m_patterns.empty())
+    {
+        return;
+    }
+
+    auto const shortest = std::min_element(m_patterns.begin(), m_patterns.end(),
+        [](std::string const & lhs, std::string const & rhs) { return lhs.size() < rhs.size(); });
+    m_minLength = shortest->size();
+    if (!m_minLength)
+    {
+        m_emptyPattern = static_cast<size_t>(shortest - m_patterns.begin());
+        return;
+    }
+
+    m_useTeddy = m_instructionSet != InstructionSet::Scalar && m_patterns.size() <= MaxTeddyPatterns;
+    if (m_useTeddy)
+    {
+        buildTeddy();
+    }
+    else
+    {
+        buildAutomaton();
+    }
+}
+
+std::optional<size_t> SubstringMatcher::find(std::string_view text) const noexcept
+{
+    if (m_emptyPattern)
+    {
+        return m_emptyPattern;
+    }
+    if (m_patterns.empty() || text.size() < m_minLength)
+    {
+        return std::nullopt;
+    }
+    return m_useTeddy ? findTeddy(text) : findAutomaton(text);
+}
+
+void SubstringMatcher::buildTeddy()
+{
+    m_fingerprintLength = std::min(m_minLength, MaxFingerprintLength);
+    for (uint32_t index = 0; index < m_patterns.size(); ++index)
+    {
+        size_t const bucket = index % BucketsCount;
+        m_buckets[bucket].push_back(index);
+
+        for (size_t k = 0; k < m_fingerprintLength; ++k)
+        {
+            uint8_t const byte = static_cast<uint8_t>(m_patterns[index][k]);
+            m_lowMasks[k][byte & 0x0F] |= uint8_t(1u << bucket);
+            m_highMasks[k][byte >> 4] |= uint8_t(1u << bucket);
+        }
+    }
+}
+
+std::optional<size_t> SubstringMatcher::verify(std::string_view text, size_t position, uint8_t buckets) const noexcept
+{
+    std::string_view const rest = text.substr(std::min(position, text.size()));
+    for (; buckets; buckets &= buckets - 1)
+    {
+        for (uint32_t index: m_buckets[std::countr_zero(buckets)])
+        {
+            if (rest.starts_with(m_patterns[index]))
+            {
+                return index;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<size_t> SubstringMatcher::findTeddy(std::string_view text) const noexcept
+{
+#if SYMSEEK_ARCH_X86()
+    auto const verifier = [this, text](size_t position, uint8_t buckets) {
+        return verify(text, position, buckets);
+    };
+
+    switch (m_instructionSet)
+    {
+        case InstructionSet::AVX2:
+            return teddyAVX2(text, m_fingerprintLength, m_lowMasks, m_highMasks, verifier);
+        case InstructionSet::SSE42:
+            return teddySSE42(text, m_fingerprintLength, m_lowMasks, m_highMasks, verifier);
+        case InstructionSet::Scalar:
+            break;
+    }
+#endif
+    GUARD(!"Teddy needs SIMD");
+    return findAutomaton(text);
+}
+
+// See https://en.wikipedia.org/wiki/Aho%E2%80%93Corasick_algorithm
+void SubstringMatcher::buildAutomaton()
+{
+    // Compressing the alphabet keeps the table small even for hundreds of patterns
+    m_classesCount = 1;
+    for (auto const & pattern: m_patterns)
+    {
+        for (char c: pattern)
+        {
+            uint16_t & byteClass = m_byteClasses[static_cast<uint8_t>(c)];
+            if (!byteClass)
+            {
+                byteClass = static_cast<uint16_t>(m_classesCount++);
+            }
+        }
+    }
+
+    // Trie first, zero transitions are the missing ones as no edge leads back to the root
+    m_transitions.assign(m_classesCount, 0);
+    m_outputs.assign(1, NoOutput);
+    for (uint32_t index = 0; index < m_patterns.size(); ++index)
+    {
+        uint32_t state = 0;
+        for (char c: m_patterns[index])
+        {
+            size_t const edge = state * m_classesCount + m_byteClasses[static_cast<uint8_t>(c)];
+            if (!m_transitions[edge])
+            {
+                m_transitions[edge] = static_cast<uint32_t>(m_outputs.size());
+                m_outputs.push_back(NoOutput);
+                m_transitions.resize(m_transitions.size() + m_classesCount, 0);
+            }
+            state = m_transitions[edge];
+        }
+        if (m_outputs[state] == NoOutput)
+        {
+            m_outputs[state] = index;
+        }
+    }
+
+    // Then the failure links are folded into a complete DFA, breadth-first
+    std::vector<uint32_t> failures(m_outputs.size(), 0);
+    std::queue<uint32_t> states;
+    for (size_t byteClass = 0; byteClass < m_classesCount; ++byteClass)
+    {
+        if (uint32_t next = m_transitions[byteClass])
+        {
+            states.push(next);
+        }
+    }
+    while (!states.empty())
+    {
+        uint32_t const state = states.front();
+        states.pop();
+        uint32_t const failure = failures[state];
+        if (m_outputs[state] == NoOutput)
+        {
+            m_outputs[state] = m_outputs[failure];
+        }
+
+        for (size_t byteClass = 0; byteClass < m_classesCount; ++byteClass)
+        {
+            uint32_t & next = m_transitions[state * m_classesCount + byteClass];
+            uint32_t const fallback = m_transitions[failure * m_classesCount + byteClass];
+            if (next)
+            {
+                failures[next] = fallback;
+                states.push(next);
+            }
+            else
+            {
+                next = fallback;
+            }
+        }
+    }
+}
+
+std::optional<size_t> SubstringMatcher::findAutomaton(std::string_view text) const noexcept
+{
+    uint32_t state = 0;
+    for (char c: text)
+    {
+        state = m_transitions[state * m_classesCount + m_byteClasses[static_cast<uint8_t>(c)]];
+        if (m_outputs[state] != NoOutput)
+        {
+            return m_outputs[state];
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,258 @@
+module;
+
+#include <symseek/Definitions.h>
+
+module symseek.prefilter;
+
+import <algorithm>;
+import <span>;
+
+import symseek.definitions;
+import symseek.dispatcher;
+
+using namespace SymSeek;
+using SymSeek::detail::RequiredToken;
+
+namespace
+{
+    // Words a demangler may print without them being spelled in the mangled name:
+    // builtin types, qualifiers, keywords, the std:: abbreviations and the placeholders of unnamed entities.
+    // Some of them are only printed for the encodings listed next to them.
+    struct Word
+    {
+        std::string_view text;
+        std::string_view encodings;  // Space separated, empty for any mangled name
+    };
+
+    constexpr Word commonWords[] = {
+        { "__restrict" }, { "auto" }, { "bool" }, { "char" }, { "char16_t" }, { "char32_t" }, { "char8_t" },
+        { "co_await" }, { "const" }, { "const_cast" }, { "decltype" }, { "delete" }, { "double" },
+        { "dynamic_cast" }, { "false" }, { "float" }, { "int" }, { "long" }, { "new" }, { "noexcept" },
+        { "nullptr" }, { "operator" }, { "reinterpret_cast" }, { "short" }, { "signed" }, { "sizeof" },
+        { "static_cast" }, { "template" }, { "this" }, { "throw" }, { "true" }, { "type" }, { "typeid" },
+        { "typename" }, { "unsigned" }, { "void" }, { "volatile" }, { "wchar_t" },
+    };
+
+    // See https://itanium-cxx-abi.github.io/cxx-abi/abi.html#mangling-builtin
+    // and https://itanium-cxx-abi.github.io/cxx-abi/abi.html#mangling-compression
+    constexpr std::string_view itaniumStdAbbreviations = "St Sa Sb Ss Si So Sd";
+    constexpr std::string_view itaniumStreamAbbreviations = "Si So Sd";
+    constexpr Word itaniumWords[] = {
+        { "_BitInt" }, { "_Float128" }, { "_Float16" }, { "_Float32" }, { "_Float32x" }, { "_Float64" },
+        { "_Float64x" }, { "__alignof__" }, { "__bf16" }, { "__float128" }, { "__int128" }, { "abi" },
+        { "alignof" }, { "bfloat16_t" }, { "decimal128" }, { "decimal32" }, { "decimal64" }, { "half" },
+        { "parm" }, { "requires" }, { "restrict" }, { "transaction_safe" }, { "unnamed" },
+        { "__vector", "Dv" },
+        { "allocator", "Sa Sb Ss Si So Sd" },
+        { "anonymous", "_GLOBAL__N" },
+        { "arg", "Ed" },
+        { "basic_iostream", itaniumStreamAbbreviations },
+        { "basic_istream", itaniumStreamAbbreviations },
+        { "basic_ostream", itaniumStreamAbbreviations },
+        { "basic_string", "Sb Ss" },
+        { "char_traits", "Ss Si So Sd" },
+        { "clone", "." },
+        { "default", "Ed" },
+        { "iostream", itaniumStreamAbbreviations },
+        { "istream", itaniumStreamAbbreviations },
+        { "lambda", "Ul" },
+        { "literal", "Es" },
+        { "namespace", "_GLOBAL__N" },
+        { "ostream", itaniumStreamAbbreviations },
+        { "std", itaniumStdAbbreviations },
+        { "string", "Sb Ss Es" },
+    };
+
+    // See https://en.wikiversity.org/wiki/Visual_C%2B%2B_name_mangling
+    constexpr Word microsoftWords[] = {
+        { "__based" }, { "__cdecl" }, { "__clrcall" }, { "__eabi" }, { "__far" }, { "__fastcall" },
+        { "__fortran" }, { "__huge" }, { "__int128" }, { "__int16" }, { "__int32" }, { "__int64" },
+        { "__int8" }, { "__near" }, { "__pascal" }, { "__ptr32" }, { "__ptr64" }, { "__regcall" },
+        { "__stdcall" }, { "__swift_1" }, { "__swift_2" }, { "__thiscall" }, { "__unaligned" },
+        { "__vectorcall" }, { "__w64" }, { "adjustor" }, { "array" }, { "class" }, { "cli" }, { "coclass" },
+        { "cointerface" }, { "enum" }, { "extern" }, { "generic" }, { "interior_ptr" }, { "non" },
+        { "parameter" }, { "pin_ptr" }, { "private" }, { "protected" }, { "public" }, { "static" },
+        { "string" }, { "struct" }, { "thunk" }, { "union" }, { "unknown" }, { "virtual" }, { "vtordisp" },
+        { "vtordispex" },
+        { "anonymous", "?A" },
+        { "namespace", "?A" },
+        { "nullptr_t", "$$T" },
+        { "std", "$$T" },
+    };
+
+    // Special names (vtables, typeinfo, guard variables, thunks, RTTI, closures and so on)
+    // are mostly made of synthesized words, they are never rejected
+    constexpr std::string_view itaniumSpecialPrefixes[] = { "_ZT", "_ZG" };
+    constexpr std::string_view microsoftSpecialPrefixes[] = { "??_" };
+
+    bool isIdentifierChar(char c) noexcept
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    bool isDigit(char c) noexcept
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    // The tail of a number literal: hexadecimal digits of the floating point ones and the suffixes
+    bool mayEndLiteral(std::string_view token) noexcept
+    {
+        return std::all_of(token.begin(), token.end(), [](char c) {
+            return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F') ||
+                c == 'u' || c == 'U' || c == 'l' || c == 'L';
+        });
+    }
+
+    struct Token
+    {
+        std::string_view text;
+        // The query cuts the identifier the token is a part of
+        bool openLeft{};
+        bool openRight{};
+    };
+
+    bool maySynthesize(Token const & token, std::string_view word) noexcept
+    {
+        if (token.openLeft && token.openRight)
+        {
+            return word.find(token.text) != std::string_view::npos;
+        }
+        if (token.openLeft)
+        {
+            return word.ends_with(token.text);
+        }
+        if (token.openRight)
+        {
+            return word.starts_with(token.text);
+        }
+        return word == token.text;
+    }
+
+    // Adds the encodings which may print the token to the exemptions,
+    // false when any mangled name may print it
+    bool collectExemptions(Token const & token, std::span<Word const> words, std::vector<std::string> & exemptions)
+    {
+        for (Word const & word: words)
+        {
+            if (!maySynthesize(token, word.text))
+            {
+                continue;
+            }
+            if (word.encodings.empty())
+            {
+                return false;
+            }
+            for (size_t begin = 0; begin < word.encodings.size();)
+            {
+                size_t end = std::min(word.encodings.find(' ', begin), word.encodings.size());
+                exemptions.emplace_back(word.encodings.substr(begin, end - begin));
+                begin = end + 1;
+            }
+        }
+        return true;
+    }
+
+    // Numbers are printed from their own encodings
+    bool mayBeNumber(Token const & token) noexcept
+    {
+        return isDigit(token.text.front()) || (token.openLeft && mayEndLiteral(token.text));
+    }
+
+    void addToken(Token const & token, std::span<Word const> words, std::vector<RequiredToken> & tokens)
+    {
+        RequiredToken required{ .text = std::string{ token.text } };
+        if (collectExemptions(token, commonWords, required.unless) &&
+            collectExemptions(token, words, required.unless))
+        {
+            tokens.push_back(std::move(required));
+        }
+    }
+
+    // The longest ones first, they are the most selective
+    void sortTokens(std::vector<RequiredToken> & tokens)
+    {
+        std::stable_sort(tokens.begin(), tokens.end(), [](RequiredToken const & lhs, RequiredToken const & rhs) {
+            return lhs.text.size() > rhs.text.size();
+        });
+    }
+
+    bool hasAnyPrefix(std::string_view rawName, std::span<std::string_view const> prefixes) noexcept
+    {
+        return std::any_of(prefixes.begin(), prefixes.end(), [rawName](std::string_view prefix) {
+            return rawName.starts_with(prefix);
+        });
+    }
+
+    bool contains(std::string_view rawName, std::string_view part) noexcept
+    {
+        return rawName.find(part) != std::string_view::npos;
+    }
+
+    bool containsAll(std::string_view rawName, std::vector<RequiredToken> const & tokens) noexcept
+    {
+        return std::all_of(tokens.begin(), tokens.end(), [rawName](RequiredToken const & token) {
+            return contains(rawName, token.text) ||
+                std::any_of(token.unless.begin(), token.unless.end(), [rawName](std::string const & encoding) {
+                    return contains(rawName, encoding);
+                });
+        });
+    }
+}
+
+RawNamePrefilter::RawNamePrefilter(std::string_view query)
+: m_query{ query }
+{
+    for (size_t begin = 0; begin < query.size();)
+    {
+        if (!isIdentifierChar(query[begin]))
+        {
+            ++begin;
+            continue;
+        }
+
+        size_t end = begin;
+        while (end < query.size() && isIdentifierChar(query[end]))
+        {
+            ++end;
+        }
+
+        Token const token{
+            .text      = query.substr(begin, end - begin),
+            .openLeft  = begin == 0,
+            .openRight = end == query.size()
+        };
+        begin = end;
+
+        if (!mayBeNumber(token))
+        {
+            addToken(token, itaniumWords, m_itaniumTokens);
+            addToken(token, microsoftWords, m_microsoftTokens);
+        }
+    }
+
+    sortTokens(m_itaniumTokens);
+    sortTokens(m_microsoftTokens);
+}
+
+bool RawNamePrefilter::operator()(std::string_view rawName) const noexcept
+{
+    // Classified as the dispatcher does, any name it leaves undemangled is matched as it is
+    switch (detectMangler(rawName))
+    {
+        case Mangler::GCC:
+        {
+            // Mach-O spells "_Z" as "__Z", the dispatcher strips the underscore as well
+            std::string_view const name = rawName.starts_with("__") ? rawName.substr(1) : rawName;
+            return hasAnyPrefix(name, itaniumSpecialPrefixes) || containsAll(name, m_itaniumTokens);
+        }
+        case Mangler::MSVC:
+            return hasAnyPrefix(rawName, microsoftSpecialPrefixes) || containsAll(rawName, m_microsoftTokens);
+        case Mangler::Rust:
+        case Mangler::Swift:
+        case Mangler::D:
+        case Mangler::None:
+            break;
+    }
+    return contains(rawName, m_query);
+}
@@ -0,0 +1,646 @@
+module;
+
+#include <symseek/Definitions.h>
+
+#include <Debug.h>
+
+module symseek.scanner;
+
+import <algorithm>;
+import <atomic>;
+import <condition_variable>;
+import <deque>;
+import <map>;
+import <mutex>;
+import <optional>;
+import <span>;
+import <thread>;
+
+import symseek;
+
+using namespace SymSeek;
+
+namespace
+{
+    // Everything the workers share while processing one image
+    struct ImageJob
+    {
+        size_t sequence{};
+        String imagePath;
+        ISymbolReader::UPtr reader;
+        std::vector<std::vector<Symbol>> chunks;
+        // Filled instead of the chunks when the members of an archive are parsed, see membersTasks
+        std::vector<std::vector<Symbol>> members;
+        std::atomic<size_t> chunksRemaining{};
+        std::atomic<bool> stopped{};
+    };
+
+    struct Task
+    {
+        static constexpr size_t OpenImage = size_t(-1);
+
+        std::shared_ptr<ImageJob> job;
+        size_t chunk = OpenImage;
+    };
+
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    enum class Outcome: uint8_t
+    {
+        Finished,
+        Rejected,
+        Abandoned
+    };
+
+    struct Completion
+    {
+        Outcome outcome{};
+        String imagePath;
+        std::vector<Symbol> symbols;
+        // The archive members with any symbols, delivered as images of their own
+        std::vector<std::pair<String, std::vector<Symbol>>> members;
+    };
+
+    // The cancellation is checked once per this number of symbols
+    constexpr size_t cancellationCheckMask = 0x3FF;
+
+    // The symbols are demangled by blocks of this many
+    constexpr size_t demangleBatchSize = 256;
+
+    // The members are small, a task takes a range of them so the queues aren't flooded
+    constexpr size_t tasksPerWorker = 4;
+
+    // The raw names of a block copied aside, as a reference is only valid until the next symbol is read
+    struct NameBatch
+    {
+        struct Entry
+        {
+            size_t offset;
+            size_t length;
+            bool implements;
+        };
+
+        void add(RawSymbolRef const & symbolRef)
+        {
+            entries.push_back(Entry{ .offset = bytes.size(), .length = symbolRef.name.size(),
+                .implements = symbolRef.implements });
+            bytes.append(symbolRef.name);
+        }
+
+        size_t size() const noexcept
+        {
+            return entries.size();
+        }
+
+        // Valid until the next add()
+        std::span<std::string_view const> prepare()
+        {
+            names.clear();
+            for (Entry const & entry: entries)
+            {
+                names.emplace_back(bytes.data() + entry.offset, entry.length);
+            }
+            if (outputs.size() < entries.size())
+            {
+                outputs.resize(entries.size());
+            }
+            return names;
+        }
+
+        void clear()
+        {
+            bytes.clear();
+            entries.clear();
+        }
+
+        std::string bytes;
+        std::vector<Entry> entries;
+        std::vector<std::string_view> names;
+        // Keep their capacity from one block to another
+        std::vector<std::string> outputs;
+
+        // The names missed by the demangle cache, and their outputs lent by the ones above
+        std::vector<std::string_view> pendingNames;
+        std::vector<std::string> pendingOutputs;
+        std::vector<uint32_t> pendingIndices;
+    };
+}
+
+struct Scanner::Impl
+{
+    Impl(ScanOptions scanOptions, SymbolHandler symbolHandler, ResultHandler resultHandler,
+        StatusHandler statusHandler)
+    : options      { scanOptions              }
+    , symbolHandler{ std::move(symbolHandler) }
+    , resultHandler{ std::move(resultHandler) }
+    , statusHandler{ std::move(statusHandler) }
+    {
+        if (!options.workersCount)
+        {
+            options.workersCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        queues.reserve(options.workersCount);
+        for (size_t i = 0; i < options.workersCount; ++i)
+        {
+            queues.push_back(std::make_unique<WorkerQueue>());
+        }
+        workers.reserve(options.workersCount);
+        for (size_t i = 0; i < options.workersCount; ++i)
+        {
+            workers.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ~Impl()
+    {
+        {
+            std::lock_guard lock{ idleMutex };
+            shutdown = true;
+        }
+        idleCondition.notify_all();
+        workers.clear();  // joins
+    }
+
+    void push(size_t queueIndex, Task task, bool urgent)
+    {
+        // Counted before it's published, otherwise a thief could pop the task and wrap the counter first.
+        // The idle workers check it under idleMutex, so none of them misses the wake up.
+        {
+            std::lock_guard lock{ idleMutex };
+            ++queuedTasks;
+        }
+        {
+            WorkerQueue & queue = *queues[queueIndex];
+            std::lock_guard lock{ queue.mutex };
+            if (urgent)
+            {
+                queue.tasks.push_front(std::move(task));
+            }
+            else
+            {
+                queue.tasks.push_back(std::move(task));
+            }
+        }
+        idleCondition.notify_one();
+    }
+
+    // Own queue first, then stealing from the others
+    std::optional<Task> pop(size_t queueIndex)
+    {
+        for (size_t i = 0; i < queues.size(); ++i)
+        {
+            WorkerQueue & queue = *queues[(queueIndex + i) % queues.size()];
+            std::lock_guard lock{ queue.mutex };
+            if (!queue.tasks.empty())
+            {
+                Task task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                --queuedTasks;
+                return task;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void workerLoop(size_t queueIndex)
+    {
+        while (true)
+        {
+            if (std::optional<Task> task = pop(queueIndex))
+            {
+                run(queueIndex, std::move(*task));
+                continue;
+            }
+
+            std::unique_lock lock{ idleMutex };
+            idleCondition.wait(lock, [this] { return shutdown || queuedTasks > 0; });
+            if (shutdown && !queuedTasks)
+            {
+                return;
+            }
+        }
+    }
+
+    void run(size_t queueIndex, Task task)
+    {
+        std::shared_ptr<ImageJob> const & job = task.job;
+
+        if (task.chunk == Task::OpenImage)
+        {
+            if (stopSource.stop_requested())
+            {
+                complete(*job, Outcome::Abandoned);
+                return;
+            }
+
+            notify(job->imagePath, ScanStatus::Start);
+
+            job->reader = createReader(job->imagePath);
+            if (!job->reader)
+            {
+                complete(*job, Outcome::Rejected);
+                return;
+            }
+
+            size_t chunksCount = options.splitImages ? std::max<size_t>(1, job->reader->chunksCount()) : 1;
+            if (size_t const membersCount = options.archiveMembers ? job->reader->membersCount() : 0)
+            {
+                job->members.resize(membersCount);
+                chunksCount = membersTasks(membersCount);
+            }
+            else
+            {
+                job->chunks.resize(chunksCount);
+            }
+            job->chunksRemaining = chunksCount;
+
+            // Other chunks go first in the queue, so the idle workers steal them
+            for (size_t chunk = chunksCount - 1; chunk > 0; --chunk)
+            {
+                push(queueIndex, Task{ .job = job, .chunk = chunk }, /*urgent=*/true);
+            }
+            task.chunk = 0;
+        }
+
+        if (job->members.empty())
+        {
+            readChunk(*job, task.chunk);
+        }
+        else
+        {
+            readMembers(*job, task.chunk);
+        }
+
+        if (--job->chunksRemaining == 0)
+        {
+            complete(*job, stopSource.stop_requested() ? Outcome::Abandoned : Outcome::Finished);
+        }
+    }
+
+    size_t membersTasks(size_t membersCount) const
+    {
+        return options.splitImages ? std::min(membersCount, options.workersCount * tasksPerWorker) : 1;
+    }
+
+    void readChunk(ImageJob & job, size_t chunk)
+    {
+        std::vector<Symbol> & symbols = job.chunks[chunk];
+        bool const wholeImage = job.chunks.size() == 1;
+        if (wholeImage)
+        {
+            symbols.reserve(job.reader->symbolsCount());
+        }
+
+        readRefs(job, wholeImage ? job.reader->readSymbolRefs() : job.reader->readChunkRefs(chunk), symbols);
+    }
+
+    // The task takes an even share of the members
+    void readMembers(ImageJob & job, size_t task)
+    {
+        size_t const tasksCount = membersTasks(job.members.size());
+        size_t const begin = job.members.size() * task / tasksCount;
+        size_t const end = job.members.size() * (task + 1) / tasksCount;
+
+        for (size_t member = begin; member < end; ++member)
+        {
+            if (job.stopped || stopSource.stop_requested())
+            {
+                return;
+            }
+
+            // The members which aren't object files are just skipped
+            if (ISymbolReader::UPtr const reader = job.reader->memberReader(member))
+            {
+                job.members[member].reserve(reader->symbolsCount());
+                readRefs(job, reader->readSymbolRefs(), job.members[member]);
+            }
+        }
+    }
+
+    void readRefs(ImageJob & job, ISymbolReader::SymbolRefsGen symbolRefs, std::vector<Symbol> & symbols)
+    {
+        // Filled in place for every symbol, only the kept ones are copied into the result
+        Symbol symbol;
+        NameBatch batch;
+        size_t processed{};
+        for (RawSymbolRef const & symbolRef: symbolRefs)
+        {
+            if (!(++processed & cancellationCheckMask) && (job.stopped || stopSource.stop_requested()))
+            {
+                return;
+            }
+
+            if (options.rawNameFilter && !options.rawNameFilter(symbolRef.name))
+            {
+                continue;
+            }
+
+            batch.add(symbolRef);
+            if (batch.size() == demangleBatchSize && !handleBatch(job, symbols, symbol, batch))
+            {
+                return;
+            }
+        }
+        handleBatch(job, symbols, symbol, batch);
+    }
+
+    // False once the symbol handler stops the image
+    bool handleBatch(ImageJob & job, std::vector<Symbol> & symbols, Symbol & symbol, NameBatch & batch)
+    {
+        std::span<std::string_view const> const names = batch.prepare();
+        demangle(batch);
+
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            symbol.raw.name.assign(names[i]);
+            symbol.raw.implements = batch.entries[i].implements;
+            Mangler const mangler = detectMangler(names[i]);
+
+            if (std::string & demangledName = batch.outputs[i]; !demangledName.empty())
+            {
+                // The buffer of the previous symbol goes back to the batch for the next block
+                std::string buffer = symbol.demangledName ? std::move(*symbol.demangledName) : std::string{};
+                symbol = createSymbol(std::move(symbol.raw), std::move(demangledName));
+                demangledName = std::move(buffer);
+            }
+            else
+            {
+                symbol.type = NameType::Function;
+                symbol.access = Access::Public;
+                symbol.modifiers = Symbol::None;
+                symbol.demangledName.reset();
+            }
+            symbol.mangler = mangler;
+
+            SymbolHandlerAction const action = symbolHandler ? symbolHandler(symbol) : SymbolHandlerAction::Add;
+            if (action == SymbolHandlerAction::Skip)
+            {
+                continue;
+            }
+            else if (action == SymbolHandlerAction::Stop)
+            {
+                job.stopped = true;
+                return false;
+            }
+            GUARD(action == SymbolHandlerAction::Add);
+            symbols.push_back(symbol);
+        }
+        batch.clear();
+        return true;
+    }
+
+    // Leaves the outputs of the names which aren't demangled empty
+    void demangle(NameBatch & batch)
+    {
+        std::span<std::string> const outputs{ batch.outputs.data(), batch.names.size() };
+        if (options.deferDemangling)
+        {
+            for (std::string & output: outputs)
+            {
+                output.clear();
+            }
+            return;
+        }
+
+        DemangleCache * cache = options.demangleCache.get();
+        if (!cache)
+        {
+            dispatcher.demangleBatch(batch.names, outputs);
+            return;
+        }
+
+        // The plain names aren't worth a cache entry, neither are the ones of the schemes with no engine
+        batch.pendingNames.clear();
+        batch.pendingIndices.clear();
+        for (size_t i = 0; i < batch.names.size(); ++i)
+        {
+            std::string_view const name = batch.names[i];
+            if (!dispatcher.accepts(name))
+            {
+                outputs[i].clear();
+                continue;
+            }
+            if (cache->find(name, outputs[i]))
+            {
+                continue;
+            }
+
+            size_t const slot = batch.pendingNames.size();
+            if (slot == batch.pendingOutputs.size())
+            {
+                batch.pendingOutputs.emplace_back();
+            }
+            batch.pendingNames.push_back(name);
+            batch.pendingIndices.push_back(static_cast<uint32_t>(i));
+            std::swap(batch.pendingOutputs[slot], outputs[i]);
+        }
+        if (batch.pendingNames.empty())
+        {
+            return;
+        }
+
+        dispatcher.demangleBatch(batch.pendingNames, { batch.pendingOutputs.data(), batch.pendingNames.size() });
+        for (size_t slot = 0; slot < batch.pendingIndices.size(); ++slot)
+        {
+            cache->insert(batch.pendingNames[slot], batch.pendingOutputs[slot]);
+            std::swap(batch.pendingOutputs[slot], outputs[batch.pendingIndices[slot]]);
+        }
+    }
+
+    void complete(ImageJob & job, Outcome outcome)
+    {
+        Completion completion{ .outcome = outcome, .imagePath = std::move(job.imagePath) };
+        if (outcome == Outcome::Finished && !job.members.empty())
+        {
+            collectMembers(job, completion);
+        }
+        else if (outcome == Outcome::Finished)
+        {
+            if (job.chunks.size() == 1)
+            {
+                completion.symbols = std::move(job.chunks.front());
+            }
+            else
+            {
+                size_t total{};
+                for (auto const & chunk: job.chunks)
+                {
+                    total += chunk.size();
+                }
+                completion.symbols.reserve(total);
+                for (auto & chunk: job.chunks)
+                {
+                    std::move(chunk.begin(), chunk.end(), std::back_inserter(completion.symbols));
+                }
+            }
+        }
+        job.chunks.clear();
+        job.members.clear();
+        job.reader.reset();  // Unmaps the image as early as possible
+
+        std::lock_guard lock{ deliveryMutex };
+        if (options.ordered)
+        {
+            reorderBuffer.emplace(job.sequence, std::move(completion));
+            for (auto it = reorderBuffer.begin();
+                it != reorderBuffer.end() && it->first == nextSequence;
+                it = reorderBuffer.erase(it), ++nextSequence)
+            {
+                deliver(std::move(it->second));
+            }
+        }
+        else
+        {
+            deliver(std::move(completion));
+        }
+
+        ++completedImages;
+        completedCondition.notify_all();
+    }
+
+    // Before the reader is gone, as the names of the members belong to the archive
+    void collectMembers(ImageJob & job, Completion & completion)
+    {
+        for (size_t member = 0; member < job.members.size(); ++member)
+        {
+            std::vector<Symbol> & symbols = job.members[member];
+            if (symbols.empty())
+            {
+                continue;
+            }
+
+            // The import libraries have a member per imported name, all named after the DLL
+            std::string_view const name = job.reader->memberName(member);
+            String memberPath = completion.imagePath;
+            memberPath.push_back('(');
+            memberPath.append(name.begin(), name.end());
+            memberPath.push_back(')');
+
+            if (!completion.members.empty() && completion.members.back().first == memberPath)
+            {
+                std::vector<Symbol> & previous = completion.members.back().second;
+                std::move(symbols.begin(), symbols.end(), std::back_inserter(previous));
+                continue;
+            }
+            completion.members.emplace_back(std::move(memberPath), std::move(symbols));
+        }
+    }
+
+    // Under deliveryMutex
+    void deliver(Completion completion)
+    {
+        switch (completion.outcome)
+        {
+            case Outcome::Finished:
+                if (resultHandler && !completion.members.empty())
+                {
+                    for (auto & [memberPath, symbols]: completion.members)
+                    {
+                        resultHandler(memberPath, std::move(symbols));
+                    }
+                }
+                else if (resultHandler)
+                {
+                    resultHandler(completion.imagePath, std::move(completion.symbols));
+                }
+                if (statusHandler)
+                {
+                    statusHandler(completion.imagePath, ScanStatus::Finish);
+                }
+                break;
+            case Outcome::Rejected:
+                if (statusHandler)
+                {
+                    statusHandler(completion.imagePath, ScanStatus::Reject);
+                }
+                break;
+            case Outcome::Abandoned:
+                break;
+        }
+    }
+
+    void notify(String const & imagePath, ScanStatus status)
+    {
+        if (statusHandler)
+        {
+            std::lock_guard lock{ deliveryMutex };
+            statusHandler(imagePath, status);
+        }
+    }
+
+    ScanOptions options;
+    SymbolHandler symbolHandler;
+    ResultHandler resultHandler;
+    StatusHandler statusHandler;
+    DemangleDispatcher dispatcher;
+
+    std::stop_source stopSource;
+    std::optional<std::stop_callback<std::function<void()>>> externalStop;
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::atomic<size_t> nextQueue{};
+
+    std::mutex idleMutex;
+    std::condition_variable idleCondition;
+    std::atomic<size_t> queuedTasks{};
+    bool shutdown = false;
+
+    std::mutex deliveryMutex;
+    std::condition_variable completedCondition;
+    size_t submittedImages{};
+    size_t completedImages{};
+    size_t nextSequence{};
+    std::map<size_t, Completion> reorderBuffer;
+
+    // The last member, so the workers are joined before anything else is destroyed
+    std::vector<std::jthread> workers;
+};
+
+Scanner::Scanner(ScanOptions options, SymbolHandler symbolHandler, ResultHandler resultHandler,
+    StatusHandler statusHandler, std::stop_token stopToken)
+: m_impl{ std::make_unique<Impl>(options, std::move(symbolHandler), std::move(resultHandler),
+    std::move(statusHandler)) }
+{
+    m_impl->externalStop.emplace(std::move(stopToken), std::function<void()>{ [this] { cancel(); } });
+}
+
+Scanner::~Scanner()
+{
+    cancel();
+}
+
+void Scanner::submit(String imagePath)
+{
+    auto job = std::make_shared<ImageJob>();
+    job->imagePath = std::move(imagePath);
+    {
+        std::lock_guard lock{ m_impl->deliveryMutex };
+        job->sequence = m_impl->submittedImages++;
+    }
+
+    size_t const queueIndex = m_impl->nextQueue++ % m_impl->queues.size();
+    m_impl->push(queueIndex, Task{ .job = std::move(job) }, /*urgent=*/false);
+}
+
+void Scanner::wait()
+{
+    std::unique_lock lock{ m_impl->deliveryMutex };
+    m_impl->completedCondition.wait(lock, [this] {
+        return m_impl->completedImages == m_impl->submittedImages;
+    });
+}
+
+void Scanner::cancel()
+{
+    m_impl->stopSource.request_stop();
+}
+
+bool Scanner::isCancelled() const
+{
+    return m_impl->stopSource.stop_requested();
+}
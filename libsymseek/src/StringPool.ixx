@@ -0,0 +1,191 @@
+module;
+
+#include <symseek/Definitions.h>
+
+export module symseek.internal.stringpool;
+
+import <algorithm>;
+import <cstdint>;
+import <limits>;
+import <memory>;
+import <string>;
+import <string_view>;
+import <unordered_set>;
+import <vector>;
+
+import symseek.internal.helpers;
+
+export namespace SymSeek::detail
+{
+    // Interns strings so that equal names are stored once and every string is addressed by a pair
+    // of 32-bit numbers. The bytes live in blocks which never move, so the views handed out stay valid
+    // until the pool is cleared, while the offsets run on from one block to the next as in a single buffer.
+    class StringPool
+    {
+    public:
+        struct Ref
+        {
+            uint32_t offset{};
+            uint32_t length{};
+        };
+
+        StringPool() = default;
+
+        // The lookup functors refer to the pool itself
+        StringPool(StringPool const &) = delete;
+        StringPool & operator=(StringPool const &) = delete;
+
+        // Fails (returns false) when the pool would outgrow the 32-bit addressing
+        bool intern(std::string_view value, Ref & ref);
+
+        std::string_view view(Ref ref) const noexcept;
+
+        // The bytes of every block in order, together they are the strings addressed by the offsets
+        std::vector<std::string_view> blocks() const;
+
+        size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        void reserve(size_t bytesCount, size_t stringsCount);
+        void clear() noexcept;
+
+    private:
+        struct Hash
+        {
+            using is_transparent = void;
+
+            StringPool const * pool;
+
+            size_t operator()(std::string_view value) const noexcept
+            {
+                return static_cast<size_t>(hashBytes(value.data(), value.size()));
+            }
+            size_t operator()(Ref ref) const noexcept
+            {
+                return (*this)(pool->view(ref));
+            }
+        };
+
+        struct Equal
+        {
+            using is_transparent = void;
+
+            StringPool const * pool;
+
+            template<typename L, typename R>
+            bool operator()(L const & lhs, R const & rhs) const noexcept
+            {
+                return get(lhs) == get(rhs);
+            }
+
+        private:
+            std::string_view get(std::string_view value) const noexcept { return value; }
+            std::string_view get(Ref ref) const noexcept { return pool->view(ref); }
+        };
+
+        struct Block
+        {
+            std::unique_ptr<char[]> bytes;
+            uint32_t offset{};  // Of the first byte in the pool
+            uint32_t size{};
+            size_t capacity{};
+        };
+
+        // Only the last block is appended to, the rest of a block is left unused once a string doesn't fit
+        Block & appendBlock(size_t capacity);
+
+        std::vector<Block> m_blocks;
+        uint32_t m_size{};
+        std::unordered_set<Ref, Hash, Equal> m_refs{ /*bucket_count=*/0, Hash{ this }, Equal{ this } };
+    };
+}
+
+// Implementation
+
+using namespace SymSeek::detail;
+
+namespace
+{
+    // Large enough for the allocations to be rare, small enough not to waste much of the last one
+    constexpr size_t BlockSize = size_t(1) << 20;
+}
+
+std::string_view StringPool::view(Ref ref) const noexcept
+{
+    if (!ref.length)
+    {
+        return {};
+    }
+
+    // The last block which starts at the offset or before it, the empty blocks are passed over
+    auto const block = std::upper_bound(m_blocks.begin(), m_blocks.end(), ref.offset,
+        [](uint32_t offset, Block const & block) { return offset < block.offset; }) - 1;
+    return { block->bytes.get() + (ref.offset - block->offset), ref.length };
+}
+
+std::vector<std::string_view> StringPool::blocks() const
+{
+    std::vector<std::string_view> result;
+    result.reserve(m_blocks.size());
+    for (Block const & block: m_blocks)
+    {
+        result.emplace_back(block.bytes.get(), block.size);
+    }
+    return result;
+}
+
+StringPool::Block & StringPool::appendBlock(size_t capacity)
+{
+    return m_blocks.emplace_back(Block{ .bytes = std::make_unique_for_overwrite<char[]>(capacity), .offset = m_size,
+        .capacity = capacity });
+}
+
+bool StringPool::intern(std::string_view value, Ref & ref)
+{
+    if (auto found = m_refs.find(value); found != m_refs.end())
+    {
+        ref = *found;
+        return true;
+    }
+
+    if (size_t{ m_size } + value.size() > std::numeric_limits<uint32_t>::max())
+    {
+        return false;
+    }
+
+    ref = Ref{ .offset = m_size, .length = static_cast<uint32_t>(value.size()) };
+    if (value.empty())
+    {
+        return true;
+    }
+
+    Block * block = m_blocks.empty() ? nullptr : &m_blocks.back();
+    if (!block || block->capacity - block->size < value.size())
+    {
+        block = &appendBlock(std::max(BlockSize, value.size()));
+    }
+    std::copy(value.begin(), value.end(), block->bytes.get() + block->size);
+    block->size += static_cast<uint32_t>(value.size());
+    m_size += static_cast<uint32_t>(value.size());
+    m_refs.insert(ref);
+    return true;
+}
+
+void StringPool::reserve(size_t bytesCount, size_t stringsCount)
+{
+    size_t const spare = m_blocks.empty() ? 0 : m_blocks.back().capacity - m_blocks.back().size;
+    if (bytesCount > m_size + spare)
+    {
+        appendBlock(bytesCount - m_size);
+    }
+    m_refs.reserve(stringsCount);
+}
+
+void StringPool::clear() noexcept
+{
+    m_blocks.clear();
+    m_size = 0;
+    m_refs.clear();
+}
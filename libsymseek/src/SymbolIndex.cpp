@@ -0,0 +1,599 @@
+module;
+
+#include <symseek/Definitions.h>
+
+#include <Debug.h>
+
+module symseek.index;
+
+import <algorithm>;
+import <cstring>;
+import <filesystem>;
+import <iterator>;
+import <optional>;
+import <string_view>;
+import <unordered_map>;
+import <utility>;
+
+import symseek;
+import symseek.internal.helpers;
+import symseek.internal.interfaces.mappedfile;
+import symseek.internal.stringpool;
+
+using namespace SymSeek;
+using SymSeek::detail::StringPool;
+
+namespace
+{
+    // On-disk layout: header, file records sorted by path then member, symbol records, string pool.
+    // Everything is in the native byte order, the index is a local cache after all.
+    constexpr char indexMagic[8] = { 'S', 'Y', 'M', 'S', 'I', 'D', 'X', '\0' };
+    // 2: the symbol records carry the mangling scheme
+    // 3: the members of the archives have records of their own
+    constexpr uint32_t indexVersion = 3;
+
+    enum IndexFlags: uint16_t
+    {
+        HashedContents = 0b0001,
+        ArchiveMembers = 0b0010
+    };
+
+    struct IndexHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint16_t charSize;  // Paths are stored as String bytes
+        uint16_t flags;
+        uint64_t filesCount;
+        uint64_t symbolsCount;
+        uint64_t stringsSize;
+        uint64_t filesOffset;
+        uint64_t symbolsOffset;
+        uint64_t stringsOffset;
+    };
+    static_assert(sizeof(IndexHeader) == 64);
+
+    enum class FileStatus: uint32_t
+    {
+        Parsed,
+        Rejected,
+        // Holds no symbols, its members follow it with the same path and key
+        Archive
+    };
+
+    struct FileKey
+    {
+        uint64_t size{};
+        int64_t modificationTime{};
+        uint64_t contentHash{};
+    };
+
+    struct FileRecord
+    {
+        StringPool::Ref path;
+        StringPool::Ref member;  // Empty but for the members of the archives, reported as "path(member)"
+        FileKey key;
+        uint32_t firstSymbol;
+        uint32_t symbolsCount;
+        FileStatus status;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(FileRecord) == 56);
+
+    // Same flags as PackedSymbol
+    struct SymbolRecord
+    {
+        StringPool::Ref raw;
+        StringPool::Ref demangled;
+        uint32_t flags;
+    };
+    static_assert(sizeof(SymbolRecord) == 20);
+
+    std::string_view pathBytes(String const & path)
+    {
+        return { reinterpret_cast<char const *>(path.data()), path.size() * sizeof(String::value_type) };
+    }
+
+    String pathFromBytes(std::string_view bytes)
+    {
+        String result(bytes.size() / sizeof(String::value_type), 0);
+        std::memcpy(result.data(), bytes.data(), result.size() * sizeof(String::value_type));
+        return result;
+    }
+
+    std::optional<FileKey> statFile(String const & path)
+    {
+        std::error_code error;
+        std::filesystem::path const fsPath{ path };
+        auto const size = std::filesystem::file_size(fsPath, error);
+        if (error)
+        {
+            return std::nullopt;
+        }
+        auto const modificationTime = std::filesystem::last_write_time(fsPath, error);
+        if (error)
+        {
+            return std::nullopt;
+        }
+        return FileKey{
+            .size = static_cast<uint64_t>(size),
+            .modificationTime = static_cast<int64_t>(modificationTime.time_since_epoch().count())
+        };
+    }
+
+    uint64_t hashContents(String const & path)
+    {
+        auto file = detail::createMappedFile(path);
+        if (!file || !file->size())
+        {
+            return 0;
+        }
+        uint8_t const * bytes = file->map(/*offset=*/0, /*length=*/0, detail::MapMode::Lazy);
+        if (!bytes)
+        {
+            return 0;
+        }
+        file->advise(bytes, file->size(), detail::AccessHint::Sequential);
+        return detail::hashBytes(bytes, file->size());
+    }
+
+    // Accumulates the records of the index being written
+    struct IndexBuilder
+    {
+        bool addFile(String const & path, FileKey key, FileStatus status, String const & member = {})
+        {
+            FileRecord record{ .key = key, .firstSymbol = static_cast<uint32_t>(symbols.size()), .status = status };
+            if (!strings.intern(pathBytes(path), record.path) ||
+                (!member.empty() && !strings.intern(pathBytes(member), record.member)))
+            {
+                return false;
+            }
+            files.push_back(record);
+            return true;
+        }
+
+        bool addSymbol(std::string_view raw, std::optional<std::string_view> demangled, uint32_t flags)
+        {
+            SymbolRecord record{ .flags = flags };
+            if (!strings.intern(raw, record.raw) ||
+                (demangled && !strings.intern(*demangled, record.demangled)))
+            {
+                return false;
+            }
+            symbols.push_back(record);
+            ++files.back().symbolsCount;
+            return true;
+        }
+
+        bool write(String const & indexPath, uint16_t flags)
+        {
+            // The members right after their archive
+            std::sort(files.begin(), files.end(), [this](FileRecord const & lhs, FileRecord const & rhs) {
+                return std::pair{ strings.view(lhs.path), strings.view(lhs.member) } <
+                    std::pair{ strings.view(rhs.path), strings.view(rhs.member) };
+            });
+
+            IndexHeader header{};
+            std::memcpy(header.magic, indexMagic, sizeof(indexMagic));
+            header.version = indexVersion;
+            header.charSize = sizeof(String::value_type);
+            header.flags = flags;
+            header.filesCount = files.size();
+            header.symbolsCount = symbols.size();
+            header.stringsSize = strings.size();
+            header.filesOffset = sizeof(IndexHeader);
+            header.symbolsOffset = header.filesOffset + files.size() * sizeof(FileRecord);
+            header.stringsOffset = header.symbolsOffset + symbols.size() * sizeof(SymbolRecord);
+
+            auto bytesOf = [](auto const & records) {
+                return std::string_view{ reinterpret_cast<char const *>(records.data()),
+                    records.size() * sizeof(records.front()) };
+            };
+            std::vector<std::string_view> parts{
+                { reinterpret_cast<char const *>(&header), sizeof(header) },
+                bytesOf(files),
+                bytesOf(symbols)
+            };
+            std::ranges::copy(strings.blocks(), std::back_inserter(parts));
+            return detail::replaceFile(indexPath, parts);
+        }
+
+        StringPool strings;
+        std::vector<FileRecord> files;
+        std::vector<SymbolRecord> symbols;
+    };
+}
+
+struct SymbolIndex::Impl
+{
+    bool map(String const & path)
+    {
+        file = detail::createMappedFile(path);
+        if (!file || file->size() < sizeof(IndexHeader))
+        {
+            return false;
+        }
+
+        size_t const fileSize = file->size();
+        bytes = file->map(/*offset=*/0, /*length=*/0, detail::MapMode::Populate);
+        if (!bytes)
+        {
+            return false;
+        }
+
+        std::memcpy(&header, bytes, sizeof(header));
+        if (std::memcmp(header.magic, indexMagic, sizeof(indexMagic)) ||
+            header.version != indexVersion || header.charSize != sizeof(String::value_type))
+        {
+            return false;
+        }
+
+        auto fits = [fileSize](uint64_t offset, uint64_t count, uint64_t size) {
+            return offset <= fileSize && count <= (fileSize - offset) / size;
+        };
+        if (!fits(header.filesOffset, header.filesCount, sizeof(FileRecord)) ||
+            !fits(header.symbolsOffset, header.symbolsCount, sizeof(SymbolRecord)) ||
+            !fits(header.stringsOffset, header.stringsSize, 1) ||
+            header.filesOffset % alignof(FileRecord) || header.symbolsOffset % alignof(SymbolRecord))
+        {
+            return false;
+        }
+
+        files = reinterpret_cast<FileRecord const *>(bytes + header.filesOffset);
+        symbols = reinterpret_cast<SymbolRecord const *>(bytes + header.symbolsOffset);
+        strings = reinterpret_cast<char const *>(bytes + header.stringsOffset);
+
+        // A damaged cache must never crash the search, so every reference is checked once here
+        auto validRef = [this](StringPool::Ref ref) {
+            return ref.offset <= header.stringsSize && ref.length <= header.stringsSize - ref.offset;
+        };
+        for (uint64_t i = 0; i < header.filesCount; ++i)
+        {
+            FileRecord const & record = files[i];
+            if (!validRef(record.path) || !validRef(record.member) || record.firstSymbol > header.symbolsCount ||
+                record.symbolsCount > header.symbolsCount - record.firstSymbol)
+            {
+                return false;
+            }
+            imagesCount += record.member.length == 0;
+        }
+        for (uint64_t i = 0; i < header.symbolsCount; ++i)
+        {
+            if (!validRef(symbols[i].raw) || !validRef(symbols[i].demangled))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void reset()
+    {
+        file.reset();
+        bytes = nullptr;
+        header = {};
+        imagesCount = 0;
+        files = nullptr;
+        symbols = nullptr;
+        strings = nullptr;
+    }
+
+    std::string_view view(StringPool::Ref ref) const
+    {
+        return { strings + ref.offset, ref.length };
+    }
+
+    // The record of the image itself, the members of an archive are the next ones
+    FileRecord const * find(String const & path) const
+    {
+        std::string_view const key = pathBytes(path);
+        FileRecord const * end = files + header.filesCount;
+        FileRecord const * found = std::lower_bound(files, end, key,
+            [this](FileRecord const & record, std::string_view value) {
+                return view(record.path) < value;
+            });
+        return found != end && view(found->path) == key && !found->member.length ? found : nullptr;
+    }
+
+    // Past the members of the archive, the record itself for the other images
+    FileRecord const * membersEnd(FileRecord const * record) const
+    {
+        FileRecord const * end = files + header.filesCount;
+        FileRecord const * next = record + 1;
+        while (record->status == FileStatus::Archive && next != end && view(next->path) == view(record->path))
+        {
+            ++next;
+        }
+        return next;
+    }
+
+    std::unique_ptr<detail::IMappedFile> file;
+    uint8_t const * bytes{};
+    IndexHeader header{};
+    size_t imagesCount{};  // The records of the archive members aside
+    FileRecord const * files{};
+    SymbolRecord const * symbols{};
+    char const * strings{};
+    String path;
+};
+
+SymbolIndex::SymbolIndex()
+: m_impl{ std::make_unique<Impl>() }
+{
+}
+
+SymbolIndex::~SymbolIndex() = default;
+
+bool SymbolIndex::open(String const & indexPath)
+{
+    m_impl->reset();
+    m_impl->path = indexPath;
+    if (!m_impl->map(indexPath))
+    {
+        m_impl->reset();
+        return false;
+    }
+    return true;
+}
+
+bool SymbolIndex::isOpen() const
+{
+    return m_impl->files != nullptr;
+}
+
+void SymbolIndex::close()
+{
+    m_impl->reset();
+}
+
+size_t SymbolIndex::imagesCount() const
+{
+    return m_impl->imagesCount;
+}
+
+size_t SymbolIndex::symbolsCount() const
+{
+    return static_cast<size_t>(m_impl->header.symbolsCount);
+}
+
+bool SymbolIndex::isFresh(std::vector<String> const & imagePaths, IndexOptions const & options) const
+{
+    bool const archiveMembers = m_impl->header.flags & ArchiveMembers;
+    if (!isOpen() || imagePaths.size() != m_impl->imagesCount || archiveMembers != options.scan.archiveMembers)
+    {
+        return false;
+    }
+
+    for (String const & imagePath: imagePaths)
+    {
+        FileRecord const * record = m_impl->find(imagePath);
+        std::optional<FileKey> const key = statFile(imagePath);
+        if (record && !key && record->status == FileStatus::Rejected)
+        {
+            // Couldn't be read the last time either, see refresh()
+            continue;
+        }
+        if (!record || !key ||
+            record->key.size != key->size || record->key.modificationTime != key->modificationTime)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SymbolIndex::refresh(std::vector<String> const & imagePaths, IndexOptions const & options,
+    Scanner::StatusHandler statusHandler, std::stop_token stopToken)
+{
+    IndexBuilder builder;
+    builder.files.reserve(imagePaths.size());
+    builder.symbols.reserve(static_cast<size_t>(m_impl->header.symbolsCount));
+    builder.strings.reserve(static_cast<size_t>(m_impl->header.stringsSize),
+        static_cast<size_t>(m_impl->header.symbolsCount));
+
+    bool const hashed = options.hashContents && (m_impl->header.flags & HashedContents);
+    // The archives read the other way are parsed again
+    bool const reusable = isOpen() && bool(m_impl->header.flags & ArchiveMembers) == options.scan.archiveMembers;
+    bool succeeded = true;
+
+    // Unchanged images are carried over, the rest is scheduled for parsing
+    std::unordered_map<String, FileKey> changed;
+    for (String const & imagePath: imagePaths)
+    {
+        std::optional<FileKey> key = statFile(imagePath);
+        if (!key)
+        {
+            // Rejected with an empty key, so the records still match the paths and the index stays fresh
+            succeeded = succeeded && builder.addFile(imagePath, FileKey{}, FileStatus::Rejected);
+            continue;
+        }
+
+        FileRecord const * record = reusable ? m_impl->find(imagePath) : nullptr;
+        bool unchanged = record && record->key.size == key->size &&
+            record->key.modificationTime == key->modificationTime;
+        if (options.hashContents)
+        {
+            key->contentHash = unchanged && hashed ? record->key.contentHash : hashContents(imagePath);
+            unchanged = unchanged || (hashed && record && record->key.size == key->size &&
+                record->key.contentHash == key->contentHash);
+        }
+
+        if (!unchanged)
+        {
+            changed.emplace(imagePath, *key);
+            continue;
+        }
+
+        for (FileRecord const * end = m_impl->membersEnd(record); record != end && succeeded; ++record)
+        {
+            succeeded = builder.addFile(imagePath, *key, record->status, pathFromBytes(m_impl->view(record->member)));
+            for (uint32_t i = 0; i < record->symbolsCount && succeeded; ++i)
+            {
+                SymbolRecord const & symbol = m_impl->symbols[record->firstSymbol + i];
+                std::optional<std::string_view> demangled;
+                if (symbol.flags & PackedSymbol::HasDemangled)
+                {
+                    demangled = m_impl->view(symbol.demangled);
+                }
+                succeeded = builder.addSymbol(m_impl->view(symbol.raw), demangled, symbol.flags);
+            }
+        }
+    }
+
+    if (!changed.empty() && succeeded)
+    {
+        // The results of an image come before its Finish status, the members of the archives as "path(member)"
+        std::vector<std::pair<String, std::vector<Symbol>>> results;
+        auto addSymbols = [&](std::vector<Symbol> const & symbols)
+        {
+            for (auto const & symbol: symbols)
+            {
+                if (!succeeded)
+                {
+                    break;
+                }
+                std::optional<std::string_view> demangled;
+                if (symbol.demangledName)
+                {
+                    demangled = *symbol.demangledName;
+                }
+                succeeded = builder.addSymbol(symbol.raw.name, demangled, PackedSymbol::packFlags(symbol));
+            }
+        };
+
+        // Everything is stored, the filtering is up to the queries
+        Scanner scanner{
+            options.scan,
+            /*symbolHandler=*/{},
+            [&](String const & imagePath, std::vector<Symbol> symbols)
+            {
+                results.emplace_back(imagePath, std::move(symbols));
+            },
+            [&](String const & imagePath, ScanStatus status)
+            {
+                FileKey const & key = changed[imagePath];
+                if (status == ScanStatus::Reject)
+                {
+                    // Remembered too, so that non-binaries are not opened again next time
+                    succeeded = succeeded && builder.addFile(imagePath, key, FileStatus::Rejected);
+                }
+                else if (status == ScanStatus::Finish && results.size() == 1 && results.front().first == imagePath)
+                {
+                    succeeded = succeeded && builder.addFile(imagePath, key, FileStatus::Parsed);
+                    addSymbols(results.front().second);
+                }
+                else if (status == ScanStatus::Finish)
+                {
+                    succeeded = succeeded && builder.addFile(imagePath, key, FileStatus::Archive);
+                    for (auto const & [memberPath, symbols]: results)
+                    {
+                        String const member = memberPath.substr(imagePath.size() + 1,
+                            memberPath.size() - imagePath.size() - 2);
+                        succeeded = succeeded && builder.addFile(imagePath, key, FileStatus::Parsed, member);
+                        addSymbols(symbols);
+                    }
+                }
+                if (status != ScanStatus::Start)
+                {
+                    results.clear();
+                }
+                if (statusHandler)
+                {
+                    statusHandler(imagePath, status);
+                }
+            },
+            std::move(stopToken)
+        };
+
+        for (auto const & [imagePath, key]: changed)
+        {
+            scanner.submit(imagePath);
+        }
+        scanner.wait();
+
+        if (scanner.isCancelled())
+        {
+            return false;
+        }
+    }
+
+    if (!succeeded)
+    {
+        return false;
+    }
+
+    // The old mapping must go away before the file is replaced (Windows wouldn't allow otherwise)
+    String const indexPath = m_impl->path;
+    m_impl->reset();
+    uint16_t const flags = (options.hashContents ? HashedContents : 0) |
+        (options.scan.archiveMembers ? ArchiveMembers : 0);
+    if (!builder.write(indexPath, flags))
+    {
+        return false;
+    }
+    return open(indexPath);
+}
+
+void SymbolIndex::query(SymbolHandler const & symbolHandler, Scanner::ResultHandler const & resultHandler,
+    std::stop_token stopToken) const
+{
+    if (!isOpen())
+    {
+        return;
+    }
+
+    // Reused for every record, so the names don't allocate unless the symbol is kept
+    Symbol symbol;
+    for (uint64_t i = 0; i < m_impl->header.filesCount && !stopToken.stop_requested(); ++i)
+    {
+        FileRecord const & record = m_impl->files[i];
+        if (record.status != FileStatus::Parsed)
+        {
+            continue;
+        }
+
+        std::vector<Symbol> symbols;
+        for (uint32_t s = 0; s < record.symbolsCount; ++s)
+        {
+            SymbolRecord const & symbolRecord = m_impl->symbols[record.firstSymbol + s];
+            symbol.raw.name.assign(m_impl->view(symbolRecord.raw));
+            if (symbolRecord.flags & PackedSymbol::HasDemangled)
+            {
+                if (!symbol.demangledName)
+                {
+                    symbol.demangledName.emplace();
+                }
+                symbol.demangledName->assign(m_impl->view(symbolRecord.demangled));
+            }
+            else
+            {
+                symbol.demangledName.reset();
+            }
+            PackedSymbol::unpackFlags(symbolRecord.flags, symbol);
+
+            SymbolHandlerAction const action = symbolHandler ? symbolHandler(symbol) : SymbolHandlerAction::Add;
+            if (action == SymbolHandlerAction::Skip)
+            {
+                continue;
+            }
+            else if (action == SymbolHandlerAction::Stop)
+            {
+                break;
+            }
+            GUARD(action == SymbolHandlerAction::Add);
+            symbols.push_back(symbol);
+        }
+
+        if (resultHandler)
+        {
+            String imagePath = pathFromBytes(m_impl->view(record.path));
+            if (record.member.length)
+            {
+                imagePath.push_back('(');
+                imagePath += pathFromBytes(m_impl->view(record.member));
+                imagePath.push_back(')');
+            }
+            resultHandler(imagePath, std::move(symbols));
+        }
+    }
+}
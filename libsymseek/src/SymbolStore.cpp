@@ -0,0 +1,140 @@
+module;
+
+#include <symseek/Definitions.h>
+
+#include <Debug.h>
+
+module symseek.store;
+
+using namespace SymSeek;
+using SymSeek::detail::StringPool;
+
+uint32_t PackedSymbol::packFlags(Symbol const & symbol) noexcept
+{
+    uint32_t flags{};
+    if (symbol.raw.implements)
+    {
+        flags |= Implements;
+    }
+    if (symbol.demangledName)
+    {
+        flags |= HasDemangled;
+    }
+    else if (symbol.mangler != Mangler::None)
+    {
+        flags |= Deferred;
+    }
+    flags |= static_cast<uint32_t>(symbol.type) << TypeShift;
+    flags |= static_cast<uint32_t>(symbol.access) << AccessShift;
+    flags |= static_cast<uint32_t>(symbol.modifiers) << ModifiersShift;
+    flags |= static_cast<uint32_t>(symbol.mangler) << ManglerShift;
+    return flags;
+}
+
+void PackedSymbol::unpackFlags(uint32_t flags, Symbol & symbol) noexcept
+{
+    symbol.raw.implements = flags & Implements;
+    symbol.type = static_cast<NameType>((flags >> TypeShift) & TwoBitsMask);
+    symbol.access = static_cast<Access>((flags >> AccessShift) & TwoBitsMask);
+    symbol.modifiers = static_cast<uint8_t>((flags >> ModifiersShift) & FourBitsMask);
+    symbol.mangler = static_cast<Mangler>((flags >> ManglerShift) & ThreeBitsMask);
+}
+
+void SymbolStore::addImage(String imagePath)
+{
+    m_images.push_back(std::move(imagePath));
+}
+
+bool SymbolStore::add(Symbol const & symbol)
+{
+    return add(symbol.raw.name, symbol.raw.implements,
+        symbol.demangledName ? std::optional<std::string_view>{ *symbol.demangledName } : std::nullopt,
+        PackedSymbol::packFlags(symbol));
+}
+
+bool SymbolStore::add(std::string_view rawName, bool implements, std::optional<std::string_view> demangledName,
+    uint32_t flags)
+{
+    GUARD(!m_images.empty());
+
+    StringPool::Ref raw;
+    StringPool::Ref demangled;
+    if (!m_strings.intern(rawName, raw) || (demangledName && !m_strings.intern(*demangledName, demangled)))
+    {
+        return false;
+    }
+
+    flags &= ~uint32_t(PackedSymbol::Implements | PackedSymbol::HasDemangled);
+    if (implements)
+    {
+        flags |= PackedSymbol::Implements;
+    }
+    if (demangledName)
+    {
+        flags |= PackedSymbol::HasDemangled;
+    }
+
+    m_symbols.push_back(PackedSymbol{
+        .rawOffset       = raw.offset,
+        .rawLength       = raw.length,
+        .demangledOffset = demangled.offset,
+        .demangledLength = demangled.length,
+        .image           = static_cast<uint32_t>(m_images.size() - 1),
+        .flags           = flags
+    });
+    return true;
+}
+
+bool SymbolStore::resolve(size_t index, Symbol const & symbol)
+{
+    PackedSymbol & packed = m_symbols[index];
+    GUARD(packed.isDeferred());
+
+    // Resolved either way, a failure isn't worth another attempt
+    uint32_t const implements = packed.flags & PackedSymbol::Implements;
+    packed.flags = (PackedSymbol::packFlags(symbol) & ~uint32_t(PackedSymbol::Implements | PackedSymbol::Deferred |
+        PackedSymbol::HasDemangled)) | implements;
+    if (!symbol.demangledName)
+    {
+        return true;
+    }
+
+    StringPool::Ref demangled;
+    if (!m_strings.intern(*symbol.demangledName, demangled))
+    {
+        return false;
+    }
+    packed.demangledOffset = demangled.offset;
+    packed.demangledLength = demangled.length;
+    packed.flags |= PackedSymbol::HasDemangled;
+    return true;
+}
+
+Symbol SymbolStore::unpack(PackedSymbol const & packed) const
+{
+    Symbol symbol{ .raw = { .name = std::string{ rawName(packed) } } };
+    PackedSymbol::unpackFlags(packed.flags, symbol);
+    if (auto demangled = demangledName(packed); demangled)
+    {
+        symbol.demangledName.emplace(*demangled);
+    }
+    return symbol;
+}
+
+size_t SymbolStore::memoryUsage() const noexcept
+{
+    return m_symbols.capacity() * sizeof(PackedSymbol) + m_strings.size();
+}
+
+void SymbolStore::reserve(size_t symbolsCount, size_t stringBytes)
+{
+    m_symbols.reserve(symbolsCount);
+    m_strings.reserve(stringBytes, symbolsCount);
+}
+
+void SymbolStore::clear() noexcept
+{
+    m_symbols.clear();
+    m_images.clear();
+    m_strings.clear();
+}
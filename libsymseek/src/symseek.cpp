@@ -2,43 +2,209 @@ module;
 
 #include <symseek/Definitions.h>
 
+module symseek;
+
+import <algorithm>;
+import <memory>;
+import <span>;
+
+import symseek.internal.imageformat;
+
+import :demanglers.gcc;
+import :demanglers.msvc;
+import :parsers.coff;
+import :parsers.lib;
+import :parsers.macho;
+import :parsers.pe;
+import :parsers.universal;
+
 #if SYMSEEK_OS_LIN()
-#   include "ImageParsers/linux/ELFNativeParser.h"
+    import :parsers.elf;
 #endif
 
-module symseek;
+using namespace SymSeek;
+
+namespace
+{
+    // The demangled names are classified by their ECMAScript patterns quoted below,
+    // matched by hand in a single pass as std::regex dominated the scan time.
+    // The character classes follow the regex ones in the "C" locale.
+    bool isLineTerminator(char c) noexcept
+    {
+        return c == '\n' || c == '\r';
+    }
+
+    bool isSpace(char c) noexcept
+    {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
 
-import <regex>;
+    bool isWordChar(char c) noexcept
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
 
-#if SYMSEEK_OS_WIN()
-    import :parsers.coff;
-    import :parsers.lib;
-    import :parsers.pe;
+    // Every character matches "."
+    bool isLine(std::string_view text) noexcept
+    {
+        return std::none_of(text.begin(), text.end(), isLineTerminator);
+    }
 
-    import :demanglers.gcc;
-    import :demanglers.msvc;
-#endif
+    // "^(prefix).+"
+    bool startsLine(std::string_view name, std::string_view prefix) noexcept
+    {
+        return name.size() > prefix.size() && name.starts_with(prefix) && isLine(name.substr(prefix.size()));
+    }
+
+    // "(&|&&)?$", false for the names ending with more ampersands
+    bool removeRefQualifier(std::string_view & name) noexcept
+    {
+        size_t ampersands = 0;
+        while (ampersands < name.size() && name[name.size() - 1 - ampersands] == '&')
+        {
+            ++ampersands;
+        }
+        name.remove_suffix(std::min<size_t>(ampersands, 2));
+        return ampersands <= 2;
+    }
+
+    // "\s*$"
+    void removeTrailingSpaces(std::string_view & name) noexcept
+    {
+        while (!name.empty() && isSpace(name.back()))
+        {
+            name.remove_suffix(1);
+        }
+    }
+
+    // "const\s*$"
+    bool removeTrailingConst(std::string_view & name) noexcept
+    {
+        removeTrailingSpaces(name);
+        if (!name.ends_with("const"))
+        {
+            return false;
+        }
+        name.remove_suffix(std::string_view{ "const" }.size());
+        return true;
+    }
+
+    // "^.+\W+\s*const\s*(&|&&)?$"
+    bool endsWithConst(std::string_view name) noexcept
+    {
+        if (!removeRefQualifier(name) || !removeTrailingConst(name))
+        {
+            return false;
+        }
+
+        // "\s" is a part of "\W", so the rest is a line followed by a run of non-word characters
+        if (name.size() < 2 || isWordChar(name.back()))
+        {
+            return false;
+        }
+        size_t lineEnd = name.size() - 1;
+        while (lineEnd > 1 && !isWordChar(name[lineEnd - 1]))
+        {
+            --lineEnd;
+        }
+        return isLine(name.substr(0, lineEnd));
+    }
+
+    // "^(.+)\((.*)\)(\s*const\s*)?(&|&&)?$"
+    bool isSignature(std::string_view name) noexcept
+    {
+        if (!removeRefQualifier(name))
+        {
+            return false;
+        }
+        if (!name.ends_with(')'))
+        {
+            if (!removeTrailingConst(name))
+            {
+                return false;
+            }
+            removeTrailingSpaces(name);
+            if (!name.ends_with(')'))
+            {
+                return false;
+            }
+        }
+        name.remove_suffix(1);
+        return name.find('(', 1) != std::string_view::npos && isLine(name);
+    }
+
+    struct AccessKeyword
+    {
+        std::string_view keyword;
+        Access access;
+    };
+
+    constexpr AccessKeyword accessKeywords[] = {
+        { "public:", Access::Public },
+        { "protected:", Access::Protected },
+        { "private:", Access::Private },
+    };
+
+    struct ModifierKeyword
+    {
+        std::string_view keyword;
+        uint8_t modifier;
+    };
+
+    constexpr ModifierKeyword modifierKeywords[] = {
+        { "virtual", Symbol::IsVirtual },
+        { "static", Symbol::IsStatic },
+    };
+}
 
 namespace SymSeek
 {
     ISymbolReader::UPtr createReader(String const & imagePath)
     {
-        static IImageParser::UPtr const parsers[] = {
-#if SYMSEEK_OS_WIN()
-            std::make_unique<LIBNativeParser>(),
-            std::make_unique<PENativeParser>(),
-            std::make_unique<COFFNativeParser>(),
-#elif SYMSEEK_OS_LIN()
-            std::make_unique<ELFNativeParser>(),
+        // A single read tells the format, the parser goes on with the same file
+        detail::Image image = detail::openImage(imagePath);
+        switch (image.format)
+        {
+            case detail::ImageFormat::Archive:
+                return LIBNativeParser{}.reader(std::move(image.file));
+            case detail::ImageFormat::PE:
+                return PENativeParser{}.reader(std::move(image.file));
+            case detail::ImageFormat::COFF:
+                return COFFNativeParser{}.reader(std::move(image.file));
+#if SYMSEEK_OS_LIN()
+            case detail::ImageFormat::ELF:
+                return ELFNativeParser{}.reader(std::move(image.file));
 #endif
-        };
+            case detail::ImageFormat::MachO:
+                return MachONativeParser{}.reader(std::move(image.file));
+            case detail::ImageFormat::Universal:
+                return UniversalNativeParser{}.reader(std::move(image.file));
+            default:
+                break;
+        }
+        return {};
+    }
 
-        for (auto const & parser: parsers)
+    ISymbolReader::UPtr createReader(std::span<uint8_t const> imageBytes)
+    {
+        switch (detail::detectImageFormat(imageBytes))
         {
-            if (auto reader = parser->reader(imagePath))
-            {
-                return reader;
-            }
+            case detail::ImageFormat::Archive:
+                return LIBNativeParser{}.reader(imageBytes);
+            case detail::ImageFormat::PE:
+                return PENativeParser{}.reader(imageBytes);
+            case detail::ImageFormat::COFF:
+                return COFFNativeParser{}.reader(imageBytes);
+#if SYMSEEK_OS_LIN()
+            case detail::ImageFormat::ELF:
+                return ELFNativeParser{}.reader(imageBytes);
+#endif
+            case detail::ImageFormat::MachO:
+                return MachONativeParser{}.reader(imageBytes);
+            case detail::ImageFormat::Universal:
+                return UniversalNativeParser{}.reader(imageBytes);
+            default:
+                break;
         }
         return {};
     }
@@ -51,70 +217,67 @@ namespace SymSeek
                 return std::make_unique<MSVCDemangler>();
             case Mangler::GCC:
                 return std::make_unique<GCCDemangler>();
+            // Recognized by DemangleDispatcher, but not demangled yet
+            case Mangler::Rust:
+            case Mangler::Swift:
+            case Mangler::D:
+            case Mangler::None:
+                break;
         }
         return {};
     }
 
+    bool demangle(std::string_view rawName, std::string & output)
+    {
+        static DemangleDispatcher const dispatcher;
+        return dispatcher.demangleInto(rawName, output);
+    }
+
     Symbol createSymbol(RawSymbol rawSymbol, std::string demangledName)
     {
-        std::string name = demangledName;
+        std::string_view name = demangledName;
         Symbol result;
         result.raw = std::move(rawSymbol);
-        
-        static std::regex const constRx{
-            R"(^.+\W+\s*const\s*(&|&&)?$)", std::regex::optimize};
-        if (std::smatch match; std::regex_match(name, match, constRx))
+
+        if (endsWithConst(name))
         {
             result.modifiers |= Symbol::IsConst;
             result.type = NameType::Method;
         }
 
-        static std::regex const accessModifierRx{
-            R"(^(public|protected|private):.+)", std::regex::optimize};
-        if (std::smatch match; std::regex_match(name, match, accessModifierRx))
+        for (auto const & [keyword, access]: accessKeywords)
         {
-            result.type = NameType::Method;
-            result.access = Access::Public;
-            std::string const & accessStr = match[1];
-
-            if (accessStr == "protected")
+            if (startsLine(name, keyword))
             {
-                result.access = Access::Protected;
+                result.type = NameType::Method;
+                result.access = access;
+                name.remove_prefix(keyword.size() + 1 /*space*/);
+                break;
             }
-            else if (accessStr == "private")
-            {
-                result.access = Access::Private;
-            }
-
-            name.erase(0, accessStr.length() + 2 /*colon and space*/);
         }
 
-        static std::regex const modifierRx{
-            R"(^(virtual|static).+)", std::regex::optimize};
-        if (std::smatch match; std::regex_match(name, match, modifierRx))
+        for (auto const & [keyword, modifier]: modifierKeywords)
         {
-            std::string const & modifier = match[1];
-            if (modifier == "static")
+            if (startsLine(name, keyword))
             {
-                result.modifiers |= Symbol::IsStatic;
+                result.modifiers |= modifier;
+                name.remove_prefix(keyword.size() + 1 /*space*/);
+                break;
             }
-            else
-            {
-                result.modifiers |= Symbol::IsVirtual;
-            }
-
-            name.erase(0, modifier.length() + 1/*space*/);
         }
 
-        static std::regex const signatureRx{
-             R"(^(.+)\((.*)\)(\s*const\s*)?(&|&&)?$)", std::regex::optimize};
-        if (std::smatch match; !std::regex_match(name, match, signatureRx))
+        if (!isSignature(name))
         {
             result.type = NameType::Variable;
-            if (name.find("const ") != String::npos)
+            if (name.find("const ") != std::string_view::npos)
             {
                 result.modifiers |= Symbol::IsConst;
             }
+            // No regex told it, it's found the way const is
+            if (name.find("volatile ") != std::string_view::npos)
+            {
+                result.modifiers |= Symbol::IsVolatile;
+            }
         }
 
         result.demangledName = std::move(demangledName);